@@ -0,0 +1,109 @@
+#ifndef KEYWORDS_H_INCLUDED
+#define KEYWORDS_H_INCLUDED
+
+/**
+ * @file Keywords.h
+ * @brief Defines the Nhyk keyword set and its compile-time perfect hash.
+ *
+ * Every keyword maps to its own slot of a 64-entry table through a hash of its length,
+ * its first two characters and its last character, so recognising a keyword costs one
+ * hash and at most one string compare. The table is built at compile time and checked
+ * to be collision free by a static_assert; adding a keyword that collides fails the
+ * build until the hash constants are re-tuned.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Kind of keyword carried by a KEYWORD token. The KW_ prefix keeps clear of
+// platform macros such as TRUE, FALSE and IN.
+enum class KeywordKind : uint8_t {
+    NONE,
+    KW_PROG, KW_FUNC, KW_BEGIN, KW_VAR, KW_INTEGER, KW_DOUBLE,
+    KW_STRING, KW_RETURN, KW_END, KW_INPUT, KW_OUTPUT, KW_FOR,
+    KW_TO, KW_NOT, KW_WHILE, KW_BOOL, KW_TRUE, KW_FALSE, KW_IS, KW_IN,
+    KW_IF, KW_ELIF, KW_ELSE, KW_THEN, KW_CASE, KW_VALIDATE,
+    KW_MATCH, KW_CHECK, KW_ENUM, KW_AND
+};
+
+namespace nhyk_keywords {
+
+struct Entry {
+    std::string_view text;
+    KeywordKind kind;
+};
+
+// Listed in KeywordKind order, so keywords[k - 1] describes kind k.
+constexpr std::array<Entry, 30> keywords = {{
+    {"PROG", KeywordKind::KW_PROG}, {"FUNC", KeywordKind::KW_FUNC},
+    {"BEGIN", KeywordKind::KW_BEGIN}, {"VAR", KeywordKind::KW_VAR},
+    {"INTEGER", KeywordKind::KW_INTEGER}, {"DOUBLE", KeywordKind::KW_DOUBLE},
+    {"STRING", KeywordKind::KW_STRING}, {"RETURN", KeywordKind::KW_RETURN},
+    {"END", KeywordKind::KW_END}, {"INPUT", KeywordKind::KW_INPUT},
+    {"OUTPUT", KeywordKind::KW_OUTPUT}, {"FOR", KeywordKind::KW_FOR},
+    {"TO", KeywordKind::KW_TO}, {"NOT", KeywordKind::KW_NOT},
+    {"WHILE", KeywordKind::KW_WHILE}, {"BOOL", KeywordKind::KW_BOOL},
+    {"TRUE", KeywordKind::KW_TRUE}, {"FALSE", KeywordKind::KW_FALSE},
+    {"IS", KeywordKind::KW_IS}, {"IN", KeywordKind::KW_IN},
+    {"IF", KeywordKind::KW_IF}, {"ELIF", KeywordKind::KW_ELIF},
+    {"ELSE", KeywordKind::KW_ELSE}, {"THEN", KeywordKind::KW_THEN},
+    {"CASE", KeywordKind::KW_CASE}, {"VALIDATE", KeywordKind::KW_VALIDATE},
+    {"MATCH", KeywordKind::KW_MATCH}, {"CHECK", KeywordKind::KW_CHECK},
+    {"ENUM", KeywordKind::KW_ENUM}, {"AND", KeywordKind::KW_AND}
+}};
+
+constexpr size_t MIN_LENGTH = 2;
+constexpr size_t MAX_LENGTH = 8;
+constexpr size_t TABLE_SIZE = 64;
+
+// Requires text.size() >= MIN_LENGTH.
+constexpr size_t hash(std::string_view text) {
+    return (text.size()
+            + 5 * static_cast<unsigned char>(text[0])
+            + 14 * static_cast<unsigned char>(text[1])
+            + 15 * static_cast<unsigned char>(text[text.size() - 1])) & (TABLE_SIZE - 1);
+}
+
+constexpr std::array<KeywordKind, TABLE_SIZE> buildTable() {
+    std::array<KeywordKind, TABLE_SIZE> slots{};
+    for (const Entry& entry : keywords) slots[hash(entry.text)] = entry.kind;
+    return slots;
+}
+
+constexpr std::array<KeywordKind, TABLE_SIZE> table = buildTable();
+
+// Every keyword must own its slot; a collision would overwrite an earlier entry.
+constexpr bool isPerfect() {
+    for (size_t i = 0; i < keywords.size(); ++i) {
+        if (static_cast<size_t>(keywords[i].kind) != i + 1) return false;
+        if (table[hash(keywords[i].text)] != keywords[i].kind) return false;
+    }
+    return true;
+}
+static_assert(isPerfect(), "keyword hash has a collision: re-tune the constants in nhyk_keywords::hash");
+
+} // namespace nhyk_keywords
+
+// Keyword kind of 'text', or KeywordKind::NONE if it is not a keyword.
+constexpr KeywordKind lookupKeyword(std::string_view text) {
+    if (text.size() < nhyk_keywords::MIN_LENGTH || text.size() > nhyk_keywords::MAX_LENGTH)
+        return KeywordKind::NONE;
+    KeywordKind kind = nhyk_keywords::table[nhyk_keywords::hash(text)];
+    if (kind == KeywordKind::NONE) return KeywordKind::NONE;
+    return nhyk_keywords::keywords[static_cast<size_t>(kind) - 1].text == text ? kind : KeywordKind::NONE;
+}
+
+// Spelling of a keyword kind ("" for NONE).
+constexpr std::string_view keywordText(KeywordKind kind) {
+    return kind == KeywordKind::NONE ? std::string_view()
+                                     : nhyk_keywords::keywords[static_cast<size_t>(kind) - 1].text;
+}
+
+#endif // KEYWORDS_H_INCLUDED
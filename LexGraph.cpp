@@ -1,437 +1,636 @@
-#include "LexGraph.h"
-#include <algorithm>  // for std::find
-/**
- * @file LexGraph.cpp
- * @brief Implementation of the LexGraph class for lexical analysis in the Nhyk compiler.
- *
- * This source file contains the implementation of the LexGraph class, which represents a
- * lexical graph used for tokenization and parsing in the Nhyk compiler.
- *
- * @author MNS Ahimbisibwe
- * @SN 217005435
- * @date 2023/09/03
- * @model Lexical Analysis Design
- * @version D01
- */
-
-
-// --- LexGraph Implementation ---
-
-LexGraph::LexGraph() : source(""), position(0), start(nullptr) {}
-
-LexGraph::~LexGraph() {}
-
-
-/**
- * Overloaded output stream insertion operator for writing LexGraph object to an output stream.
- *
- * This operator formats and writes the token information from
- * a LexGraph object to the specified output stream.
- * It iterates through the tokens, converts their types
- * to strings, and concatenates the information for output.
- *
- * @param osout The output stream where the data will be written.
- * @param graph The LexGraph object containing token information to be written.
- * @return A reference to the output stream after writing the data.
- */
-
- /*
-std::ostream& operator<<(std::ostream& osout, const LexGraph& graph){
-    std::string str_tokens;
-    for(const auto& token : graph.tokens){
-        std::string str_type;
-        switch(token.getType()){
-        case TokenType::IDENTIFIER:
-            str_type = "ID";
-            break;
-        case TokenType::PUNCTUATION:
-            str_type = "PUNCTUATION";
-            break;
-        case TokenType::KEYWORD:
-            str_type = "KEYWORD";
-            break;
-        case TokenType::OPERATOR:
-            str_type = "OPERATOR";
-            break;
-        case TokenType::INT_LITERAL:
-            str_type = "INT_LITERAL";
-            break;
-        case TokenType::DOUBLE_LITERAL:
-            str_type = "DOUBLE_LITERAL";
-            break;
-        case TokenType::BOOLEAN_LITERAL:
-            str_type = "BOOLEAN_LITERAL";
-            break;
-        case TokenType::LITERAL:
-            str_type = "LITERAL";
-            break;
-        // ... add other token as needed
-        default:
-            str_type = "UNKNOWN";
-        }str_tokens += " " + str_type + "(" + token.getLexeme() + ")";
-    }osout << str_tokens; return osout; // Write the formatted info to the output stream
-}
-*/
-
-void LexGraph::traverse(NhykLexicalNode* trNode) {
-    // This method implementation is adapted from Prof DA Coulter's example.
-    // Source URL: https://eve.uj.ac.za/lectures.php#lecture-it08x87
-
-    // Display the current node being visited along with the current position and source.
-    std::cout << "Visiting--> " << trNode->name << " Position--> "
-              << position << " Source--> " << source << std::endl;
-
-    // FSM traversal logic begins here:
-
-    // If the source is empty, we've reached the end of the input.
-    if(source.length() == 0){
-        std::cout << "Ending Traversal --> End of Input" << std::endl;
-
-        // Classify the node to determine the token type.
-        classify(trNode);
-        return;
-    }
-
-    // Check if there's a transition for the current character in the source.
-    if(trNode->transitions.find(source[position]) != trNode->transitions.end()){
-        std::cout << "Transition Found For-> " << source[position]
-                  << " @ " << trNode->name << std::endl;
-
-        // Move to the next node based on the transition.
-        NhykLexicalNode* next = trNode->transitions[source[position]];
-
-        // Increment the position as we move forward in the source.
-        position++;
-
-        // Recursively traverse to the next node.
-        traverse(next);
-    }else{
-        // If no transition is found for the current character, classify the current node.
-        std::cout << "No Transition For-> " << source[position] << std::endl;
-        classify(trNode);
-    }
-}
-
-std::string LexGraph::getSource() const {return source;}
-void LexGraph::setSource(const std::string& newSource){source = newSource;}
-std::vector<Token>& LexGraph::getTokens() {return tokens;}
-void LexGraph::clearTokens() {tokens.clear();}
-
-// --- LexGraphStringLiteral Implementation ---
-LexGraphStringLiteral::LexGraphStringLiteral(): s1(), s2(), s3(){
-    start = &s1;
-
-    s1.name = "s1";
-    s1.terminal = false;
-    s1.transitions['"'] = &s2;
-
-    s2.name = "s2";
-    s2.terminal = false;  // not a terminal state since we haven't reached the end quote yet
-    s2.transitions['"'] = &s3;  // transition to s3 when we find the end quote
-    for (int i = 32; i < 127; ++i) {  // for almost all printable characters
-        if (i != '"')     // excluding the quote itself
-            s2.transitions[i] = &s2;  // remain in s2
-    }s3.name = "s3";
-    s3.terminal = true;   // this is a terminal state for the string literal
-}
-
-void LexGraphStringLiteral::classify(NhykLexicalNode* node) {
-    Token token;
-    if (node == &s3) {
-        token = Token(TokenType::LITERAL, source.substr(0, position));
-    } else {
-        token = Token(TokenType::UNKNOWN, source.substr(0, 1));
-    }
-    tokens.push_back(token);
-    source = source.substr(position);
-    position = 0;
-    clearTokens();
-}
-
-// --- LexGraphID Implementation ---
-
-LexGraphID::LexGraphID() : s1(), s2(), s_error() {
-    start = &s1;
-
-    s1.name = "s1";
-    s1.terminal = false;
-    // ... [transitions for identifier recognition]
-    for (char chC = 'a'; chC <= 'z'; chC++) s1.transitions[chC] = &s2;
-    for (char chC = 'A'; chC <= 'Z'; chC++) s1.transitions[chC] = &s2;
-
-    s2.name = "s2";
-    s2.terminal = true;
-    // ... [transitions for identifier recognition]
-    for (char chC = 'a'; chC <= 'z'; chC++) s2.transitions[chC] = &s2;
-    for (char chC = 'A'; chC <= 'Z'; chC++) s2.transitions[chC] = &s2;
-    for (char chC = '0'; chC <= '9'; chC++) s2.transitions[chC] = &s2;
-    s2.transitions['_'] = &s2;
-}
-
-/**
- * @brief Classifies transitions found in the lexical graph node.
- *
- * The `classify` method processes transitions found in the given lexical graph node
- * to classify and tokenize identifiers and keywords. It identifies whether the token
- * represents a keyword or an identifier and creates a corresponding `Token` object.
- * The detected token is added to the `tokens` list for further processing.
- *
- * @details This method examines transitions within the lexical graph node and determines
- * whether the lexeme is a keyword or an identifier. Keywords are compared against a predefined
- * list of language keywords. If the lexeme is a keyword, it is classified as a `KEYWORD` token;
- * otherwise, it is classified as an `IDENTIFIER` token. In the case of an unrecognized token,
- * an `UNKNOWN` token is created.
- *
- * @param node A pointer to the lexical graph node to be classified.
- *
- * @see Token
- * @see TokenType
- * @see clearTokens
- *
- * @return void
- */
-void LexGraphID::classify(NhykLexicalNode* node) {
-    std::cout << "Classifying Transitions Found <=> ";
-    Token token;
-    // ... [token classification logic]
-    if(node->terminal){
-        static const std::vector<std::string> keywords = {
-            "PROG", "FUNC", "BEGIN", "VAR", "INTEGER", "DOUBLE",
-            "STRING", "RETURN", "END", "INPUT", "OUTPUT", "FOR",
-            "TO", "NOT", "WHILE", "BOOL", "TRUE", "FALSE", "IS", "IN",
-            "IF", "ELIF", "ELSE", "THEN", "CASE", "VALIDATE",
-            "MATCH", "CHECK", "ENUM", "AND"
-        };
-        std::string lexeme = source.substr(0, position);
-        if (std::find(keywords.begin(), keywords.end(), lexeme) != keywords.end()) {
-            std::cout << "KEYWORD ";
-            token = Token(TokenType::KEYWORD, lexeme);
-        }else{
-            std::cout << "ID ";
-            token = Token(TokenType::IDENTIFIER, lexeme);
-        }
-    }else{
-        token = Token(TokenType::UNKNOWN, source.substr(0, 1));
-    }std::cout << "Lexeme: " << token.getLexeme() << std::endl;
-    tokens.push_back(token);
-    source = source.substr(position);// Update the source to remove the tokenized part
-    position = 0; // Reset the position
-    clearTokens(); // Clear the tokens list
-}
-
-LexGraphOperator::LexGraphOperator() : s1(), s2(){
-    start = &s1;
-
-    s1.name = "s1";
-    s1.terminal = false;
-    s1.transitions['+'] = &s2;
-    s1.transitions['-'] = &s2;
-    s1.transitions['*'] = &s2;
-    s1.transitions['/'] = &s2;
-    s1.transitions['='] = &s2;
-
-    s2.name = "s2";
-    s2.terminal = true;
-}
-
-void LexGraphOperator::classify(NhykLexicalNode* node){
-    std::cout << "Classifying Transitions Found <=> ";
-    Token token;
-    if (node->terminal) {
-        std::cout << "OPERATOR ";
-        token = Token(TokenType::OPERATOR, source.substr(0, position));
-    }else{
-        token = Token(TokenType::UNKNOWN, source.substr(0, 1));
-    }std::cout << "Lexema: " << token.getLexeme() << std::endl;
-    tokens.push_back(token);
-    source = source.substr(position);// Update the source to remove the tokenized part
-    position = 0; // Reset the position
-    clearTokens(); // Clear the tokens list
-}
-
-// --- LexGraphLiteral Implementation ---
-
-LexGraphLiteral::LexGraphLiteral() : s1(), s2(), s3(), s_error() {
-    // Initial state
-    start = &s1;
-
-    s1.name = "s1";
-    s1.terminal = false;
-    for(char c = '0'; c <= '9'; c++) s1.transitions[c] = &s2;
-
-    s2.name = "s2";
-    s2.terminal = true;
-    for(char c = '0'; c <= '9'; c++) s2.transitions[c] = &s2;
-    s2.transitions['.'] = &s3;
-
-    s3.name = "s3";
-    s3.terminal = true;
-    for(char c = '0'; c <= '9'; c++) s3.transitions[c] = &s3;
-
-    // Error state
-    s_error.name = "s_error";
-    // This is a terminal state that will capture invalid numbers.
-    s_error.terminal = true;
-
-    for(char c = 'a'; c <= 'z'; c++) {
-        s_error.transitions[c] = &s_error;
-        s2.transitions[c] = &s_error;
-        s3.transitions[c] = &s_error;
-    }
-
-    for(char c = 'A'; c <= 'Z'; c++) {
-        s_error.transitions[c] = &s_error;
-        s2.transitions[c] = &s_error;
-        s3.transitions[c] = &s_error;
-    }
-}
-
-
-void LexGraphLiteral::classify(NhykLexicalNode* node) {
-    std::cout << "Classifying Transitions Found <=> ";
-    Token token;
-    std::string lexeme = source.substr(0, position);
-    if(node == &s2) {
-        if(lexeme.find('.') == std::string::npos) {
-            std::cout << "INTEGER LITERAL ";
-            token = Token(TokenType::INT_LITERAL, lexeme);
-        } else {
-            std::cout << "DOUBLE LITERAL ";
-            token = Token(TokenType::DOUBLE_LITERAL, lexeme);
-        }
-    } else if(node == &s3) {
-        std::cout << "DOUBLE LITERAL ";
-        token = Token(TokenType::DOUBLE_LITERAL, lexeme);
-    } else if(node == &s_error) {
-        std::cout << "UNKNOWN ";
-        token = Token(TokenType::UNKNOWN, lexeme);
-    }else {
-        token = Token(TokenType::UNKNOWN, source.substr(0, 1));
-    }
-    std::cout << "Lexeme: " << token.getLexeme() << std::endl;
-    tokens.push_back(token);
-    source = source.substr(position);// Update the source to remove the tokenized part
-    position = 0; // Reset the position
-    clearTokens(); // Clear the tokens list
-}
-
-LexGraphPunctuation::LexGraphPunctuation() : s1() {
-    //FSM responsible for recognizing operators and punctualtions
-    start = &s1;
-
-    s1.name = "s1";
-    s1.terminal = true;
-    s1.transitions[':'] = &s1;
-    s1.transitions[';'] = &s1;
-    s1.transitions[','] = &s1;
-    s1.transitions['.'] = &s1;
-    s1.transitions['('] = &s1;
-    s1.transitions[')'] = &s1;
-    s1.transitions['{'] = &s1;
-    s1.transitions['}'] = &s1;
-}
-
-void LexGraphPunctuation::classify(NhykLexicalNode* node) {
-    std::cout << "Classifying Transitions Found <=> ";
-    Token token;
-    std::string lexeme = source.substr(0, position);
-    if(node->terminal) {
-        std::cout << "PUNCTUATION ";
-        token = Token(TokenType::PUNCTUATION, lexeme);
-    } else {
-        token = Token(TokenType::UNKNOWN, source.substr(0, 1));
-    }
-    std::cout << "Lexeme: " << token.getLexeme() << std::endl;
-    tokens.push_back(token);
-    source = source.substr(position);// Update the source to remove the tokenized part
-    position = 0; // Reset the position
-    clearTokens(); // Clear the tokens list
-}
-
-NhykLexer::NhykLexer(const std::string& src) : source(src), position(0) {}
-
-// --- where token processing happens:
-/**
- * @brief Tokenizes the input source code and populates the `tokens` vector.
- *
- * The `tokenize` method processes the input source code character by character,
- * identifying and tokenizing different types of tokens such as identifiers, literals,
- * operators, punctuation, and string literals. It utilizes various lexical state machines
- * to recognize and classify these tokens. When a valid token is identified, it is added
- * to the `tokens` vector. If an unknown token is encountered, an error message is
- * displayed to the standard error stream.
- *
- * @details This method iterates through the source code, character by character, and uses
- * lexical state machines (FSMs) to classify and tokenize the input. It handles whitespace,
- * identifiers, literals, operators, punctuation, and string literals. Detected tokens are
- * added to the `tokens` vector.
- *
- * @see NhykLexicalNode
- * @see LexGraph
- * @see LexGraphID
- * @see LexGraphStringLiteral
- * @see LexGraphOperator
- * @see LexGraphLiteral
- * @see LexGraphPunctuation
- *
- * @return void
- */
-void NhykLexer::tokenize() {
-    while (position < source.size()) {
-        char currentChar = source[position];
-        // Check if the current character is a whitespace character
-        if (std::isspace(currentChar)) {
-            position++;  // skip whitespace characters
-            continue;  // continue to the next iteration of the loop
-        }else if (std::isalpha(currentChar)) {
-            idFSM.setSource(getSource().substr(position));
-            idFSM.publicTraverse(idFSM.getStartNode());  // start the traversal from the starting state
-            tokens.push_back(idFSM.getTokens()[0]);
-            position += idFSM.getTokens()[0].getLexeme().length();
-            // Clear the FSM's source to avoid any potential side effects in the next iterations
-            idFSM.setSource("");
-        } else if (std::isdigit(currentChar)) {
-            literalFSM.setSource(source.substr(position));
-            literalFSM.publicTraverse(literalFSM.getStartNode());
-            tokens.push_back(literalFSM.getTokens()[0]);
-            position += literalFSM.getTokens()[0].getLexeme().length();
-            // Clear the FSM's source to avoid any potential side effects in the next iterations
-            literalFSM.setSource("");
-        } else if (currentChar == '+' || currentChar == '-' ||
-                   currentChar == '*' || currentChar == '/' || currentChar == '='){
-            operatorFSM.setSource(source.substr(position));
-            operatorFSM.publicTraverse(operatorFSM.getStartNode());
-            tokens.push_back(operatorFSM.getTokens()[0]);
-            position += operatorFSM.getTokens()[0].getLexeme().length();
-            // Clear the FSM's source to avoid any potential side effects in the next iterations
-            operatorFSM.setSource("");
-        } else if (currentChar == ':' || currentChar == ';' || currentChar == ',' ||
-                   currentChar == '.' || currentChar == '(' || currentChar == ')' ||
-                   currentChar == '{' || currentChar == '}') {
-            punctuationFSM.setSource(source.substr(position));
-            punctuationFSM.publicTraverse(punctuationFSM.getStartNode());
-            tokens.push_back(punctuationFSM.getTokens()[0]);
-            position += punctuationFSM.getTokens()[0].getLexeme().length();
-            // Clear the FSM's source to avoid any potential side effects in the next iterations
-            punctuationFSM.setSource("");
-        } else if (currentChar == '"') {
-            stringLiteralFSM.setSource(source.substr(position));
-            stringLiteralFSM.publicTraverse(stringLiteralFSM.getStartNode());
-            tokens.push_back(stringLiteralFSM.getTokens()[0]);
-            position += stringLiteralFSM.getTokens()[0].getLexeme().length();
-            // Clear the FSM's source to avoid any potential side effects in the next iterations
-            stringLiteralFSM.setSource("");
-        } else if (std::isspace(currentChar)) {
-            position++;  // skip spaces
-        } else {
-            // Error handling for unknown tokens
-            std::cerr << "Error at position " << position << ": Unknown token \""
-                      << currentChar << "\"." << std::endl;
-            position++;
-        }
-    }
-}
-
-std::string NhykLexer::getSource() const {return source;}
-void NhykLexer::setSource(const std::string& newSource){source = newSource;}
-const std::vector<Token>& NhykLexer::getTokens() const {return tokens;}
+#include "LexGraph.h"
+#include "NhykSource.h"
+#include "NhykSpec.h"
+#include "NhykNumbers.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+/**
+ * @file LexGraph.cpp
+ * @brief Implementation of the LexGraph class for lexical analysis in the Nhyk compiler.
+ *
+ * This source file contains the implementation of the LexGraph class, which represents a
+ * lexical graph used for tokenization and parsing in the Nhyk compiler.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+
+// --- LexGraph Implementation ---
+
+LexGraph::LexGraph() : source(), begin(0), position(0), start(nullptr), trace(nullptr), hitEnd(false), symbols(nullptr) {}
+
+LexGraph::~LexGraph() {}
+
+
+/**
+ * Overloaded output stream insertion operator for writing LexGraph object to an output stream.
+ *
+ * This operator formats and writes the token information from
+ * a LexGraph object to the specified output stream.
+ * It iterates through the tokens, converts their types
+ * to strings, and concatenates the information for output.
+ *
+ * @param osout The output stream where the data will be written.
+ * @param graph The LexGraph object containing token information to be written.
+ * @return A reference to the output stream after writing the data.
+ */
+
+ /*
+std::ostream& operator<<(std::ostream& osout, const LexGraph& graph){
+    std::string str_tokens;
+    for(const auto& token : graph.tokens){
+        std::string str_type;
+        switch(token.getType()){
+        case TokenType::IDENTIFIER:
+            str_type = "ID";
+            break;
+        case TokenType::PUNCTUATION:
+            str_type = "PUNCTUATION";
+            break;
+        case TokenType::KEYWORD:
+            str_type = "KEYWORD";
+            break;
+        case TokenType::OPERATOR:
+            str_type = "OPERATOR";
+            break;
+        case TokenType::INT_LITERAL:
+            str_type = "INT_LITERAL";
+            break;
+        case TokenType::DOUBLE_LITERAL:
+            str_type = "DOUBLE_LITERAL";
+            break;
+        case TokenType::BOOLEAN_LITERAL:
+            str_type = "BOOLEAN_LITERAL";
+            break;
+        case TokenType::LITERAL:
+            str_type = "LITERAL";
+            break;
+        // ... add other token as needed
+        default:
+            str_type = "UNKNOWN";
+        }str_tokens += " " + str_type + "(" + token.getLexeme() + ")";
+    }osout << str_tokens; return osout; // Write the formatted info to the output stream
+}
+*/
+
+void LexGraph::compile() {
+    table.build(start);
+}
+
+/**
+ * @brief Walks the compiled table from 'trNode' and classifies where the walk ends.
+ *
+ * @details A single loop drives the FSM: one table load per input byte, no recursion,
+ * so arbitrarily long identifiers and string literals cannot exhaust the stack. In
+ * states that loop on a whole scanner class (identifier characters, digits, string
+ * bodies) the run is skipped with nhykScan before the next table step. The
+ * loop remembers the last terminal state it passed through and the cursor at that
+ * point; if the walk stops in a non-terminal state after having passed a terminal
+ * one, the cursor backs up to it (maximal munch) before 'classify' is called once.
+ *
+ * @param trNode The node to start from, normally the graph's start node.
+ */
+void LexGraph::traverse(NhykLexicalNode* trNode) {
+    // This method implementation is adapted from Prof DA Coulter's example.
+    // Source URL: https://eve.uj.ac.za/lectures.php#lecture-it08x87
+
+    // The graph is compiled once, on first use, and walked through the table from then on.
+    if (table.empty() || table.getStartNode() != start) compile();
+
+    uint16_t state = table.stateOf(trNode);
+    hitEnd = false;
+    if (state == NhykTransitionTable::NO_STATE) {
+        // A node outside the graph reachable from 'start' has nothing to walk.
+        classify(trNode);
+        return;
+    }
+
+    uint16_t lastAccept = table.isTerminal(state) ? state : NhykTransitionTable::NO_STATE;
+    unsigned int lastAcceptPosition = position;
+    const unsigned int length = static_cast<unsigned int>(source.length());
+
+    while (position < length) {
+        // Skip a run of bytes that would keep us in this state, many bytes at a time.
+        NhykScanKind run = table.scanKind(state);
+        if (run != NhykScanKind::NONE) {
+            position = static_cast<unsigned int>(nhykScan(run, source.data(), position, length));
+            if (table.isTerminal(state)) {
+                lastAccept = state;
+                lastAcceptPosition = position;
+            }
+            if (position >= length) break;
+        }
+
+        // Look up the transition for the current character: one indexed load in the table.
+        unsigned char byte = static_cast<unsigned char>(source[position]);
+        uint16_t next = table.next(state, byte);
+        if (next == NhykTransitionTable::NO_STATE) {
+            NHYK_TRACE_EVENT(trace, NhykTraceKind::NO_TRANSITION, state, position, byte);
+            break;
+        }
+        NHYK_TRACE_EVENT(trace, NhykTraceKind::TRANSITION, state, position, byte);
+        state = next;
+        position++;
+        if (table.isTerminal(state)) {
+            lastAccept = state;
+            lastAcceptPosition = position;
+        }
+    }
+    if (position >= length) {
+        hitEnd = true;
+        NHYK_TRACE_EVENT(trace, NhykTraceKind::END_OF_INPUT, state, position, 0);
+    }
+
+    // Fall back to the longest prefix that ended in a terminal state.
+    if (!table.isTerminal(state) && lastAccept != NhykTransitionTable::NO_STATE) {
+        state = lastAccept;
+        position = lastAcceptPosition;
+    }
+
+    classify(table.node(state));
+    NHYK_TRACE_EVENT(trace, NhykTraceKind::CLASSIFY, state, begin,
+                     static_cast<uint8_t>(tokens.back().getType()));
+}
+
+std::string_view LexGraph::getSource() const {return source;}
+void LexGraph::setSource(std::string_view newSource, unsigned int offset){
+    source = newSource;
+    begin = position = offset;
+}
+std::vector<Token>& LexGraph::getTokens() {return tokens;}
+void LexGraph::clearTokens() {tokens.clear();}
+
+// --- LexGraphStringLiteral Implementation ---
+LexGraphStringLiteral::LexGraphStringLiteral(): s1(), s2(), s3(){
+    start = &s1;
+
+    s1.name = "s1";
+    s1.terminal = false;
+    s1.transitions['"'] = &s2;
+
+    s2.name = "s2";
+    s2.terminal = false;  // not a terminal state since we haven't reached the end quote yet
+    s2.transitions['"'] = &s3;  // transition to s3 when we find the end quote
+    for (int i = 32; i < 127; ++i) {  // for almost all printable characters
+        if (i != '"')     // excluding the quote itself
+            s2.transitions[i] = &s2;  // remain in s2
+    }s3.name = "s3";
+    s3.terminal = true;   // this is a terminal state for the string literal
+}
+
+void LexGraphStringLiteral::classify(NhykLexicalNode* node) {
+    Token token;
+    if (node == &s3) {
+        std::string_view text = lexeme();
+        token = Token(TokenType::LITERAL, text, KeywordKind::NONE,
+                      symbols != nullptr ? symbols->internToken(TokenType::LITERAL, text) : Token::NO_SYMBOL);
+    } else {
+        token = Token(TokenType::UNKNOWN, source.substr(begin, 1));
+    }
+    tokens.push_back(token);
+}
+
+// --- LexGraphID Implementation ---
+
+LexGraphID::LexGraphID() : s1(), s2(), s_error() {
+    start = &s1;
+
+    s1.name = "s1";
+    s1.terminal = false;
+    // ... [transitions for identifier recognition]
+    for (char chC = 'a'; chC <= 'z'; chC++) s1.transitions[chC] = &s2;
+    for (char chC = 'A'; chC <= 'Z'; chC++) s1.transitions[chC] = &s2;
+
+    s2.name = "s2";
+    s2.terminal = true;
+    // ... [transitions for identifier recognition]
+    for (char chC = 'a'; chC <= 'z'; chC++) s2.transitions[chC] = &s2;
+    for (char chC = 'A'; chC <= 'Z'; chC++) s2.transitions[chC] = &s2;
+    for (char chC = '0'; chC <= '9'; chC++) s2.transitions[chC] = &s2;
+    s2.transitions['_'] = &s2;
+}
+
+/**
+ * @brief Classifies transitions found in the lexical graph node.
+ *
+ * The `classify` method processes transitions found in the given lexical graph node
+ * to classify and tokenize identifiers and keywords. It identifies whether the token
+ * represents a keyword or an identifier and creates a corresponding `Token` object.
+ * The detected token is added to the `tokens` list for further processing.
+ *
+ * @details This method examines transitions within the lexical graph node and determines
+ * whether the lexeme is a keyword or an identifier. Keywords are looked up in the perfect hash
+ * from Keywords.h, which costs at most one string compare. If the lexeme is a keyword, it is
+ * classified as a `KEYWORD` token carrying its KeywordKind;
+ * otherwise, it is classified as an `IDENTIFIER` token. In the case of an unrecognized token,
+ * an `UNKNOWN` token is created.
+ *
+ * @param node A pointer to the lexical graph node to be classified.
+ *
+ * @see Token
+ * @see TokenType
+ *
+ * @return void
+ */
+void LexGraphID::classify(NhykLexicalNode* node) {
+    Token token;
+    // ... [token classification logic]
+    if(node->terminal){
+        // The keyword list lives in Keywords.h as a compile-time perfect hash.
+        std::string_view lexeme = this->lexeme();
+        KeywordKind keyword = lookupKeyword(lexeme);
+        if (keyword != KeywordKind::NONE) {
+            token = Token(TokenType::KEYWORD, lexeme, keyword);
+        }else{
+            token = Token(TokenType::IDENTIFIER, lexeme, KeywordKind::NONE,
+                          symbols != nullptr ? symbols->internToken(TokenType::IDENTIFIER, lexeme) : Token::NO_SYMBOL);
+        }
+    }else{
+        token = Token(TokenType::UNKNOWN, source.substr(begin, 1));
+    }
+    tokens.push_back(token);
+}
+
+LexGraphOperator::LexGraphOperator() : s1(), s2(){
+    start = &s1;
+
+    s1.name = "s1";
+    s1.terminal = false;
+    s1.transitions['+'] = &s2;
+    s1.transitions['-'] = &s2;
+    s1.transitions['*'] = &s2;
+    s1.transitions['/'] = &s2;
+    s1.transitions['='] = &s2;
+
+    s2.name = "s2";
+    s2.terminal = true;
+}
+
+void LexGraphOperator::classify(NhykLexicalNode* node){
+    Token token;
+    if (node->terminal) {
+        token = Token(TokenType::OPERATOR, lexeme());
+    }else{
+        token = Token(TokenType::UNKNOWN, source.substr(begin, 1));
+    }
+    tokens.push_back(token);
+}
+
+// --- LexGraphLiteral Implementation ---
+
+LexGraphLiteral::LexGraphLiteral() : s1(), s2(), s3(), s_error() {
+    // Initial state
+    start = &s1;
+
+    s1.name = "s1";
+    s1.terminal = false;
+    for(char c = '0'; c <= '9'; c++) s1.transitions[c] = &s2;
+
+    s2.name = "s2";
+    s2.terminal = true;
+    for(char c = '0'; c <= '9'; c++) s2.transitions[c] = &s2;
+    s2.transitions['.'] = &s3;
+
+    s3.name = "s3";
+    s3.terminal = true;
+    for(char c = '0'; c <= '9'; c++) s3.transitions[c] = &s3;
+
+    // Error state
+    s_error.name = "s_error";
+    // This is a terminal state that will capture invalid numbers.
+    s_error.terminal = true;
+
+    for(char c = 'a'; c <= 'z'; c++) {
+        s_error.transitions[c] = &s_error;
+        s2.transitions[c] = &s_error;
+        s3.transitions[c] = &s_error;
+    }
+
+    for(char c = 'A'; c <= 'Z'; c++) {
+        s_error.transitions[c] = &s_error;
+        s2.transitions[c] = &s_error;
+        s3.transitions[c] = &s_error;
+    }
+}
+
+
+void LexGraphLiteral::classify(NhykLexicalNode* node) {
+    Token token;
+    std::string_view lexeme = this->lexeme();
+    if(node == &s2 && lexeme.find('.') == std::string_view::npos) {
+        int64_t value;
+        nhykParseInt(lexeme, value);
+        token = Token(TokenType::INT_LITERAL, lexeme);
+        token.setInt(value);
+    } else if(node == &s2 || node == &s3) {
+        double value;
+        nhykParseDouble(lexeme, value);
+        token = Token(TokenType::DOUBLE_LITERAL, lexeme);
+        token.setDouble(value);
+    } else if(node == &s_error) {
+        token = Token(TokenType::UNKNOWN, lexeme);
+    }else {
+        token = Token(TokenType::UNKNOWN, source.substr(begin, 1));
+    }
+    tokens.push_back(token);
+}
+
+LexGraphPunctuation::LexGraphPunctuation() : s1() {
+    //FSM responsible for recognizing operators and punctualtions
+    start = &s1;
+
+    s1.name = "s1";
+    s1.terminal = true;
+    s1.transitions[':'] = &s1;
+    s1.transitions[';'] = &s1;
+    s1.transitions[','] = &s1;
+    s1.transitions['.'] = &s1;
+    s1.transitions['('] = &s1;
+    s1.transitions[')'] = &s1;
+    s1.transitions['{'] = &s1;
+    s1.transitions['}'] = &s1;
+}
+
+void LexGraphPunctuation::classify(NhykLexicalNode* node) {
+    Token token;
+    std::string_view lexeme = this->lexeme();
+    if(node->terminal) {
+        token = Token(TokenType::PUNCTUATION, lexeme);
+    } else {
+        token = Token(TokenType::UNKNOWN, source.substr(begin, 1));
+    }
+    tokens.push_back(token);
+}
+
+NhykLexer::NhykLexer(const std::string& src)
+    : position(0), endOfInput(true), stalled(false), resuming(false), partial(), symbols(&ownSymbols), trace(nullptr), reach(0) {
+    setSource(src);
+}
+
+NhykLexer::NhykLexer(const NhykMappedFile& file)
+    : position(0), endOfInput(true), stalled(false), resuming(false), partial(), symbols(&ownSymbols), trace(nullptr), reach(0) {
+    setSourceView(file.view());
+}
+
+/**
+ * @brief Recognizes the next token after the cursor.
+ *
+ * One walk of nhykTokenDfa from its start state handles every token class: there is no
+ * per-class dispatch. The walk remembers the last accepting state it passed and where;
+ * when it stops, the cursor backs up to that point (maximal munch) and the rule accepted
+ * there says what the text is. Whitespace is a skipping rule, so the loop simply goes
+ * round again. States that loop on a whole scanner class skip their run with nhykScan.
+ * This is the single step shared by tokenize() and the pull interface (next/peek).
+ *
+ * @param out Receives the token.
+ * @return False at the end of the source, or if the lexer stalled on a partial buffer.
+ */
+bool NhykLexer::lexNext(Token& out) {
+    const NhykDfa& dfa = nhykTokenDfa;
+    const unsigned int length = static_cast<unsigned int>(source.size());
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(source.data());
+
+    while (position < length && !stalled) {
+        const unsigned int begin = position;
+        unsigned int cursor = position;
+        uint8_t state = NhykDfa::START;
+        int lastRule = -1;
+        unsigned int lastEnd = begin;
+        if (resuming) {
+            // Continue the walk the previous buffer's end cut off.
+            resuming = false;
+            state = partial.state;
+            lastRule = partial.rule;
+            lastEnd = begin + partial.end;
+            cursor = begin + partial.length;
+        }
+
+        while (cursor < length) {
+            // Skip a run of bytes that would keep us in this state, many bytes at a time.
+            NhykScanKind run = dfa.scan[state];
+            if (run != NhykScanKind::NONE) {
+                cursor = static_cast<unsigned int>(nhykScan(run, source.data(), cursor, length));
+                if (dfa.accept[state] >= 0) {
+                    lastRule = dfa.accept[state];
+                    lastEnd = cursor;
+                }
+                if (cursor >= length) break;
+            }
+
+            uint8_t nextState = dfa.step(state, data[cursor]);
+            if (nextState == NhykDfa::NO_STATE) {
+                NHYK_TRACE_EVENT(trace, NhykTraceKind::NO_TRANSITION, state, cursor, data[cursor]);
+                break;
+            }
+            NHYK_TRACE_EVENT(trace, NhykTraceKind::TRANSITION, state, cursor, data[cursor]);
+            state = nextState;
+            cursor++;
+            if (dfa.accept[state] >= 0) {
+                lastRule = dfa.accept[state];
+                lastEnd = cursor;
+            }
+        }
+        if (cursor >= length) {
+            // More input could extend the match: wait for it unless this is the end.
+            if (!endOfInput) {
+                stalled = true;
+                partial.state = state;
+                partial.rule = lastRule;
+                partial.end = lastEnd - begin;
+                partial.length = cursor - begin;
+                return false;
+            }
+            NHYK_TRACE_EVENT(trace, NhykTraceKind::END_OF_INPUT, state, cursor, 0);
+        }
+
+        // The walk looked at the byte it stopped on, or past the end for more input.
+        const unsigned int examined = cursor < length ? cursor + 1 : length + 1;
+
+        if (lastRule < 0) {
+            if (cursor > begin) {
+                reach = examined;
+                // Started a token but completed none (an unterminated string).
+                diagnostics.report(NhykDiagnosticKind::INCOMPLETE_TOKEN, begin, cursor - begin);
+                position = begin + 1;
+                out = Token(TokenType::UNKNOWN, source.substr(begin, 1));
+                return true;
+            }
+            // No token starts here: skip the whole run of such bytes and record it once.
+            do {
+                position++;
+            } while (position < length && dfa.step(NhykDfa::START, data[position]) == NhykDfa::NO_STATE);
+            diagnostics.report(NhykDiagnosticKind::INVALID_CHARACTERS, begin, position - begin);
+            continue;
+        }
+
+        position = lastEnd;
+        const NhykTokenRule& rule = nhykTokenRules[lastRule];
+        if (rule.skip) continue;
+        if (rule.type == TokenType::UNKNOWN)
+            diagnostics.report(NhykDiagnosticKind::MALFORMED_TOKEN, begin, lastEnd - begin);
+
+        std::string_view lexeme = source.substr(begin, lastEnd - begin);
+        TokenType type = rule.type;
+        KeywordKind keyword = KeywordKind::NONE;
+        if (type == TokenType::IDENTIFIER) {
+            // The keyword list lives in Keywords.h as a compile-time perfect hash.
+            keyword = lookupKeyword(lexeme);
+            if (keyword != KeywordKind::NONE) type = TokenType::KEYWORD;
+        }
+        out = Token(type, lexeme, keyword, symbols != nullptr ? symbols->internToken(type, lexeme) : Token::NO_SYMBOL);
+        // Numbers are converted here, while their digits are still in cache; TokenBuffer
+        // keeps the value, so the parser does not parse the text again.
+        if (type == TokenType::INT_LITERAL) {
+            int64_t value;
+            if (!nhykParseInt(lexeme, value))
+                diagnostics.report(NhykDiagnosticKind::NUMBER_OUT_OF_RANGE, begin, lastEnd - begin);
+            out.setInt(value);
+        } else if (type == TokenType::DOUBLE_LITERAL) {
+            double value;
+            if (!nhykParseDouble(lexeme, value))
+                diagnostics.report(NhykDiagnosticKind::NUMBER_OUT_OF_RANGE, begin, lastEnd - begin);
+            out.setDouble(value);
+        }
+        reach = examined;
+        NHYK_TRACE_EVENT(trace, NhykTraceKind::CLASSIFY, state, begin, static_cast<uint8_t>(type));
+        return true;
+    }
+    return false;
+}
+
+// --- where token processing happens:
+/**
+ * @brief Tokenizes the input source code and populates the `tokens` vector.
+ *
+ * The `tokenize` method processes the input source code from the cursor to the end,
+ * identifying and tokenizing different types of tokens such as identifiers, literals,
+ * operators, punctuation, and string literals. It utilizes the token DFA generated
+ * from NhykSpec.h to recognize and classify these tokens. When a valid token is
+ * identified, it is added to the `tokens` vector. If an unknown token is encountered,
+ * it is recorded in the lexer's diagnostics (see getErrors()).
+ *
+ * @details This method calls lexNext until the source is exhausted; each call walks the
+ * DFA once to classify and tokenize the input. It handles whitespace, identifiers,
+ * literals, operators, punctuation, and string literals. Detected tokens are added to
+ * the `tokens` vector. Runs of whitespace, identifier characters, digits and string
+ * bodies are skipped with the vectorized scanner from NhykScan.h.
+ *
+ * @see NhykSpec.h
+ * @see NhykDfa
+ *
+ * @return void
+ */
+void NhykLexer::tokenize() {
+    // Tokens already pulled into the lookahead come first.
+    tokens.insert(tokens.end(), lookahead.begin(), lookahead.end());
+    lookahead.clear();
+
+    // A Token is 32 bytes, so reserving for the worst-case estimate would take about eight
+    // times the input. Lex a 64 KiB sample first, then reserve for the rest at the density
+    // the sample showed, plus an eighth, so the vector is neither regrown nor oversized.
+    const unsigned int start = position;
+    const unsigned int sampleEnd = start + std::min<unsigned int>(static_cast<unsigned int>(source.size()) - start, 1 << 16);
+    const size_t first = tokens.size();
+    tokens.reserve(first + TokenBuffer::estimateTokens(sampleEnd - start));
+    Token token;
+    while (position < sampleEnd && lexNext(token)) tokens.push_back(token);
+    if (position > start && position < source.size()) {
+        const size_t rest = source.size() - position;
+        const size_t expected = (tokens.size() - first) * rest / (position - start);
+        tokens.reserve(tokens.size() + expected + expected / 8 + 16);
+    }
+    while (lexNext(token)) tokens.push_back(token);
+}
+
+/**
+ * @brief Tokenizes from the cursor to the end into a struct-of-arrays TokenBuffer.
+ *
+ * @details Same tokens as tokenize(), stored as (kind, offset, length) rows instead of
+ * Token objects. The buffer's arrays are sized once from the remaining input.
+ *
+ * @param out Reset to this lexer's source and filled with its tokens.
+ */
+void NhykLexer::tokenize(TokenBuffer& out) {
+    out.reset(source, lookahead.size() + TokenBuffer::estimateTokens(source.size() - position));
+    for (const Token& token : lookahead)
+        out.push(token, offsetOf(token));
+    lookahead.clear();
+
+    Token token;
+    while (lexNext(token))
+        out.push(token, offsetOf(token));
+}
+
+Token NhykLexer::next() {
+    if (!lookahead.empty()) {
+        Token token = lookahead.front();
+        lookahead.pop_front();
+        return token;
+    }
+    Token token;
+    if (lexNext(token)) return token;
+    return Token(TokenType::END_OF_INPUT, source.substr(position, 0));
+}
+
+const Token& NhykLexer::peek(size_t k) {
+    Token token;
+    while (lookahead.size() <= k && lexNext(token)) lookahead.push_back(token);
+    if (k < lookahead.size()) return lookahead[k];
+    endToken = Token(TokenType::END_OF_INPUT, source.substr(position, 0));
+    return endToken;
+}
+
+std::string_view NhykLexer::getSource() const {return source;}
+void NhykLexer::setSource(const std::string& newSource){
+    storage = newSource;
+    setSourceView(storage);
+}
+void NhykLexer::setSourceView(std::string_view view, bool final){
+    // Offsets and token positions are 32-bit.
+    if (view.size() > UINT_MAX)
+        throw std::length_error("NhykLexer: source larger than 4 GiB; use NhykStreamLexer");
+    // The old tokens view the buffer being replaced.
+    tokens.clear();
+    lookahead.clear();
+    source = view;
+    lines.clear();
+    diagnostics.clear();
+    position = 0;
+    endOfInput = final;
+    stalled = false;
+    resuming = false;
+}
+void NhykLexer::resumeSourceView(std::string_view view, bool final){
+    const bool carried = stalled;
+    setSourceView(view, final);
+    resuming = carried && view.size() >= partial.length;
+}
+const std::vector<Token>& NhykLexer::getTokens() const {return tokens;}
+
+NhykLocation NhykLexer::locate(unsigned int offset) const {
+    if (!lines.built()) lines.build(source);
+    return lines.locate(offset);
+}
+
+std::vector<ErrorToken> NhykLexer::getErrors() const {
+    std::vector<ErrorToken> errors;
+    errors.reserve(diagnostics.getEntries().size());
+    for (const NhykDiagnostic& diagnostic : diagnostics.getEntries()) {
+        NhykLocation where = locate(diagnostic.offset);
+        errors.push_back(ErrorToken{diagnostic.kind, diagnostic.offset, diagnostic.length,
+                                    where.line, where.column, NhykDiagnostics::message(diagnostic, source)});
+    }
+    return errors;
+}
+
+void NhykLexer::seek(unsigned int offset){
+    lookahead.clear();
+    position = offset < source.size() ? offset : static_cast<unsigned int>(source.size());
+    stalled = false;
+    resuming = false;
+}
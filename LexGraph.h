@@ -1,172 +1,338 @@
-#ifndef LEXGRAPH_H_INCLUDED
-#define LEXGRAPH_H_INCLUDED
-
-/**
- * @file LexGraph.h
- * @brief Defines the LexGraph class for lexical analysis in the Nhyk compiler.
- *
- * This file contains the definition of the LexGraph class, which represents a
- * lexical graph used for tokenization and parsing in the Nhyk compiler.
- *
- * @author MNS Ahimbisibwe
- * @SN 217005435
- * @date [2023/09/03]
- * @model Lexical Analysis Design
- * @version [D01]
- */
-
-#include <map>
-#include "Token.h"
-
-class NhykLexicalNode {
-    /*This header class style adapted from: [Prof DA Coulter's Example]
-    *Source URL: [https://eve.uj.ac.za/lectures.php#lecture-it08x87]
-    */
-    /**
-     * @file LexGraph.h
-     * @brief Defines the NhykLexicalNode class for building lexical graphs.
-     *
-     * This file contains the definition of the NhykLexicalNode class, which is used
-     * to construct nodes in lexical graphs for tokenization and parsing.
-     *
-     @author MNS Ahimbisibwe
-     * @SN 217005435
-     * @date [2023/09/03]
-     * @model Lexical Analysis Design
-     * @version [D01]
-     */
-
-public:
-    std::string name;
-    std::map<char, NhykLexicalNode*> transitions;
-    bool terminal;
-};
-
-/*
-*   LexGraph maintains a starting state('start'), set of transitions between states
-*   (encorded in 'NhykLexicalNode' objects) and a method ('classify') to determine the type of token
-*   once traversal ends
-*/
-class LexGraph {
-    /*
-    * The LexGraph class represents a lexical graph for parsing and tokenization.
-    * Some parts of this header class were adapted from Prof DA Coulter's Example.
-    * Source URL: [https://eve.uj.ac.za/lectures.php#lecture-it08x87]
-    */
-
-protected:
-    std::string source;                // The source string to be tokenized.
-    //Using an unsigned type can help catch bugs in additional to can represent large number
-    unsigned int position;             // Current position in the source string.
-    NhykLexicalNode* start;            // Starting node of the lexical graph.
-    std::vector<Token> tokens;         // Stores the tokens extracted from the source.
-
-    // Traverses the lexical graph from the given node.
-    virtual void traverse(NhykLexicalNode* node);
-
-    // Classifies the given node. Implementation is provided by derived classes.
-    virtual void classify(NhykLexicalNode* node) = 0;
-
-public:
-    LexGraph();                        // Default constructor.
-    virtual ~LexGraph();               // Destructor. Use 'virtual' for proper destruction in derived classes.
-
-    // Public interface to the traverse function for external use.
-    void publicTraverse(NhykLexicalNode* node){traverse(node);}
-
-    // Overload stream insertion operator for output.
-    // This method will be called whenever '<<' is invoked on the object
-    friend std::ostream& operator<<(std::ostream& out, const LexGraph& graph);
-
-    // Getter for the source string.
-    std::string getSource() const;
-
-    // Getter for the tokens vector.
-    std::vector<Token>& getTokens();
-
-    // Setter for the source string.
-    void setSource(const std::string& newSource);
-
-    // Getter for the starting node of the lexical graph.
-    NhykLexicalNode* getStartNode() const {return start;}
-
-    // Setter for the starting node of the lexical graph.
-    void setStartNode(NhykLexicalNode* node){start = node;}
-
-    void clearTokens();
-};
-
-
-class LexGraphID : public LexGraph {
-
-private:
-    NhykLexicalNode s1;
-    NhykLexicalNode s2;
-    NhykLexicalNode s_error;
-
-public:
-    LexGraphID();
-    void classify(NhykLexicalNode* node) override;
-};
-
-// --- LexGraphStringLiteral Implementation ---
-class LexGraphStringLiteral : public LexGraph{
-public:
-    LexGraphStringLiteral();
-    void classify(NhykLexicalNode* node) override;
-private:
-    NhykLexicalNode s1, s2, s3;
-};
-
-/*LexGraphOperator derived from LexGraph base class. Derived class will implement
-the FSM for recognizing operators based on the transitions between the states
-Designed to recognize basic operators like '+'...*/
-class LexGraphOperator : public LexGraph{
-private:
-    NhykLexicalNode s1;
-    NhykLexicalNode s2;
-public:
-    LexGraphOperator();
-    void classify(NhykLexicalNode* node) override;
-};
-
-class LexGraphLiteral : public LexGraph{
-private:
-    NhykLexicalNode s1, s2, s3, s_error;
-public:
-    LexGraphLiteral();
-    void classify(NhykLexicalNode* node) override;
-};
-
-class LexGraphPunctuation : public LexGraph {
-private:
-    NhykLexicalNode s1;
-
-public:
-    LexGraphPunctuation();
-    void classify(NhykLexicalNode* node) override;
-};
-
-class NhykLexer {
-private:
-    std::string source;
-    unsigned int position;
-    std::vector<Token> tokens;
-
-    LexGraphID idFSM;
-    LexGraphStringLiteral stringLiteralFSM;
-    LexGraphOperator operatorFSM;
-    LexGraphLiteral literalFSM;
-    LexGraphPunctuation punctuationFSM;
-
-public:
-    NhykLexer(const std::string& src);
-    void tokenize();
-    const std::vector<Token>& getTokens() const;
-    // Getter for source
-    std::string getSource() const;
-    // Setter for source
-    void setSource(const std::string& newSource);
-};
-
-#endif // LEXGRAPH_H_INCLUDED
+#ifndef LEXGRAPH_H_INCLUDED
+#define LEXGRAPH_H_INCLUDED
+
+/**
+ * @file LexGraph.h
+ * @brief Defines the LexGraph class for lexical analysis in the Nhyk compiler.
+ *
+ * This file contains the definition of the LexGraph class, which represents a
+ * lexical graph used for tokenization and parsing in the Nhyk compiler.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <deque>
+#include <iterator>
+#include <map>
+#include "Token.h"
+#include "TokenBuffer.h"
+#include "LexTable.h"
+#include "NhykTrace.h"
+#include "NhykSymbols.h"
+#include "NhykLines.h"
+#include "NhykDiagnostics.h"
+
+class NhykLexicalNode {
+    /*This header class style adapted from: [Prof DA Coulter's Example]
+    *Source URL: [https://eve.uj.ac.za/lectures.php#lecture-it08x87]
+    */
+    /**
+     * @file LexGraph.h
+     * @brief Defines the NhykLexicalNode class for building lexical graphs.
+     *
+     * This file contains the definition of the NhykLexicalNode class, which is used
+     * to construct nodes in lexical graphs for tokenization and parsing.
+     *
+     @author MNS Ahimbisibwe
+     * @SN 217005435
+     * @date [2023/09/03]
+     * @model Lexical Analysis Design
+     * @version [D01]
+     */
+
+public:
+    std::string name;
+    std::map<char, NhykLexicalNode*> transitions;
+    bool terminal;
+};
+
+/*
+*   LexGraph maintains a starting state('start'), set of transitions between states
+*   (encorded in 'NhykLexicalNode' objects) and a method ('classify') to determine the type of token
+*   once traversal ends
+*/
+class LexGraph {
+    /*
+    * The LexGraph class represents a lexical graph for parsing and tokenization.
+    * Some parts of this header class were adapted from Prof DA Coulter's Example.
+    * Source URL: [https://eve.uj.ac.za/lectures.php#lecture-it08x87]
+    */
+
+protected:
+    std::string_view source;           // View of the whole buffer being tokenized (not owned).
+    //Using an unsigned type can help catch bugs in additional to can represent large number
+    unsigned int begin;                // Offset in 'source' where the current token starts.
+    unsigned int position;             // Cursor: current position in the source buffer.
+    NhykLexicalNode* start;            // Starting node of the lexical graph.
+    std::vector<Token> tokens;         // Stores the tokens extracted from the source.
+    NhykTransitionTable table;         // Compiled form of the graph reachable from 'start'.
+    NhykTraceBuffer* trace;            // Receives step events when built with NHYK_TRACE.
+    bool hitEnd;                       // The last traversal ran into the end of 'source'.
+    NhykSymbolTable* symbols;          // Where names and string contents are interned; may be nullptr.
+
+    // Traverses the lexical graph from the given node, consuming the longest accepted
+    // prefix of the input, then classifies the node it ended in.
+    virtual void traverse(NhykLexicalNode* node);
+
+    // Classifies the given node. Implementation is provided by derived classes.
+    virtual void classify(NhykLexicalNode* node) = 0;
+
+    // Text consumed since 'begin', as a view into the source buffer.
+    std::string_view lexeme() const {return source.substr(begin, position - begin);}
+
+public:
+    LexGraph();                        // Default constructor.
+    virtual ~LexGraph();               // Destructor. Use 'virtual' for proper destruction in derived classes.
+
+    // Public interface to the traverse function for external use.
+    void publicTraverse(NhykLexicalNode* node){traverse(node);}
+
+    // Overload stream insertion operator for output.
+    // This method will be called whenever '<<' is invoked on the object
+    friend std::ostream& operator<<(std::ostream& out, const LexGraph& graph);
+
+    // Getter for the source buffer.
+    std::string_view getSource() const;
+
+    // Getter for the tokens vector.
+    std::vector<Token>& getTokens();
+
+    // Points the FSM at 'newSource' with the cursor at 'offset'. The buffer is not copied
+    // and must outlive the tokens produced from it.
+    void setSource(std::string_view newSource, unsigned int offset = 0);
+
+    // Offset where the last traversal stopped: one past the token it classified.
+    unsigned int getPosition() const {return position;}
+
+    // Getter for the starting node of the lexical graph.
+    NhykLexicalNode* getStartNode() const {return start;}
+
+    // Setter for the starting node of the lexical graph.
+    void setStartNode(NhykLexicalNode* node){start = node; table = NhykTransitionTable();}
+
+    // Compiles the graph reachable from 'start' into 'table'. Called lazily by traverse.
+    void compile();
+
+    // Getter for the compiled transition table.
+    const NhykTransitionTable& getTable() const {return table;}
+
+    // True if the last traversal stopped at the end of the buffer rather than on a byte
+    // with no transition, i.e. more input could have extended the token.
+    bool reachedEnd() const {return hitEnd;}
+
+    void clearTokens();
+
+    // Attaches a trace buffer (or detaches with nullptr). Events are only recorded
+    // in builds with NHYK_TRACE defined to 1.
+    void setTrace(NhykTraceBuffer* buffer){trace = buffer;}
+
+    // Interns the text of the tokens this FSM classifies into 'table' (nullptr: no ids).
+    void setSymbolTable(NhykSymbolTable* table){symbols = table;}
+};
+
+
+class LexGraphID : public LexGraph {
+
+private:
+    NhykLexicalNode s1;
+    NhykLexicalNode s2;
+    NhykLexicalNode s_error;
+
+public:
+    LexGraphID();
+    void classify(NhykLexicalNode* node) override;
+};
+
+// --- LexGraphStringLiteral Implementation ---
+class LexGraphStringLiteral : public LexGraph{
+public:
+    LexGraphStringLiteral();
+    void classify(NhykLexicalNode* node) override;
+private:
+    NhykLexicalNode s1, s2, s3;
+};
+
+/*LexGraphOperator derived from LexGraph base class. Derived class will implement
+the FSM for recognizing operators based on the transitions between the states
+Designed to recognize basic operators like '+'...*/
+class LexGraphOperator : public LexGraph{
+private:
+    NhykLexicalNode s1;
+    NhykLexicalNode s2;
+public:
+    LexGraphOperator();
+    void classify(NhykLexicalNode* node) override;
+};
+
+class LexGraphLiteral : public LexGraph{
+private:
+    NhykLexicalNode s1, s2, s3, s_error;
+public:
+    LexGraphLiteral();
+    void classify(NhykLexicalNode* node) override;
+};
+
+class LexGraphPunctuation : public LexGraph {
+private:
+    NhykLexicalNode s1;
+
+public:
+    LexGraphPunctuation();
+    void classify(NhykLexicalNode* node) override;
+};
+
+class NhykMappedFile;
+
+/*
+*   NhykLexer reads one immutable buffer: either its own copy of the source text or a
+*   borrowed view (a mapped file, a stream chunk). Every Token it produces is a view
+*   into that buffer, so tokens are invalidated by setSource()/setSourceView() and by
+*   destroying the lexer or the borrowed buffer.
+*
+*   Tokens are recognized by walking nhykTokenDfa, the table compiled at build time from
+*   the rules in NhykSpec.h. The LexGraph FSMs above remain available on their own but
+*   are no longer used by the lexer.
+*/
+class NhykLexer {
+private:
+    std::string storage;               // Owned copy of the source, when not borrowed.
+    std::string_view source;           // The buffer being tokenized.
+    unsigned int position;
+    bool endOfInput;                   // False while more input may follow 'source'.
+    bool stalled;                      // Stopped before a token that may continue.
+    bool resuming;                     // The next walk continues 'partial' (see resumeSourceView).
+    struct {
+        uint8_t state;
+        int rule;                      // Last rule accepted, or -1.
+        unsigned int end;              // Where it was accepted, from the token's start.
+        unsigned int length;           // Bytes walked, from the token's start.
+    } partial;                         // The walk a partial buffer's end cut off.
+    NhykDiagnostics diagnostics;       // Errors found in the current source.
+    NhykSymbolTable ownSymbols;        // Default symbol table, shared by every source lexed.
+    NhykSymbolTable* symbols;          // Table tokens are interned into; nullptr for none.
+    std::vector<Token> tokens;
+    std::deque<Token> lookahead;       // Tokens pulled by peek() but not yet by next().
+    Token endToken;                    // Returned by peek() past the end.
+    NhykTraceBuffer* trace;            // Receives DFA steps when built with NHYK_TRACE.
+    unsigned int reach;                // See getReach().
+    mutable NhykLineIndex lines;       // Built on the first locate() for the current source.
+
+    // Recognizes the next token after the cursor; false when there is none, or when the
+    // token may continue past a partial buffer (the cursor then stays at its start).
+    bool lexNext(Token& out);
+
+public:
+    NhykLexer(const std::string& src);
+    // Lexes a mapped file in place. The file must outlive the lexer and its tokens.
+    explicit NhykLexer(const NhykMappedFile& file);
+    // Tokens view the lexer's own buffer, which a copy would not share.
+    NhykLexer(const NhykLexer&) = delete;
+    NhykLexer& operator=(const NhykLexer&) = delete;
+
+    // Lexes everything from the cursor to the end into the token vector.
+    void tokenize();
+    // Lexes everything from the cursor to the end into 'out', which is reset to this
+    // lexer's source first. Nothing is added to the token vector.
+    void tokenize(TokenBuffer& out);
+    const std::vector<Token>& getTokens() const;
+
+    // Pull interface: lexes only as far as asked, keeping just the lookahead in memory.
+    // At the end both return an END_OF_INPUT token with an empty lexeme.
+    Token next();                         // Consumes and returns the next token.
+    const Token& peek(size_t k = 0);      // The token k positions ahead, without consuming.
+
+    // Getter for source
+    std::string_view getSource() const;
+    // Setter for source. Copies the text and discards the tokens of the previous source.
+    void setSource(const std::string& newSource);
+    // Borrows 'view' without copying it. With 'final' false the buffer is treated as a
+    // prefix of a longer input: tokenize() stops before any token that reaches the end
+    // of the buffer, and getPosition() tells where the next buffer must resume.
+    void setSourceView(std::string_view view, bool final = true);
+    // Like setSourceView(), for the input that follows a partial buffer: 'view' must
+    // start with that buffer's bytes from getPosition() on. The DFA walk over the token
+    // that stalled picks up where it stopped instead of reading the token again, so a
+    // token spread over many buffers is still walked once.
+    void resumeSourceView(std::string_view view, bool final = true);
+    // Offset in the source where tokenize() stopped.
+    unsigned int getPosition() const {return position;}
+    // Moves the cursor to 'offset' and drops any lookahead; lexing resumes there.
+    void seek(unsigned int offset);
+    // Offset in the source of the first byte of 'token' (which must view this lexer's source).
+    unsigned int offsetOf(const Token& token) const {
+        return static_cast<unsigned int>(token.getLexeme().data() - source.data());
+    }
+    // Line and column of a source offset, or of a token's first byte. The line index
+    // is built on the first call after each setSource/setSourceView, so lexing itself
+    // never counts lines. For a partial buffer, lines count from the buffer's start.
+    NhykLocation locate(unsigned int offset) const;
+    NhykLocation locate(const Token& token) const {return locate(offsetOf(token));}
+    // One past the last byte examined to recognize the most recently lexed token, or the
+    // source size + 1 if the walk ran into the end. Editing only bytes at or after this
+    // point cannot change that token.
+    unsigned int getReach() const {return reach;}
+    // Errors found in the current source so far, with their lines, columns and messages.
+    // Nothing is written anywhere while lexing; callers print these if they want to.
+    std::vector<ErrorToken> getErrors() const;
+    // The raw (kind, offset, length) entries behind getErrors().
+    const NhykDiagnostics& getDiagnostics() const {return diagnostics;}
+    // Keeps at most 'maxErrors' errors per source (see NhykDiagnostics::setLimit).
+    void setErrorLimit(size_t maxErrors) {diagnostics.setLimit(maxErrors);}
+    // Attaches a trace buffer to the lexer's DFA walk (see NhykTrace.h).
+    void setTrace(NhykTraceBuffer* buffer) {trace = buffer;}
+    // Interns identifiers and string contents into 'table' instead of the lexer's own
+    // table; nullptr turns interning off and leaves every token's symbol NO_SYMBOL.
+    void setSymbolTable(NhykSymbolTable* table) {symbols = table;}
+    // The table token symbols refer to (nullptr when interning is off).
+    NhykSymbolTable* getSymbolTable() const {return symbols;}
+};
+
+/*
+*   NhykTokenStream adapts NhykLexer::next() to an input iterator, so tokens can be
+*   consumed lazily with a range-for:  for (const Token& t : NhykTokenStream(lexer)) ...
+*   Iteration stops at END_OF_INPUT.
+*/
+class NhykTokenStream {
+public:
+    struct Sentinel {};
+
+    class Iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Token value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Token* pointer;
+        typedef const Token& reference;
+
+        Iterator() : lexer(nullptr) {}
+        explicit Iterator(NhykLexer* lex) : lexer(lex), current(lex->next()) {}
+
+        reference operator*() const {return current;}
+        pointer operator->() const {return &current;}
+        Iterator& operator++() {current = lexer->next(); return *this;}
+        void operator++(int) {++*this;}
+
+        friend bool operator==(const Iterator& it, Sentinel) {return it.current.getType() == TokenType::END_OF_INPUT;}
+        friend bool operator!=(const Iterator& it, Sentinel end) {return !(it == end);}
+        friend bool operator==(Sentinel end, const Iterator& it) {return it == end;}
+        friend bool operator!=(Sentinel end, const Iterator& it) {return !(it == end);}
+
+    private:
+        NhykLexer* lexer;
+        Token current;
+    };
+
+    explicit NhykTokenStream(NhykLexer& lex) : lexer(lex) {}
+
+    Iterator begin() {return Iterator(&lexer);}
+    Sentinel end() const {return Sentinel();}
+
+private:
+    NhykLexer& lexer;
+};
+
+#endif // LEXGRAPH_H_INCLUDED
@@ -0,0 +1,105 @@
+#include "LexTable.h"
+#include "LexGraph.h"
+#include <map>
+#include <stdexcept>
+/**
+ * @file LexTable.cpp
+ * @brief Implementation of the NhykTransitionTable class.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+NhykTransitionTable::NhykTransitionTable() : numClasses(0) {
+    for (int i = 0; i < 256; ++i) byteClass[i] = 0;
+}
+
+/**
+ * @brief Compiles the lexical graph rooted at 'start' into a dense transition table.
+ *
+ * @details Nodes are numbered in breadth-first order so that 'start' becomes state 0.
+ * Each input byte is then described by the column of target states it produces across
+ * all states; bytes with identical columns share one byte class, which keeps the table
+ * at stateCount() * classCount() entries instead of stateCount() * 256. Finally, every
+ * state whose self-loop covers the whole class of one of the nhykScan kernels is tagged
+ * with that kernel, widest class first.
+ *
+ * @param start The starting node of the graph to compile.
+ */
+void NhykTransitionTable::build(NhykLexicalNode* start) {
+    nodes.clear();
+    terminal.clear();
+    scanKinds.clear();
+    table.clear();
+    numClasses = 0;
+    if (start == nullptr) return;
+
+    // Number the reachable nodes densely, breadth first.
+    std::map<NhykLexicalNode*, uint16_t> ids;
+    ids[start] = 0;
+    nodes.push_back(start);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (const auto& tr : nodes[i]->transitions) {
+            if (ids.find(tr.second) == ids.end()) {
+                if (nodes.size() >= NO_STATE)
+                    throw std::length_error("Lexical graph has too many states for NhykTransitionTable");
+                ids[tr.second] = static_cast<uint16_t>(nodes.size());
+                nodes.push_back(tr.second);
+            }
+        }
+    }
+
+    // Column of target states for every input byte.
+    const size_t stateTotal = nodes.size();
+    std::vector<std::vector<uint16_t>> columns(256, std::vector<uint16_t>(stateTotal, NO_STATE));
+    for (size_t s = 0; s < stateTotal; ++s) {
+        terminal.push_back(nodes[s]->terminal ? 1 : 0);
+        for (const auto& tr : nodes[s]->transitions)
+            columns[static_cast<unsigned char>(tr.first)][s] = ids[tr.second];
+    }
+
+    // Bytes with identical columns collapse into one class.
+    std::map<std::vector<uint16_t>, uint8_t> classes;
+    std::vector<const std::vector<uint16_t>*> classColumns;
+    for (int b = 0; b < 256; ++b) {
+        auto found = classes.find(columns[b]);
+        if (found == classes.end()) {
+            found = classes.emplace(columns[b], static_cast<uint8_t>(classColumns.size())).first;
+            classColumns.push_back(&found->first);
+        }
+        byteClass[b] = found->second;
+    }
+    numClasses = static_cast<unsigned int>(classColumns.size());
+
+    table.assign(stateTotal * numClasses, NO_STATE);
+    for (size_t s = 0; s < stateTotal; ++s)
+        for (unsigned int c = 0; c < numClasses; ++c)
+            table[s * numClasses + c] = (*classColumns[c])[s];
+
+    // Attach a run scanner to states that loop on every byte of its class.
+    static const NhykScanKind candidates[] = {
+        NhykScanKind::STRING_BODY, NhykScanKind::IDENT_CONTINUE, NhykScanKind::DIGITS
+    };
+    scanKinds.assign(stateTotal, static_cast<uint8_t>(NhykScanKind::NONE));
+    for (size_t s = 0; s < stateTotal; ++s) {
+        for (NhykScanKind kind : candidates) {
+            bool loops = true;
+            for (int b = 0; b < 256 && loops; ++b)
+                if (nhykInScanClass(kind, static_cast<unsigned char>(b)) && columns[b][s] != s)
+                    loops = false;
+            if (loops) {
+                scanKinds[s] = static_cast<uint8_t>(kind);
+                break;
+            }
+        }
+    }
+}
+
+uint16_t NhykTransitionTable::stateOf(const NhykLexicalNode* node) const {
+    for (size_t s = 0; s < nodes.size(); ++s)
+        if (nodes[s] == node) return static_cast<uint16_t>(s);
+    return NO_STATE;
+}
@@ -0,0 +1,74 @@
+#ifndef LEXTABLE_H_INCLUDED
+#define LEXTABLE_H_INCLUDED
+
+/**
+ * @file LexTable.h
+ * @brief Defines the NhykTransitionTable class, the compiled form of a lexical graph.
+ *
+ * A lexical graph built from NhykLexicalNode objects is convenient to write but slow
+ * to walk: every step is a std::map lookup. NhykTransitionTable numbers the reachable
+ * nodes densely (the start node is always state 0), groups input bytes into classes
+ * that behave identically in every state, and stores the graph as a flat
+ * next[state][class] array so that one step of the FSM is a single indexed load.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <vector>
+#include "NhykScan.h"
+
+class NhykLexicalNode;
+
+class NhykTransitionTable {
+public:
+    // Marks a missing transition in the table.
+    static constexpr uint16_t NO_STATE = 0xFFFF;
+
+    NhykTransitionTable();
+
+    // Numbers every node reachable from 'start' and fills the transition table.
+    void build(NhykLexicalNode* start);
+
+    // True until build() has been called.
+    bool empty() const {return nodes.empty();}
+
+    // Number of states and byte classes in the compiled table.
+    unsigned int stateCount() const {return static_cast<unsigned int>(nodes.size());}
+    unsigned int classCount() const {return numClasses;}
+
+    // The node that was compiled into state 0.
+    NhykLexicalNode* getStartNode() const {return nodes.empty() ? nullptr : nodes[0];}
+
+    // Next state for 'byte' in 'state', or NO_STATE if the graph has no such transition.
+    uint16_t next(uint16_t state, unsigned char byte) const {
+        return table[state * numClasses + byteClass[byte]];
+    }
+
+    // Maps a state id back to the node it was compiled from (needed by 'classify').
+    NhykLexicalNode* node(uint16_t state) const {return nodes[state];}
+
+    // Maps a node to its state id, or NO_STATE if it is not reachable from the start node.
+    uint16_t stateOf(const NhykLexicalNode* node) const;
+
+    // Whether the node compiled into 'state' is a terminal (accepting) node.
+    bool isTerminal(uint16_t state) const {return terminal[state] != 0;}
+
+    // Fast-path scanner whose whole class loops 'state' back to itself, or NONE.
+    // A run of such bytes can be skipped with nhykScan instead of stepped one by one.
+    NhykScanKind scanKind(uint16_t state) const {return static_cast<NhykScanKind>(scanKinds[state]);}
+
+private:
+    uint8_t byteClass[256];            // Input byte -> equivalence class.
+    unsigned int numClasses;           // Number of distinct byte classes.
+    std::vector<uint16_t> table;       // Row-major next[state][class].
+    std::vector<NhykLexicalNode*> nodes;
+    std::vector<uint8_t> terminal;
+    std::vector<uint8_t> scanKinds;    // NhykScanKind per state.
+};
+
+#endif // LEXTABLE_H_INCLUDED
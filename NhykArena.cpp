@@ -0,0 +1,54 @@
+#include "NhykArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+/**
+ * @file NhykArena.cpp
+ * @brief Implementation of the bump allocator.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+NhykArena::NhykArena(size_t blockSize)
+    : blockSize(std::max<size_t>(blockSize, 64)), cursor(nullptr), limit(nullptr), used(0), reserved(0) {}
+
+void NhykArena::grow(size_t minimum) {
+    // Requests larger than a block get a block of their own.
+    size_t size = std::max(blockSize, minimum);
+    blocks.push_back(Block{std::unique_ptr<char[]>(new char[size]), size});
+    cursor = blocks.back().data.get();
+    limit = cursor + size;
+    reserved += size;
+}
+
+void* NhykArena::allocate(size_t size, size_t align) {
+    uintptr_t at = (reinterpret_cast<uintptr_t>(cursor) + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+    if (cursor == nullptr || at + size > reinterpret_cast<uintptr_t>(limit)) {
+        grow(size + align);
+        at = (reinterpret_cast<uintptr_t>(cursor) + (align - 1)) & ~static_cast<uintptr_t>(align - 1);
+    }
+    char* result = reinterpret_cast<char*>(at);
+    used += static_cast<size_t>(result + size - cursor);
+    cursor = result + size;
+    return result;
+}
+
+std::string_view NhykArena::copy(std::string_view text) {
+    if (text.empty()) return std::string_view();
+    char* target = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(target, text.data(), text.size());
+    return std::string_view(target, text.size());
+}
+
+void NhykArena::reset() {
+    if (blocks.empty()) return;
+    blocks.resize(1);
+    cursor = blocks.front().data.get();
+    limit = cursor + blocks.front().size;
+    used = 0;
+    reserved = blocks.front().size;
+}
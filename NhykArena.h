@@ -0,0 +1,64 @@
+#ifndef NHYKARENA_H_INCLUDED
+#define NHYKARENA_H_INCLUDED
+
+/**
+ * @file NhykArena.h
+ * @brief Defines NhykArena, a bump allocator for data that lives as long as a whole pass.
+ *
+ * Allocation moves a pointer forward inside the current block and takes a new block
+ * when that one is full; nothing is freed individually. reset() releases everything at
+ * once but keeps the first block for reuse, so a lexer or parser that runs many times
+ * stops allocating after the first run. Objects placed in the arena are never
+ * destroyed, so it is meant for text and trivially destructible records.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class NhykArena {
+public:
+    explicit NhykArena(size_t blockSize = 64 * 1024);
+    NhykArena(const NhykArena&) = delete;
+    NhykArena& operator=(const NhykArena&) = delete;
+    NhykArena(NhykArena&&) = default;
+    NhykArena& operator=(NhykArena&&) = default;
+
+    // Uninitialized storage for 'size' bytes aligned to 'align' (a power of two).
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+    // Copies 'text' into the arena; the result stays valid until reset().
+    std::string_view copy(std::string_view text);
+    // Uninitialized storage for 'count' objects of a trivially destructible type.
+    template <typename T>
+    T* allocateArray(size_t count) {return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));}
+
+    // Frees every allocation at once, keeping the first block.
+    void reset();
+
+    size_t bytesUsed() const {return used;}           // Handed out, including padding.
+    size_t bytesReserved() const {return reserved;}   // Held in blocks.
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t blockSize;
+    char* cursor;                      // Next free byte of the last block.
+    char* limit;                       // End of the last block.
+    size_t used;
+    size_t reserved;
+
+    void grow(size_t minimum);
+};
+
+#endif // NHYKARENA_H_INCLUDED
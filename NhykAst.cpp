@@ -0,0 +1,254 @@
+#include "NhykAst.h"
+#include <charconv>
+#include <string>
+/**
+ * @file NhykAst.cpp
+ * @brief Implementation of the syntax tree store and its printer.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+const char* nhykOpText(NhykOp op) {
+    switch (op) {
+        case NhykOp::NONE:   return "";
+        case NhykOp::ADD:    return "+";
+        case NhykOp::SUB:    return "-";
+        case NhykOp::MUL:    return "*";
+        case NhykOp::DIV:    return "/";
+        case NhykOp::EQ:     return "==";
+        case NhykOp::NE:     return "!=";
+        case NhykOp::LT:     return "<";
+        case NhykOp::LE:     return "<=";
+        case NhykOp::GT:     return ">";
+        case NhykOp::GE:     return ">=";
+        case NhykOp::AND:    return "AND";
+        case NhykOp::IN:     return "IS IN";
+        case NhykOp::NOT_IN: return "IS NOT IN";
+        case NhykOp::NEG:    return "-";
+        case NhykOp::NOT:    return "NOT";
+    }
+    return "";
+}
+
+// --- NhykAst Implementation ---
+
+NhykAst::NhykAst() : root(NO_NODE) {}
+
+void NhykAst::clear() {
+    nodes.clear();
+    lists.clear();
+    numbers.clear();
+    root = NO_NODE;
+}
+
+void NhykAst::reserve(size_t tokens) {
+    // Every node but a few (lists, PROGRAM) is parsed from a token of its own.
+    nodes.reserve(tokens + 16);
+    lists.reserve(tokens / 2 + 16);
+    numbers.reserve(tokens / 8 + 16);
+}
+
+uint32_t NhykAst::add(NhykNodeKind kind, uint32_t token) {
+    nodes.push_back(NhykNode{kind, NhykOp::NONE, KeywordKind::NONE, 0, token,
+                             NhykSymbolTable::NO_SYMBOL, NO_NODE, NO_NODE, NO_NODE});
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void NhykAst::setList(uint32_t id, const uint32_t* ids, size_t count) {
+    NhykNode& node = nodes[id];
+    node.b = static_cast<uint32_t>(lists.size());
+    node.c = static_cast<uint32_t>(count);
+    lists.insert(lists.end(), ids, ids + count);
+}
+
+uint32_t NhykAst::addInt(int64_t value) {
+    Number number;
+    number.integer = value;
+    numbers.push_back(number);
+    return static_cast<uint32_t>(numbers.size() - 1);
+}
+
+uint32_t NhykAst::addDouble(double value) {
+    Number number;
+    number.real = value;
+    numbers.push_back(number);
+    return static_cast<uint32_t>(numbers.size() - 1);
+}
+
+size_t NhykAst::memoryUsage() const {
+    return nodes.capacity() * sizeof(NhykNode) + lists.capacity() * sizeof(uint32_t)
+         + numbers.capacity() * sizeof(Number);
+}
+
+void NhykAst::print(std::ostream& out, const NhykSymbolTable& names) const {
+    if (root == NO_NODE) return;
+    printNode(out, names, root, 0);
+    out << '\n';
+}
+
+namespace {
+
+std::string_view nameOf(const NhykSymbolTable& names, uint32_t symbol) {
+    return symbol == NhykSymbolTable::NO_SYMBOL ? std::string_view("?") : names.name(symbol);
+}
+
+// Shortest text that reads back as 'value', with ".0" added to whole numbers so doubles
+// stay distinguishable from integers.
+std::string doubleText(double value) {
+    char text[32];
+    char* end = std::to_chars(text, text + sizeof(text), value).ptr;
+    std::string result(text, end);
+    if (result.find_first_of(".en") == std::string::npos) result += ".0";
+    return result;
+}
+
+} // namespace
+
+/**
+ * @brief Prints node 'id' and everything below it.
+ *
+ * @details Statements start on a new line indented two spaces per level; expressions,
+ * declarations and parameters are printed inline.
+ */
+void NhykAst::printNode(std::ostream& out, const NhykSymbolTable& names, uint32_t id, int depth) const {
+    if (id == NO_NODE) {
+        out << "()";
+        return;
+    }
+    const NhykNode& node = nodes[id];
+    // A child statement goes on a line of its own, anything else after a space.
+    auto line = [&](uint32_t child) {
+        out << '\n' << std::string(static_cast<size_t>(depth + 1) * 2, ' ');
+        printNode(out, names, child, depth + 1);
+    };
+    auto operand = [&](uint32_t child) {
+        out << ' ';
+        printNode(out, names, child, depth);
+    };
+
+    switch (node.kind) {
+        case NhykNodeKind::PROGRAM:
+            out << "(PROG " << nameOf(names, node.symbol);
+            for (uint32_t child : list(id)) line(child);
+            break;
+        case NhykNodeKind::BLOCK:
+            out << "(BLOCK";
+            for (uint32_t child : list(id)) line(child);
+            break;
+        case NhykNodeKind::VAR:
+            out << "(VAR";
+            for (uint32_t child : list(id)) operand(child);
+            break;
+        case NhykNodeKind::DECL:
+        case NhykNodeKind::PARAM:
+            if (node.kind == NhykNodeKind::PARAM && node.type == KeywordKind::NONE) {
+                out << nameOf(names, node.symbol);
+                return;
+            }
+            out << '(' << nameOf(names, node.symbol);
+            if (node.type != KeywordKind::NONE) out << ' ' << keywordText(node.type);
+            if (node.kind == NhykNodeKind::DECL && node.a != NO_NODE) operand(node.a);
+            break;
+        case NhykNodeKind::FUNC:
+            out << "(FUNC " << nameOf(names, node.symbol) << " (";
+            for (uint32_t i = 0; i < node.c; ++i) {
+                if (i != 0) out << ' ';
+                printNode(out, names, list(id)[i], depth);
+            }
+            out << ')';
+            line(node.a);
+            break;
+        case NhykNodeKind::ASSIGN:
+            out << "(= " << nameOf(names, node.symbol);
+            operand(node.a);
+            break;
+        case NhykNodeKind::IF:
+            out << "(IF";
+            operand(node.a);
+            line(node.b);
+            if (node.c != NO_NODE) line(node.c);
+            break;
+        case NhykNodeKind::WHILE:
+            out << "(WHILE";
+            operand(node.a);
+            line(node.b);
+            break;
+        case NhykNodeKind::FOR:
+            out << "(FOR " << nameOf(names, node.symbol);
+            operand(node.a);
+            operand(node.b);
+            line(node.c);
+            break;
+        case NhykNodeKind::MATCH:
+            out << "(MATCH";
+            operand(node.a);
+            for (uint32_t child : list(id)) line(child);
+            break;
+        case NhykNodeKind::CASE:
+            if (node.a == NO_NODE) {
+                out << "(DEFAULT";
+            } else {
+                out << "(CASE";
+                operand(node.a);
+            }
+            for (uint32_t child : list(id)) line(child);
+            break;
+        case NhykNodeKind::OUTPUT:
+            out << "(OUTPUT";
+            for (uint32_t child : list(id)) operand(child);
+            break;
+        case NhykNodeKind::INPUT:
+            out << "(INPUT " << nameOf(names, node.symbol);
+            break;
+        case NhykNodeKind::RETURN:
+            out << "(RETURN";
+            if (node.a != NO_NODE) operand(node.a);
+            break;
+        case NhykNodeKind::EXPRESSION:
+            printNode(out, names, node.a, depth);
+            return;
+        case NhykNodeKind::INT: {
+            char text[24];
+            out.write(text, std::to_chars(text, text + sizeof(text), getInt(id)).ptr - text);
+            return;
+        }
+        case NhykNodeKind::DOUBLE:
+            out << doubleText(getDouble(id));
+            return;
+        case NhykNodeKind::BOOL:
+            out << (node.a != 0 ? "TRUE" : "FALSE");
+            return;
+        case NhykNodeKind::STRING:
+            out << '"' << nameOf(names, node.symbol) << '"';
+            return;
+        case NhykNodeKind::NAME:
+            out << nameOf(names, node.symbol);
+            return;
+        case NhykNodeKind::LIST:
+        case NhykNodeKind::SET:
+            out << (node.kind == NhykNodeKind::LIST ? "(LIST" : "(SET");
+            for (uint32_t child : list(id)) operand(child);
+            break;
+        case NhykNodeKind::UNARY:
+            out << '(' << nhykOpText(node.op);
+            operand(node.a);
+            break;
+        case NhykNodeKind::BINARY:
+            out << '(' << nhykOpText(node.op);
+            operand(node.a);
+            operand(node.b);
+            break;
+        case NhykNodeKind::CALL:
+            out << "(CALL " << nameOf(names, node.symbol);
+            for (uint32_t child : list(id)) operand(child);
+            break;
+        case NhykNodeKind::ERROR:
+            out << "(ERROR";
+            break;
+    }
+    out << ')';
+}
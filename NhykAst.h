@@ -0,0 +1,162 @@
+#ifndef NHYKAST_H_INCLUDED
+#define NHYKAST_H_INCLUDED
+
+/**
+ * @file NhykAst.h
+ * @brief Defines NhykAst, the syntax tree NhykParser builds from a TokenBuffer.
+ *
+ * Nodes are fixed 24-byte records in one array and refer to each other by 32-bit index
+ * (their id), never by pointer. Adding a node appends to the array, which is reserved
+ * from the token count before parsing, so building a tree costs no allocation per node
+ * and the array keeps its capacity across parses. The children of nodes with a variable
+ * number of them (statements of a block, arguments of a call, ...) are stored as a run
+ * of ids in a second array, and the values of numeric literals in a third; a node holds
+ * the position and length of its run, or the index of its value.
+ *
+ * Names and string contents are symbol ids of the NhykSymbolTable the parser was given,
+ * so the tree holds no text. Each node also records the index of the token it was parsed
+ * from (its keyword, its operator, or the literal or name itself) for error locations.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Keywords.h"
+#include "NhykSymbols.h"
+
+// Which fields a node uses is listed per kind. 'list' means the run of ids at
+// (b: first, c: count), read with NhykAst::list().
+enum class NhykNodeKind : uint8_t {
+    // Statements
+    PROGRAM,        // symbol: name; list: statements
+    BLOCK,          // list: statements ({ ... } or BEGIN ... END)
+    VAR,            // list: DECL nodes
+    DECL,           // symbol: name; type: declared type or NONE; a: initial value or NO_NODE
+    FUNC,           // symbol: name; a: body; list: PARAM nodes
+    PARAM,          // symbol: name; type: declared type or NONE
+    ASSIGN,         // symbol: target; a: value
+    IF,             // a: condition; b: THEN branch; c: ELSE branch (an IF for ELIF) or NO_NODE
+    WHILE,          // a: condition; b: body
+    FOR,            // symbol: loop variable; a: first value; b: last value; c: body
+    MATCH,          // a: subject; list: CASE nodes
+    CASE,           // a: value, or NO_NODE for DEFAULT; list: statements
+    OUTPUT,         // list: values
+    INPUT,          // symbol: target
+    RETURN,         // a: value or NO_NODE
+    EXPRESSION,     // a: an expression evaluated for its effect (a call)
+    // Expressions
+    INT,            // a: index of the value, NhykAst::getInt()
+    DOUBLE,         // a: index of the value, NhykAst::getDouble()
+    BOOL,           // a: 1 for TRUE, 0 for FALSE
+    STRING,         // symbol: contents, without the quotes
+    NAME,           // symbol: the name
+    LIST,           // list: elements
+    SET,            // list: constant elements; a LIST after IS IN or IS NOT IN, made by NhykOptimizer
+    UNARY,          // op; a: operand
+    BINARY,         // op; a: left operand; b: right operand
+    CALL,           // symbol: function name; list: arguments
+    ERROR           // Stands in for a construct that failed to parse.
+};
+
+enum class NhykOp : uint8_t {
+    NONE,
+    ADD, SUB, MUL, DIV,
+    EQ, NE, LT, LE, GT, GE,
+    AND,
+    IN,             // x IS IN list
+    NOT_IN,         // x IS NOT IN list
+    NEG,            // Unary minus.
+    NOT
+};
+
+// Spelling of an operator as written in Nhyk ("+", "IS NOT IN", ...).
+const char* nhykOpText(NhykOp op);
+
+struct NhykNode {
+    NhykNodeKind kind;
+    NhykOp op;
+    KeywordKind type;
+    uint8_t reserved;
+    uint32_t token;                    // Index of its token (the token count at the end of input).
+    uint32_t symbol;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+static_assert(sizeof(NhykNode) == 24, "NhykNode is meant to stay 24 bytes");
+
+// A run of node ids, as returned by NhykAst::list().
+struct NhykNodeList {
+    const uint32_t* first;
+    uint32_t count;
+
+    const uint32_t* begin() const {return first;}
+    const uint32_t* end() const {return first + count;}
+    uint32_t size() const {return count;}
+    bool empty() const {return count == 0;}
+    uint32_t operator[](uint32_t i) const {return first[i];}
+};
+
+class NhykAst {
+public:
+    static constexpr uint32_t NO_NODE = 0xFFFFFFFF;
+
+    NhykAst();
+
+    // Drops every node, list and value, keeping the memory for the next tree.
+    void clear();
+    // Makes room for the tree of about 'tokens' tokens.
+    void reserve(size_t tokens);
+
+    // Appends a node of 'kind' parsed from token 'token'; every other field is NONE,
+    // NO_SYMBOL or NO_NODE, and its list is empty. References to nodes are invalidated
+    // by add(); ids are not.
+    uint32_t add(NhykNodeKind kind, uint32_t token);
+    NhykNode& operator[](uint32_t id) {return nodes[id];}
+    const NhykNode& operator[](uint32_t id) const {return nodes[id];}
+    size_t size() const {return nodes.size();}
+
+    uint32_t getRoot() const {return root;}
+    void setRoot(uint32_t id) {root = id;}
+
+    // Stores ids[0, count) as the list of node 'id'.
+    void setList(uint32_t id, const uint32_t* ids, size_t count);
+    NhykNodeList list(uint32_t id) const {
+        const NhykNode& node = nodes[id];
+        return NhykNodeList{lists.data() + node.b, node.c};
+    }
+
+    // Numeric literal values, referred to by INT and DOUBLE nodes.
+    uint32_t addInt(int64_t value);
+    uint32_t addDouble(double value);
+    int64_t getInt(uint32_t id) const {return numbers[nodes[id].a].integer;}
+    double getDouble(uint32_t id) const {return numbers[nodes[id].a].real;}
+
+    // Bytes held by the node, list and value arrays.
+    size_t memoryUsage() const;
+
+    // Writes the tree as indented S-expressions, one statement per line, with names
+    // and strings looked up in 'names'.
+    void print(std::ostream& out, const NhykSymbolTable& names) const;
+
+private:
+    union Number {
+        int64_t integer;
+        double real;
+    };
+
+    std::vector<NhykNode> nodes;
+    std::vector<uint32_t> lists;
+    std::vector<Number> numbers;
+    uint32_t root;
+
+    void printNode(std::ostream& out, const NhykSymbolTable& names, uint32_t id, int depth) const;
+};
+
+#endif // NHYKAST_H_INCLUDED
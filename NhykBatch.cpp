@@ -0,0 +1,165 @@
+#include "NhykBatch.h"
+#include "NhykSource.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+/**
+ * @file NhykBatch.cpp
+ * @brief Implementation of the work-stealing pool and the batch lexer.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+// --- NhykWorkStealingPool Implementation ---
+
+NhykWorkStealingPool::NhykWorkStealingPool(unsigned int threads)
+    : threadCount(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+    for (unsigned int i = 0; i < threadCount; ++i) queues.emplace_back(new WorkQueue());
+}
+
+bool NhykWorkStealingPool::take(unsigned int worker, size_t& item) {
+    {
+        WorkQueue& own = *queues[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.items.empty()) {
+            item = own.items.back();
+            own.items.pop_back();
+            return true;
+        }
+    }
+    // Steal the oldest item of the next non-empty queue.
+    for (unsigned int offset = 1; offset < threadCount; ++offset) {
+        WorkQueue& victim = *queues[(worker + offset) % threadCount];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.items.empty()) {
+            item = victim.items.front();
+            victim.items.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Runs 'task' over [0, count) on the pool's workers.
+ *
+ * @details No task adds work, so a worker that finds its own queue and every other
+ * queue empty can stop: all remaining items are already being processed.
+ */
+void NhykWorkStealingPool::run(size_t count, const std::function<void(unsigned int, size_t)>& task) {
+    // Deal in reverse so that each worker pops its items back in the given order.
+    for (size_t item = count; item-- > 0;)
+        queues[item % threadCount]->items.push_back(item);
+
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+    for (unsigned int worker = 0; worker < threadCount; ++worker) {
+        workers.emplace_back([this, worker, &task]() {
+            size_t item;
+            while (take(worker, item)) task(worker, item);
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+}
+
+// --- NhykBatchLexer Implementation ---
+
+NhykBatchLexer::NhykBatchLexer(unsigned int threads) : pool(threads) {}
+
+void NhykBatchLexer::addFile(const std::string& path) {
+    files.push_back(path);
+}
+
+void NhykBatchLexer::addDirectory(const std::string& directory, const std::string& extension) {
+    namespace fs = std::filesystem;
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(directory)) {
+        if (!entry.is_regular_file()) continue;
+        if (!extension.empty() && entry.path().extension() != extension) continue;
+        files.push_back(entry.path().string());
+    }
+}
+
+/**
+ * @brief Lexes every added file on the work-stealing pool.
+ *
+ * @details Files are handed out largest first, so the long jobs start early and the small
+ * ones fill in the gaps at the end. Each worker owns one NhykLexer for the whole batch and
+ * points it at each mapped file in turn. Statistics are kept per worker and summed at the
+ * end, so workers share no counters.
+ *
+ * @param sink Receives each file's result and tokens on the worker that lexed it.
+ * @return Totals over all files.
+ */
+NhykBatchStats NhykBatchLexer::run(const Sink& sink) {
+    auto began = std::chrono::steady_clock::now();
+
+    std::vector<std::pair<uintmax_t, size_t>> order;
+    order.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::error_code ignored;
+        uintmax_t size = std::filesystem::file_size(files[i], ignored);
+        order.emplace_back(ignored ? 0 : size, i);
+    }
+    std::sort(order.begin(), order.end(), [](const std::pair<uintmax_t, size_t>& a, const std::pair<uintmax_t, size_t>& b) {
+        return a.first > b.first;
+    });
+
+    const unsigned int threads = pool.getThreadCount();
+    std::vector<std::unique_ptr<NhykLexer>> lexers;
+    std::vector<NhykBatchStats> partial(threads);
+    for (unsigned int i = 0; i < threads; ++i) {
+        lexers.emplace_back(new NhykLexer(std::string()));
+        // A worker's table would gather every name of every file it lexes, and the sink
+        // has no way to read it, so batch tokens are not interned.
+        lexers.back()->setSymbolTable(nullptr);
+    }
+
+    pool.run(order.size(), [&](unsigned int worker, size_t item) {
+        NhykLexer& lexer = *lexers[worker];
+        NhykBatchStats& stats = partial[worker];
+        NhykFileResult result;
+        result.path = files[order[item].second];
+        try {
+            NhykMappedFile file(result.path);
+            lexer.setSourceView(file.view());
+            lexer.tokenize();
+            result.bytes = file.view().size();
+            result.tokens = lexer.getTokens().size();
+            result.errors = lexer.getDiagnostics().count();
+            for (const Token& token : lexer.getTokens())
+                ++stats.tokensByType[static_cast<int>(token.getType())];
+            if (sink) sink(result, lexer.getTokens());
+            // The tokens view the mapping, which is about to go away.
+            lexer.setSourceView(std::string_view());
+        } catch (const std::exception& error) {
+            result.ok = false;
+            result.error = error.what();
+            lexer.setSourceView(std::string_view());
+            if (sink) sink(result, std::vector<Token>());
+        }
+        ++stats.files;
+        if (!result.ok) ++stats.failedFiles;
+        stats.bytes += result.bytes;
+        stats.tokens += result.tokens;
+        stats.errors += result.errors;
+    });
+
+    NhykBatchStats total;
+    for (const NhykBatchStats& stats : partial) {
+        total.files += stats.files;
+        total.failedFiles += stats.failedFiles;
+        total.bytes += stats.bytes;
+        total.tokens += stats.tokens;
+        total.errors += stats.errors;
+        for (size_t t = 0; t < sizeof(total.tokensByType) / sizeof(total.tokensByType[0]); ++t)
+            total.tokensByType[t] += stats.tokensByType[t];
+    }
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+    return total;
+}
@@ -0,0 +1,100 @@
+#ifndef NHYKBATCH_H_INCLUDED
+#define NHYKBATCH_H_INCLUDED
+
+/**
+ * @file NhykBatch.h
+ * @brief Defines the batch lexing service: many files lexed concurrently.
+ *
+ * NhykWorkStealingPool runs a fixed set of tasks on worker threads that each own a
+ * deque of work: a worker takes tasks from the back of its own deque and, when that is
+ * empty, steals from the front of another worker's. NhykBatchLexer uses it to lex a
+ * list of files, giving every worker a single NhykLexer that is reused for all the
+ * files it handles. The DFA is a compile-time table shared by every lexer, so what the
+ * reuse saves is the lexer's own storage: its token vector and diagnostics keep their
+ * capacity from one file to the next instead of being allocated again for each.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "LexGraph.h"
+
+class NhykWorkStealingPool {
+public:
+    // 'threads' = 0 uses std::thread::hardware_concurrency().
+    explicit NhykWorkStealingPool(unsigned int threads = 0);
+
+    unsigned int getThreadCount() const {return threadCount;}
+
+    // Runs task(worker, item) for every item in [0, count) and returns when all are done.
+    // Items are dealt out round-robin in the given order; idle workers steal the rest.
+    void run(size_t count, const std::function<void(unsigned int worker, size_t item)>& task);
+
+private:
+    struct WorkQueue {
+        std::mutex lock;
+        std::deque<size_t> items;
+    };
+
+    // Next item for 'worker': its own newest item, else the oldest item of a victim.
+    bool take(unsigned int worker, size_t& item);
+
+    unsigned int threadCount;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+};
+
+// Outcome of lexing one file.
+struct NhykFileResult {
+    std::string path;
+    uint64_t bytes = 0;
+    uint64_t tokens = 0;
+    uint64_t errors = 0;               // Lexical errors found, including any past the limit.
+    bool ok = true;
+    std::string error;                 // Why the file could not be lexed, when !ok.
+};
+
+// Totals over a batch.
+struct NhykBatchStats {
+    uint64_t files = 0;
+    uint64_t failedFiles = 0;
+    uint64_t bytes = 0;
+    uint64_t tokens = 0;
+    uint64_t errors = 0;
+    uint64_t tokensByType[static_cast<int>(TokenType::END_OF_INPUT) + 1] = {};
+    double seconds = 0;
+};
+
+class NhykBatchLexer {
+public:
+    // Called on a worker thread once per file; 'tokens' view the mapped file and are only
+    // valid during the call. Must be safe to call from several threads at once. Tokens
+    // are not interned: every symbol is Token::NO_SYMBOL.
+    typedef std::function<void(const NhykFileResult& result, const std::vector<Token>& tokens)> Sink;
+
+    explicit NhykBatchLexer(unsigned int threads = 0);
+
+    void addFile(const std::string& path);
+    // Adds every regular file under 'directory' (recursively) whose extension is
+    // 'extension'; an empty extension accepts all files.
+    void addDirectory(const std::string& directory, const std::string& extension = ".nhyk");
+    const std::vector<std::string>& getFiles() const {return files;}
+
+    // Lexes all added files, passing each to 'sink' if one is given.
+    NhykBatchStats run(const Sink& sink = Sink());
+
+private:
+    NhykWorkStealingPool pool;
+    std::vector<std::string> files;
+};
+
+#endif // NHYKBATCH_H_INCLUDED
@@ -0,0 +1,212 @@
+#include "NhykBytecode.h"
+#include <charconv>
+#include <cstdio>
+#include <string>
+/**
+ * @file NhykBytecode.cpp
+ * @brief Implementation of the bytecode names, value formatting and program listing.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+const char* nhykTypeName(NhykType type) {
+    switch (type) {
+        case NhykType::NONE:    return "NONE";
+        case NhykType::INTEGER: return "INTEGER";
+        case NhykType::DOUBLE:  return "DOUBLE";
+        case NhykType::STRING:  return "STRING";
+        case NhykType::BOOL:    return "BOOL";
+        case NhykType::LIST:    return "LIST";
+    }
+    return "NONE";
+}
+
+const char* nhykOpcodeName(NhykOpcode op) {
+    static const char* const names[] = {
+#define NHYK_OPCODE_NAME(name) #name,
+        NHYK_OPCODES(NHYK_OPCODE_NAME)
+#undef NHYK_OPCODE_NAME
+    };
+    size_t index = static_cast<size_t>(op);
+    return index < sizeof(names) / sizeof(names[0]) ? names[index] : "?";
+}
+
+void nhykWriteValue(std::string& out, const NhykValue& value, const NhykSymbolTable& names,
+                    const std::vector<NhykListRange>& lists, const std::vector<NhykValue>& items) {
+    char text[32];
+    switch (value.type) {
+        case NhykType::NONE:
+            out += "NONE";
+            break;
+        case NhykType::INTEGER:
+            out.append(text, std::to_chars(text, text + sizeof(text), value.integer).ptr);
+            break;
+        case NhykType::DOUBLE: {
+            // Whole numbers keep a ".0" so they read back as DOUBLE.
+            size_t start = out.size();
+            out.append(text, std::to_chars(text, text + sizeof(text), value.real).ptr);
+            if (out.find_first_of(".en", start) == std::string::npos) out += ".0";
+            break;
+        }
+        case NhykType::STRING:
+            out += names.name(value.symbol);
+            break;
+        case NhykType::BOOL:
+            out += value.boolean ? "TRUE" : "FALSE";
+            break;
+        case NhykType::LIST: {
+            const NhykListRange& range = lists[value.list];
+            out += '[';
+            for (uint32_t i = 0; i < range.count; ++i) {
+                if (i != 0) out += ", ";
+                const NhykValue& item = items[range.first + i];
+                if (item.type == NhykType::STRING) out += '"';
+                nhykWriteValue(out, item, names, lists, items);
+                if (item.type == NhykType::STRING) out += '"';
+            }
+            out += ']';
+            break;
+        }
+    }
+}
+
+// --- NhykProgram Implementation ---
+
+void NhykProgram::clear() {
+    code.clear();
+    spans.clear();
+    constants.clear();
+    functions.clear();
+    lists.clear();
+    listItems.clear();
+    sets.clear();
+    setSlots.clear();
+    globals = 0;
+    source = std::string_view();
+}
+
+namespace {
+
+// Which operands of an instruction are used, and what they name.
+enum class Operand : uint8_t {UNUSED, REGISTER, CONSTANT, GLOBAL, TARGET, FUNCTION, SET, COUNT};
+
+struct Layout {
+    Operand b;
+    Operand c;
+};
+
+Layout layoutOf(NhykOpcode op) {
+    switch (op) {
+        case NhykOpcode::MOVE: case NhykOpcode::NEG: case NhykOpcode::NOT:
+            return {Operand::REGISTER, Operand::UNUSED};
+        case NhykOpcode::LOADK:
+            return {Operand::CONSTANT, Operand::UNUSED};
+        case NhykOpcode::GETG: case NhykOpcode::SETG:
+            return {Operand::GLOBAL, Operand::UNUSED};
+        case NhykOpcode::ADDK: case NhykOpcode::SUBK: case NhykOpcode::MULK: case NhykOpcode::DIVK:
+        case NhykOpcode::EQK: case NhykOpcode::NEK: case NhykOpcode::LTK: case NhykOpcode::LEK:
+        case NhykOpcode::GTK: case NhykOpcode::GEK: case NhykOpcode::INK: case NhykOpcode::NOTINK:
+            return {Operand::REGISTER, Operand::CONSTANT};
+        case NhykOpcode::INSET: case NhykOpcode::NOTINSET:
+            return {Operand::REGISTER, Operand::SET};
+        case NhykOpcode::MAKELIST:
+            return {Operand::REGISTER, Operand::COUNT};
+        case NhykOpcode::JMP: case NhykOpcode::JMPF: case NhykOpcode::JMPT:
+            return {Operand::TARGET, Operand::UNUSED};
+        case NhykOpcode::FORPREP: case NhykOpcode::FORLOOP:
+            return {Operand::REGISTER, Operand::TARGET};
+        case NhykOpcode::CALL:
+            return {Operand::FUNCTION, Operand::COUNT};
+        case NhykOpcode::OUTPUT:
+            return {Operand::COUNT, Operand::UNUSED};
+        case NhykOpcode::RET: case NhykOpcode::RET0: case NhykOpcode::INPUT: case NhykOpcode::HALT:
+            return {Operand::UNUSED, Operand::UNUSED};
+        default:
+            return {Operand::REGISTER, Operand::REGISTER};
+    }
+}
+
+bool usesA(NhykOpcode op) {
+    return op != NhykOpcode::JMP && op != NhykOpcode::RET0 && op != NhykOpcode::HALT;
+}
+
+} // namespace
+
+/**
+ * @brief Writes each function's instructions, one per line.
+ *
+ * @details Lines read "  0012  ADDK      r3, r3, k1 (1)": the instruction index, the
+ * mnemonic, then the operands as registers (r), constants (k, followed by the value),
+ * globals (g), targets (@), functions (by name), sets (s, followed by their values) or
+ * plain counts.
+ */
+void NhykProgram::print(std::ostream& out, const NhykSymbolTable& names) const {
+    std::string line;
+    for (size_t f = 0; f < functions.size(); ++f) {
+        const NhykFunction& function = functions[f];
+        uint32_t end = f + 1 < functions.size() ? functions[f + 1].entry : static_cast<uint32_t>(code.size());
+        line = function.name == NhykSymbolTable::NO_SYMBOL ? std::string("main") : std::string(names.name(function.name));
+        line += " (" + std::to_string(function.params) + " params, " + std::to_string(function.registers) + " registers)\n";
+        out << line;
+
+        for (uint32_t pc = function.entry; pc < end; ++pc) {
+            const NhykInstruction& instruction = code[pc];
+            char head[32];
+            std::snprintf(head, sizeof(head), "  %04u  %-9s", pc, nhykOpcodeName(instruction.op));
+            line = head;
+            bool first = true;
+            auto operand = [&](Operand kind, uint32_t value) {
+                if (kind == Operand::UNUSED) return;
+                line += first ? "" : ", ";
+                first = false;
+                switch (kind) {
+                    case Operand::REGISTER: line += 'r' + std::to_string(value); break;
+                    case Operand::GLOBAL:   line += 'g' + std::to_string(value); break;
+                    case Operand::TARGET:   line += '@' + std::to_string(value); break;
+                    case Operand::COUNT:    line += std::to_string(value); break;
+                    case Operand::FUNCTION: {
+                        uint32_t name = functions[value].name;
+                        line += name == NhykSymbolTable::NO_SYMBOL ? std::string("main") : std::string(names.name(name));
+                        break;
+                    }
+                    case Operand::CONSTANT: {
+                        const NhykValue& constant = constants[value];
+                        line += 'k' + std::to_string(value) + " (";
+                        if (constant.type == NhykType::STRING) line += '"';
+                        nhykWriteValue(line, constant, names, lists, listItems);
+                        if (constant.type == NhykType::STRING) line += '"';
+                        line += ')';
+                        break;
+                    }
+                    case Operand::SET: {
+                        const NhykSetRange& set = sets[value];
+                        line += 's' + std::to_string(value) + " {";
+                        bool firstValue = true;
+                        for (uint32_t slot = set.first; slot <= set.first + set.mask; ++slot) {
+                            const NhykValue& member = setSlots[slot];
+                            if (member.type == NhykType::NONE) continue;
+                            line += firstValue ? "" : ", ";
+                            firstValue = false;
+                            if (member.type == NhykType::STRING) line += '"';
+                            nhykWriteValue(line, member, names, lists, listItems);
+                            if (member.type == NhykType::STRING) line += '"';
+                        }
+                        line += '}';
+                        break;
+                    }
+                    case Operand::UNUSED: break;
+                }
+            };
+            Layout layout = layoutOf(instruction.op);
+            if (usesA(instruction.op)) operand(Operand::REGISTER, instruction.a);
+            operand(layout.b, instruction.b);
+            operand(layout.c, instruction.c);
+            line += '\n';
+            out << line;
+        }
+    }
+}
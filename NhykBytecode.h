@@ -0,0 +1,232 @@
+#ifndef NHYKBYTECODE_H_INCLUDED
+#define NHYKBYTECODE_H_INCLUDED
+
+/**
+ * @file NhykBytecode.h
+ * @brief Defines the register bytecode that NhykCompiler produces and NhykVM runs.
+ *
+ * Every function works on a frame of registers, numbered from 0: its parameters first,
+ * then its other variables, then temporaries. An instruction names its operands by
+ * register (R), constant (K) or global (G) number, so "count = count - 1" is the single
+ * instruction SUBK r_count, r_count, k_1. The main program's variables are the globals,
+ * which are also the registers of its own frame.
+ *
+ * Values are 16 bytes: a type tag and an integer, a double, a boolean, a symbol id or
+ * a list id. String constants are symbol ids of the program's NhykSymbolTable, so
+ * equality between them is one comparison. Strings made while the program runs (by
+ * concatenation or INPUT) are not interned: their ids have NHYK_HEAP_STRING set and
+ * index the VM's own storage, which lasts one run. Lists are immutable runs of values;
+ * the program's constant lists come first.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "NhykSymbols.h"
+
+enum class NhykType : uint8_t {
+    NONE,                              // A declared variable that was never given a value.
+    INTEGER,
+    DOUBLE,
+    STRING,
+    BOOL,
+    LIST
+};
+
+// Name of a type as written in Nhyk ("INTEGER", ...; "NONE" and "LIST" for the others).
+const char* nhykTypeName(NhykType type);
+
+struct NhykValue {
+    NhykType type;
+    union {
+        int64_t integer;
+        double real;
+        uint32_t symbol;               // STRING
+        uint32_t list;                 // LIST: index into the list table
+        bool boolean;
+    };
+
+    static NhykValue none() {NhykValue v; v.type = NhykType::NONE; v.integer = 0; return v;}
+    static NhykValue ofInt(int64_t i) {NhykValue v; v.type = NhykType::INTEGER; v.integer = i; return v;}
+    static NhykValue ofDouble(double d) {NhykValue v; v.type = NhykType::DOUBLE; v.real = d; return v;}
+    static NhykValue ofString(uint32_t s) {NhykValue v; v.type = NhykType::STRING; v.integer = 0; v.symbol = s; return v;}
+    static NhykValue ofBool(bool b) {NhykValue v; v.type = NhykType::BOOL; v.integer = 0; v.boolean = b; return v;}
+    static NhykValue ofList(uint32_t l) {NhykValue v; v.type = NhykType::LIST; v.integer = 0; v.list = l; return v;}
+};
+static_assert(sizeof(NhykValue) == 16, "NhykValue is meant to stay 16 bytes");
+
+// A list's values: items[first, first + count) of the table it belongs to.
+struct NhykListRange {
+    uint32_t first;
+    uint32_t count;
+};
+
+// Marks the id of a STRING made at run time; symbol table ids stay below it.
+constexpr uint32_t NHYK_HEAP_STRING = 0x80000000u;
+
+// The VM's equality for anything but two LISTs or a string made at run time: equal
+// numbers of either type, or equal values of the same type.
+inline bool nhykScalarEqual(const NhykValue& a, const NhykValue& b) {
+    if (a.type != b.type) {
+        bool numbers = (a.type == NhykType::INTEGER || a.type == NhykType::DOUBLE)
+                    && (b.type == NhykType::INTEGER || b.type == NhykType::DOUBLE);
+        if (!numbers) return false;
+        double x = a.type == NhykType::INTEGER ? static_cast<double>(a.integer) : a.real;
+        double y = b.type == NhykType::INTEGER ? static_cast<double>(b.integer) : b.real;
+        return x == y;
+    }
+    switch (a.type) {
+        case NhykType::INTEGER: return a.integer == b.integer;
+        case NhykType::DOUBLE:  return a.real == b.real;
+        case NhykType::STRING:  return a.symbol == b.symbol;
+        case NhykType::BOOL:    return a.boolean == b.boolean;
+        case NhykType::LIST:    return a.list == b.list;
+        default:                return true;
+    }
+}
+
+// An open-addressing hash set of constants: slots[first, first + mask + 1) of the
+// program's setSlots, with NONE in the free slots. Built by NhykCompiler for the SET
+// nodes NhykOptimizer makes; at least one slot is always free.
+struct NhykSetRange {
+    uint32_t first;
+    uint32_t mask;
+};
+
+// Hash of an INTEGER, DOUBLE, STRING or BOOL value that agrees with the VM's equality:
+// numbers hash by their DOUBLE value, so 2 and 2.0 land in the same slot.
+inline uint64_t nhykHashValue(const NhykValue& value) {
+    uint64_t bits = 0;
+    switch (value.type) {
+        case NhykType::INTEGER:
+        case NhykType::DOUBLE: {
+            double real = value.type == NhykType::INTEGER ? static_cast<double>(value.integer) : value.real;
+            if (real >= -9.2e18 && real <= 9.2e18 && real == static_cast<double>(static_cast<int64_t>(real)))
+                bits = static_cast<uint64_t>(static_cast<int64_t>(real));
+            else
+                std::memcpy(&bits, &real, sizeof(bits));
+            break;
+        }
+        case NhykType::STRING: bits = value.symbol ^ 0x5354520000000000ull; break;
+        case NhykType::BOOL:   bits = static_cast<uint64_t>(value.boolean) ^ 0x424F4F4C00000000ull; break;
+        default:               break;
+    }
+    bits *= 0x9E3779B97F4A7C15ull;
+    return bits ^ (bits >> 29);
+}
+
+// Source text an instruction was compiled from, for runtime error messages.
+struct NhykSpan {
+    uint32_t offset;
+    uint32_t length;
+};
+
+// Opcodes with their operands: R[x] is register x of the current frame, K[x] constant
+// x, G[x] global x, and "target" an instruction index.
+#define NHYK_OPCODES(X) \
+    X(MOVE)     /* R[a] = R[b] */                                           \
+    X(LOADK)    /* R[a] = K[b] */                                           \
+    X(GETG)     /* R[a] = G[b] */                                           \
+    X(SETG)     /* G[b] = R[a] */                                           \
+    X(ADD)      /* R[a] = R[b] + R[c]  (numbers; STRING + STRING joins) */  \
+    X(SUB)      /* R[a] = R[b] - R[c] */                                    \
+    X(MUL)      /* R[a] = R[b] * R[c] */                                    \
+    X(DIV)      /* R[a] = R[b] / R[c]  (INTEGER / INTEGER truncates) */     \
+    X(ADDK)     /* R[a] = R[b] + K[c], and so on */                         \
+    X(SUBK)                                                                 \
+    X(MULK)                                                                 \
+    X(DIVK)                                                                 \
+    X(EQ)       /* R[a] = R[b] == R[c] */                                   \
+    X(NE)                                                                   \
+    X(LT)                                                                   \
+    X(LE)                                                                   \
+    X(GT)                                                                   \
+    X(GE)                                                                   \
+    X(EQK)      /* R[a] = R[b] == K[c], and so on */                        \
+    X(NEK)                                                                  \
+    X(LTK)                                                                  \
+    X(LEK)                                                                  \
+    X(GTK)                                                                  \
+    X(GEK)                                                                  \
+    X(NEG)      /* R[a] = -R[b] */                                          \
+    X(NOT)      /* R[a] = NOT R[b] */                                       \
+    X(IN)       /* R[a] = R[b] IS IN R[c] */                                \
+    X(NOTIN)    /* R[a] = R[b] IS NOT IN R[c] */                            \
+    X(INK)      /* R[a] = R[b] IS IN K[c] */                                \
+    X(NOTINK)   /* R[a] = R[b] IS NOT IN K[c] */                            \
+    X(INSET)    /* R[a] = R[b] IS IN set c */                               \
+    X(NOTINSET) /* R[a] = R[b] IS NOT IN set c */                           \
+    X(MAKELIST) /* R[a] = [R[b], ..., R[b + c - 1]] */                      \
+    X(JMP)      /* go to target b */                                        \
+    X(JMPF)     /* if R[a] is FALSE go to target b */                       \
+    X(JMPT)     /* if R[a] is TRUE go to target b */                        \
+    X(FORPREP)  /* if R[a] > R[b] go to target c */                         \
+    X(FORLOOP)  /* R[a] += 1; if R[a] <= R[b] go to target c */             \
+    X(CALL)     /* R[a] = function b (R[a], ..., R[a + c - 1]) */           \
+    X(RET)      /* return R[a] */                                           \
+    X(RET0)     /* return with no value */                                  \
+    X(OUTPUT)   /* write R[a], ..., R[a + b - 1] and a newline */           \
+    X(INPUT)    /* R[a] = the next word of input */                         \
+    X(HALT)     /* end of the main program */
+
+enum class NhykOpcode : uint8_t {
+#define NHYK_OPCODE_ENUM(name) name,
+    NHYK_OPCODES(NHYK_OPCODE_ENUM)
+#undef NHYK_OPCODE_ENUM
+};
+
+// Mnemonic of an opcode ("ADDK", ...).
+const char* nhykOpcodeName(NhykOpcode op);
+
+struct NhykInstruction {
+    NhykOpcode op;
+    uint8_t reserved;
+    uint16_t a;                        // Always a register.
+    uint32_t b;
+    uint32_t c;
+};
+static_assert(sizeof(NhykInstruction) == 12, "NhykInstruction is meant to stay 12 bytes");
+
+struct NhykFunction {
+    uint32_t name;                     // Symbol id; NO_SYMBOL for the main program.
+    uint32_t params;
+    uint32_t registers;                // Frame size: parameters, variables and temporaries.
+    uint32_t entry;                    // Index of its first instruction.
+};
+
+/*
+*   A compiled program. functions[0] is the main program; the code of every function
+*   is in 'code', and spans[i] is the token instruction i was compiled from (its
+*   operator, keyword or name). Symbol ids refer to the table the
+*   program was compiled with, which the VM must be given as well.
+*/
+struct NhykProgram {
+    std::vector<NhykInstruction> code;
+    std::vector<NhykSpan> spans;
+    std::vector<NhykValue> constants;
+    std::vector<NhykFunction> functions;
+    std::vector<NhykListRange> lists;  // Constant lists, referred to by LIST constants.
+    std::vector<NhykValue> listItems;
+    std::vector<NhykSetRange> sets;    // Hashed constant sets, referred to by INSET and NOTINSET.
+    std::vector<NhykValue> setSlots;
+    uint32_t globals = 0;
+    std::string_view source;           // The text the program was compiled from.
+
+    void clear();
+    // Writes a listing of every function's instructions.
+    void print(std::ostream& out, const NhykSymbolTable& names) const;
+};
+
+// Writes 'value' as OUTPUT shows it; 'lists' and 'items' hold the LIST values.
+void nhykWriteValue(std::string& out, const NhykValue& value, const NhykSymbolTable& names,
+                    const std::vector<NhykListRange>& lists, const std::vector<NhykValue>& items);
+
+#endif // NHYKBYTECODE_H_INCLUDED
@@ -0,0 +1,753 @@
+#include "NhykCompiler.h"
+#include <cstring>
+/**
+ * @file NhykCompiler.cpp
+ * @brief Implementation of the syntax tree to bytecode compiler.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+// The register-register form of a binary operator; the K form is its own opcode.
+NhykOpcode registerForm(NhykOp op) {
+    switch (op) {
+        case NhykOp::ADD:    return NhykOpcode::ADD;
+        case NhykOp::SUB:    return NhykOpcode::SUB;
+        case NhykOp::MUL:    return NhykOpcode::MUL;
+        case NhykOp::DIV:    return NhykOpcode::DIV;
+        case NhykOp::EQ:     return NhykOpcode::EQ;
+        case NhykOp::NE:     return NhykOpcode::NE;
+        case NhykOp::LT:     return NhykOpcode::LT;
+        case NhykOp::LE:     return NhykOpcode::LE;
+        case NhykOp::GT:     return NhykOpcode::GT;
+        case NhykOp::GE:     return NhykOpcode::GE;
+        case NhykOp::NOT_IN: return NhykOpcode::NOTIN;
+        default:             return NhykOpcode::IN;
+    }
+}
+
+NhykOpcode constantForm(NhykOp op) {
+    switch (op) {
+        case NhykOp::ADD:    return NhykOpcode::ADDK;
+        case NhykOp::SUB:    return NhykOpcode::SUBK;
+        case NhykOp::MUL:    return NhykOpcode::MULK;
+        case NhykOp::DIV:    return NhykOpcode::DIVK;
+        case NhykOp::EQ:     return NhykOpcode::EQK;
+        case NhykOp::NE:     return NhykOpcode::NEK;
+        case NhykOp::LT:     return NhykOpcode::LTK;
+        case NhykOp::LE:     return NhykOpcode::LEK;
+        case NhykOp::GT:     return NhykOpcode::GTK;
+        case NhykOp::GE:     return NhykOpcode::GEK;
+        case NhykOp::NOT_IN: return NhykOpcode::NOTINK;
+        default:             return NhykOpcode::INK;
+    }
+}
+
+// The operator that gives the same result with its operands swapped, or NONE.
+NhykOp swapped(NhykOp op) {
+    switch (op) {
+        case NhykOp::MUL: case NhykOp::EQ: case NhykOp::NE: return op;
+        case NhykOp::LT: return NhykOp::GT;
+        case NhykOp::LE: return NhykOp::GE;
+        case NhykOp::GT: return NhykOp::LT;
+        case NhykOp::GE: return NhykOp::LE;
+        default:         return NhykOp::NONE;
+    }
+}
+
+} // namespace
+
+// --- NhykCompiler Implementation ---
+
+NhykCompiler::NhykCompiler(NhykSymbolTable& table)
+    : names(table), ast(nullptr), tokens(nullptr), program(nullptr), inMain(true),
+      variables(0), top(0), maxTop(0), registersExhausted(false) {}
+
+/**
+ * @brief Compiles a whole program.
+ *
+ * @details First every FUNC is numbered, so calls may come before definitions; then the
+ * main program is compiled, its variables becoming the globals, and then each function.
+ */
+bool NhykCompiler::compile(const NhykAst& tree, const TokenBuffer& tokenBuffer, NhykProgram& out) {
+    ast = &tree;
+    tokens = &tokenBuffer;
+    program = &out;
+    source = tokenBuffer.getSource();
+    diagnostics.clear();
+    lines.clear();
+    constantIndex.clear();
+    out.clear();
+    out.source = source;
+
+    globalOf.assign(names.size(), NONE);
+    localOf.assign(names.size(), NONE);
+    functionOf.assign(names.size(), NONE);
+    bound.clear();
+    functionNodes.clear();
+
+    const uint32_t root = tree.getRoot();
+    out.functions.push_back(NhykFunction{NhykSymbolTable::NO_SYMBOL, 0, 0, 0});
+    if (root == NhykAst::NO_NODE) {
+        out.code.push_back(NhykInstruction{NhykOpcode::HALT, 0, 0, 0, 0});
+        out.spans.push_back(NhykSpan{0, 0});
+        out.functions[0].registers = 1;
+        return true;
+    }
+    collectFunctions(root);
+    assignedByFunctions.assign(names.size(), 0);
+    for (uint32_t node : functionNodes) {
+        out.functions.push_back(NhykFunction{tree[node].symbol, tree.list(node).size(), 0, 0});
+        collectAssigned(tree[node].a);
+    }
+
+    inMain = true;
+    variables = 0;
+    registersExhausted = false;
+    collectVariables(root);
+    checkFrame(variables, tree[root].token);
+    out.globals = variables;
+    top = maxTop = variables;
+    for (uint32_t child : tree.list(root)) statement(child);
+    emit(NhykOpcode::HALT, 0, 0, 0, root);
+    out.functions[0].registers = maxTop > 0 ? maxTop : 1;
+    for (uint32_t symbol : bound) localOf[symbol] = NONE;
+    bound.clear();
+
+    inMain = false;
+    for (uint32_t f = 1; f < out.functions.size(); ++f) compileFunction(f);
+    return diagnostics.empty();
+}
+
+std::vector<ErrorToken> NhykCompiler::getErrors() const {
+    if (!lines.built()) lines.build(source);
+    std::vector<ErrorToken> errors;
+    errors.reserve(diagnostics.getEntries().size());
+    for (const NhykDiagnostic& diagnostic : diagnostics.getEntries()) {
+        NhykLocation where = lines.locate(diagnostic.offset);
+        errors.push_back(ErrorToken{diagnostic.kind, diagnostic.offset, diagnostic.length,
+                                    where.line, where.column, NhykDiagnostics::message(diagnostic, source)});
+    }
+    return errors;
+}
+
+NhykSpan NhykCompiler::spanOf(uint32_t token) const {
+    if (token >= tokens->size()) return NhykSpan{static_cast<uint32_t>(source.size()), 0};
+    return NhykSpan{tokens->offset(token), tokens->length(token)};
+}
+
+void NhykCompiler::error(NhykDiagnosticKind kind, uint32_t token) {
+    NhykSpan span = spanOf(token);
+    diagnostics.report(kind, span.offset, span.length);
+}
+
+// --- Functions and variables ---
+
+// Numbers every FUNC in the tree, in source order, nested ones included.
+void NhykCompiler::collectFunctions(uint32_t id) {
+    if (id == NhykAst::NO_NODE) return;
+    const NhykNode& node = (*ast)[id];
+    switch (node.kind) {
+        case NhykNodeKind::PROGRAM: case NhykNodeKind::BLOCK: case NhykNodeKind::CASE:
+            for (uint32_t child : ast->list(id)) collectFunctions(child);
+            break;
+        case NhykNodeKind::MATCH:
+            for (uint32_t arm : ast->list(id)) collectFunctions(arm);
+            break;
+        case NhykNodeKind::FUNC:
+            if (node.symbol != NhykSymbolTable::NO_SYMBOL) {
+                if (functionOf[node.symbol] != NONE) {
+                    error(NhykDiagnosticKind::DUPLICATE_FUNCTION, node.token + 1);
+                } else {
+                    functionNodes.push_back(id);
+                    functionOf[node.symbol] = static_cast<uint32_t>(functionNodes.size());
+                }
+            }
+            collectFunctions(node.a);
+            break;
+        case NhykNodeKind::IF:
+            collectFunctions(node.b);
+            collectFunctions(node.c);
+            break;
+        case NhykNodeKind::WHILE:
+            collectFunctions(node.b);
+            break;
+        case NhykNodeKind::FOR:
+            collectFunctions(node.c);
+            break;
+        default:
+            break;
+    }
+}
+
+// Binds the names the statements under 'id' declare or assign, without entering FUNCs.
+void NhykCompiler::collectVariables(uint32_t id) {
+    if (id == NhykAst::NO_NODE) return;
+    const NhykNode& node = (*ast)[id];
+    switch (node.kind) {
+        case NhykNodeKind::PROGRAM: case NhykNodeKind::BLOCK: case NhykNodeKind::CASE:
+        case NhykNodeKind::MATCH:
+            for (uint32_t child : ast->list(id)) collectVariables(child);
+            break;
+        case NhykNodeKind::VAR:
+            for (uint32_t decl : ast->list(id)) bind((*ast)[decl].symbol, true);
+            break;
+        case NhykNodeKind::ASSIGN: case NhykNodeKind::INPUT:
+            bind(node.symbol, false);
+            break;
+        case NhykNodeKind::FOR:
+            bind(node.symbol, true);
+            collectVariables(node.c);
+            break;
+        case NhykNodeKind::IF:
+            collectVariables(node.b);
+            collectVariables(node.c);
+            break;
+        case NhykNodeKind::WHILE:
+            collectVariables(node.b);
+            break;
+        default:
+            break;
+    }
+}
+
+// Marks the names the statements under 'id' assign or INPUT, without entering FUNCs.
+void NhykCompiler::collectAssigned(uint32_t id) {
+    if (id == NhykAst::NO_NODE) return;
+    const NhykNode& node = (*ast)[id];
+    switch (node.kind) {
+        case NhykNodeKind::BLOCK: case NhykNodeKind::CASE: case NhykNodeKind::MATCH:
+            for (uint32_t child : ast->list(id)) collectAssigned(child);
+            break;
+        case NhykNodeKind::ASSIGN: case NhykNodeKind::INPUT:
+            if (node.symbol != NhykSymbolTable::NO_SYMBOL) assignedByFunctions[node.symbol] = 1;
+            break;
+        case NhykNodeKind::FOR:
+            collectAssigned(node.c);
+            break;
+        case NhykNodeKind::IF:
+            collectAssigned(node.b);
+            collectAssigned(node.c);
+            break;
+        case NhykNodeKind::WHILE:
+            collectAssigned(node.b);
+            break;
+        default:
+            break;
+    }
+}
+
+// Gives 'symbol' a register, unless it has one or, in a function, it is an assigned
+// global.
+void NhykCompiler::bind(uint32_t symbol, bool declared) {
+    if (symbol == NhykSymbolTable::NO_SYMBOL || localOf[symbol] != NONE) return;
+    if (inMain) {
+        globalOf[symbol] = variables;
+    } else if (!declared && globalOf[symbol] != NONE) {
+        return;
+    }
+    localOf[symbol] = variables++;
+    bound.push_back(symbol);
+}
+
+void NhykCompiler::checkFrame(uint32_t frameSize, uint32_t token) {
+    if (frameSize <= MAX_REGISTERS || registersExhausted) return;
+    registersExhausted = true;
+    error(NhykDiagnosticKind::TOO_MANY_REGISTERS, token);
+}
+
+void NhykCompiler::compileFunction(uint32_t index) {
+    const uint32_t id = functionNodes[index - 1];
+    const NhykNode& node = (*ast)[id];
+    // Parameters take the first registers, in order, where the caller puts the arguments.
+    NhykNodeList params = ast->list(id);
+    variables = params.size();
+    for (uint32_t i = 0; i < params.size(); ++i) {
+        uint32_t symbol = (*ast)[params[i]].symbol;
+        if (symbol == NhykSymbolTable::NO_SYMBOL) continue;
+        if (localOf[symbol] == NONE) bound.push_back(symbol);
+        localOf[symbol] = i;
+    }
+    registersExhausted = false;
+    collectVariables(node.a);
+    checkFrame(variables, node.token + 1);
+    top = maxTop = variables;
+
+    NhykFunction& function = program->functions[index];
+    function.entry = here();
+    statement(node.a);
+    emit(NhykOpcode::RET0, 0, 0, 0, id);
+    program->functions[index].registers = maxTop > 0 ? maxTop : 1;
+    for (uint32_t symbol : bound) localOf[symbol] = NONE;
+    bound.clear();
+}
+
+// --- Code ---
+
+uint32_t NhykCompiler::emit(NhykOpcode op, uint32_t a, uint32_t b, uint32_t c, uint32_t node) {
+    program->code.push_back(NhykInstruction{op, 0, static_cast<uint16_t>(a), b, c});
+    program->spans.push_back(spanOf((*ast)[node].token));
+    return here() - 1;
+}
+
+void NhykCompiler::patch(uint32_t jump, uint32_t target) {
+    NhykInstruction& instruction = program->code[jump];
+    if (instruction.op == NhykOpcode::FORPREP || instruction.op == NhykOpcode::FORLOOP) instruction.c = target;
+    else instruction.b = target;
+}
+
+// Index of 'value' in the constant pool, adding it if it is new.
+uint32_t NhykCompiler::constant(const NhykValue& value) {
+    ConstantKey key{value.type, 0};
+    std::memcpy(&key.bits, &value.integer, sizeof(key.bits));
+    if (value.type == NhykType::STRING || value.type == NhykType::LIST) key.bits = value.symbol;
+    if (value.type == NhykType::BOOL) key.bits = value.boolean;
+    auto found = constantIndex.find(key);
+    if (found != constantIndex.end()) return found->second;
+    uint32_t index = static_cast<uint32_t>(program->constants.size());
+    program->constants.push_back(value);
+    constantIndex.emplace(key, index);
+    return index;
+}
+
+bool NhykCompiler::isConstant(uint32_t node) const {
+    const NhykNode& n = (*ast)[node];
+    switch (n.kind) {
+        case NhykNodeKind::INT: case NhykNodeKind::DOUBLE: case NhykNodeKind::BOOL:
+            return true;
+        case NhykNodeKind::STRING:
+            return n.symbol != NhykSymbolTable::NO_SYMBOL;
+        case NhykNodeKind::LIST: case NhykNodeKind::SET:
+            for (uint32_t element : ast->list(node)) {
+                if (!isConstant(element)) return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Constant index of a literal, or of a list of literals (stored as a constant list).
+uint32_t NhykCompiler::constantOf(uint32_t node) {
+    const NhykNode& n = (*ast)[node];
+    switch (n.kind) {
+        case NhykNodeKind::INT:    return constant(NhykValue::ofInt(ast->getInt(node)));
+        case NhykNodeKind::DOUBLE: return constant(NhykValue::ofDouble(ast->getDouble(node)));
+        case NhykNodeKind::BOOL:   return constant(NhykValue::ofBool(n.a != 0));
+        case NhykNodeKind::STRING: return constant(NhykValue::ofString(n.symbol));
+        case NhykNodeKind::LIST: case NhykNodeKind::SET: {
+            // Each list literal is a list of its own; they are not pooled. The elements
+            // are made first, so a nested list's items do not land inside this range.
+            std::vector<NhykValue> items;
+            items.reserve(n.c);
+            for (uint32_t element : ast->list(node)) {
+                items.push_back(program->constants[constantOf(element)]);
+            }
+            NhykListRange range{static_cast<uint32_t>(program->listItems.size()), n.c};
+            program->listItems.insert(program->listItems.end(), items.begin(), items.end());
+            program->lists.push_back(range);
+            return constant(NhykValue::ofList(static_cast<uint32_t>(program->lists.size() - 1)));
+        }
+        default:
+            return constant(NhykValue::none());
+    }
+}
+
+// Index of a hash set holding the distinct values of SET node 'node', sized so it is at
+// most half full.
+uint32_t NhykCompiler::setOf(uint32_t node) {
+    NhykNodeList elements = ast->list(node);
+    uint32_t capacity = 2;
+    while (capacity < elements.size() * 2) capacity *= 2;
+    const uint32_t first = static_cast<uint32_t>(program->setSlots.size());
+    program->setSlots.resize(first + capacity, NhykValue::none());
+    NhykValue* slots = program->setSlots.data() + first;
+    for (uint32_t element : elements) {
+        const NhykValue value = program->constants[constantOf(element)];
+        uint32_t slot = static_cast<uint32_t>(nhykHashValue(value)) & (capacity - 1);
+        while (slots[slot].type != NhykType::NONE && !nhykScalarEqual(slots[slot], value)) slot = (slot + 1) & (capacity - 1);
+        slots[slot] = value;
+    }
+    program->sets.push_back(NhykSetRange{first, capacity - 1});
+    return static_cast<uint32_t>(program->sets.size() - 1);
+}
+
+uint32_t NhykCompiler::temporary(uint32_t node) {
+    if (top >= MAX_REGISTERS) {
+        checkFrame(top + 1, (*ast)[node].token);
+        return 0;
+    }
+    if (++top > maxTop) maxTop = top;
+    return top - 1;
+}
+
+// --- Statements ---
+
+void NhykCompiler::statement(uint32_t id) {
+    if (id == NhykAst::NO_NODE) return;
+    const NhykNode& node = (*ast)[id];
+    const uint32_t mark = top;
+    switch (node.kind) {
+        case NhykNodeKind::BLOCK:
+            for (uint32_t child : ast->list(id)) statement(child);
+            break;
+        case NhykNodeKind::VAR:
+            for (uint32_t decl : ast->list(id)) declare(decl);
+            break;
+        case NhykNodeKind::ASSIGN:
+            store(node.symbol, node.a, id);
+            break;
+        case NhykNodeKind::IF: {
+            // Only the branch that can run is compiled when the condition is constant.
+            const NhykNode& test = (*ast)[node.a];
+            if (test.kind == NhykNodeKind::BOOL) {
+                statement(test.a != 0 ? node.b : node.c);
+                break;
+            }
+            std::vector<uint32_t> jumps;
+            condition(node.a, false, jumps);
+            statement(node.b);
+            if (node.c != NhykAst::NO_NODE) {
+                uint32_t skip = emit(NhykOpcode::JMP, 0, NONE, 0, id);
+                for (uint32_t jump : jumps) patch(jump, here());
+                statement(node.c);
+                patch(skip, here());
+            } else {
+                for (uint32_t jump : jumps) patch(jump, here());
+            }
+            break;
+        }
+        case NhykNodeKind::WHILE: {
+            const NhykNode& test = (*ast)[node.a];
+            if (test.kind == NhykNodeKind::BOOL && test.a == 0) break;
+            // Jump to the test at the bottom; the test jumps back while it holds.
+            uint32_t enter = emit(NhykOpcode::JMP, 0, NONE, 0, id);
+            uint32_t body = here();
+            statement(node.b);
+            patch(enter, here());
+            std::vector<uint32_t> jumps;
+            condition(node.a, true, jumps);
+            for (uint32_t jump : jumps) patch(jump, body);
+            break;
+        }
+        case NhykNodeKind::FOR:
+            forStatement(id);
+            break;
+        case NhykNodeKind::MATCH:
+            matchStatement(id);
+            break;
+        case NhykNodeKind::OUTPUT: {
+            const uint32_t first = top;
+            for (uint32_t value : ast->list(id)) expression(value, temporary(value));
+            emit(NhykOpcode::OUTPUT, first, node.c, 0, id);
+            break;
+        }
+        case NhykNodeKind::INPUT: {
+            if (node.symbol == NhykSymbolTable::NO_SYMBOL) break;
+            uint32_t r = local(node.symbol);
+            if (r != NONE) {
+                emit(NhykOpcode::INPUT, r, 0, 0, id);
+            } else {
+                uint32_t t = temporary(id);
+                emit(NhykOpcode::INPUT, t, 0, 0, id);
+                emit(NhykOpcode::SETG, t, global(node.symbol), 0, id);
+            }
+            break;
+        }
+        case NhykNodeKind::RETURN:
+            if (inMain) {
+                if (node.a != NhykAst::NO_NODE) operand(node.a);
+                emit(NhykOpcode::HALT, 0, 0, 0, id);
+            } else if (node.a != NhykAst::NO_NODE) {
+                emit(NhykOpcode::RET, operand(node.a), 0, 0, id);
+            } else {
+                emit(NhykOpcode::RET0, 0, 0, 0, id);
+            }
+            break;
+        case NhykNodeKind::EXPRESSION:
+            if ((*ast)[node.a].kind == NhykNodeKind::CALL) call(node.a, NONE);
+            else expression(node.a, temporary(node.a));
+            break;
+        default:
+            break;
+    }
+    top = mark;
+}
+
+void NhykCompiler::declare(uint32_t decl) {
+    const NhykNode& node = (*ast)[decl];
+    if (node.a != NhykAst::NO_NODE) {
+        store(node.symbol, node.a, decl);
+        return;
+    }
+    if (node.symbol == NhykSymbolTable::NO_SYMBOL) return;
+    NhykValue value = NhykValue::none();
+    switch (node.type) {
+        case KeywordKind::KW_INTEGER: value = NhykValue::ofInt(0); break;
+        case KeywordKind::KW_DOUBLE:  value = NhykValue::ofDouble(0.0); break;
+        case KeywordKind::KW_STRING:  value = NhykValue::ofString(names.intern("")); break;
+        case KeywordKind::KW_BOOL:    value = NhykValue::ofBool(false); break;
+        default: break;
+    }
+    emit(NhykOpcode::LOADK, local(node.symbol), constant(value), 0, decl);
+}
+
+// Assigns the value of expression 'value' to variable 'symbol'.
+void NhykCompiler::store(uint32_t symbol, uint32_t value, uint32_t node) {
+    if (symbol == NhykSymbolTable::NO_SYMBOL) return;
+    uint32_t r = local(symbol);
+    if (r != NONE) {
+        expression(value, r);
+        return;
+    }
+    uint32_t t = temporary(value);
+    expression(value, t);
+    emit(NhykOpcode::SETG, t, global(symbol), 0, node);
+}
+
+// FOR i = first TO last: 'last' is evaluated once, into a temporary that lives as long
+// as the loop, and i counts up by one while it is <= last.
+void NhykCompiler::forStatement(uint32_t id) {
+    const NhykNode& node = (*ast)[id];
+    uint32_t counter = local(node.symbol);
+    if (counter == NONE) counter = temporary(id);
+    expression(node.a, counter);
+    uint32_t limit = temporary(node.b);
+    expression(node.b, limit);
+    uint32_t prepare = emit(NhykOpcode::FORPREP, counter, limit, NONE, id);
+    uint32_t body = here();
+    statement(node.c);
+    emit(NhykOpcode::FORLOOP, counter, limit, body, id);
+    patch(prepare, here());
+}
+
+// MATCH compares its subject with each CASE value in turn and runs the first arm that
+// is equal, or the DEFAULT arm (wherever it appears) when none is.
+void NhykCompiler::matchStatement(uint32_t id) {
+    const NhykNode& node = (*ast)[id];
+    NhykNodeList arms = ast->list(id);
+    uint32_t calling = NhykAst::NO_NODE;
+    for (uint32_t arm : arms) {
+        if (calls((*ast)[arm].a)) calling = (*ast)[arm].a;
+    }
+    const uint32_t subject = operand(node.a, calling);
+    const uint32_t mark = top;
+    uint32_t fallback = NONE;
+    uint32_t last = NONE;
+    for (uint32_t arm : arms) {
+        if ((*ast)[arm].a == NhykAst::NO_NODE) fallback = arm;
+        else last = arm;
+    }
+    std::vector<uint32_t> ends;
+    for (uint32_t arm : arms) {
+        const NhykNode& armNode = (*ast)[arm];
+        if (armNode.a == NhykAst::NO_NODE) continue;
+        uint32_t test = temporary(arm);
+        if (isConstant(armNode.a)) emit(NhykOpcode::EQK, test, subject, constantOf(armNode.a), arm);
+        else emit(NhykOpcode::EQ, test, subject, operand(armNode.a), arm);
+        uint32_t next = emit(NhykOpcode::JMPF, test, NONE, 0, arm);
+        top = mark;
+        for (uint32_t child : ast->list(arm)) statement(child);
+        // The last arm falls through to the end when there is no DEFAULT after it.
+        if (arm != last || fallback != NONE) ends.push_back(emit(NhykOpcode::JMP, 0, NONE, 0, arm));
+        patch(next, here());
+    }
+    if (fallback != NONE) {
+        for (uint32_t child : ast->list(fallback)) statement(child);
+    }
+    for (uint32_t end : ends) patch(end, here());
+}
+
+// --- Expressions ---
+
+// Whether evaluating 'node' may call a function.
+bool NhykCompiler::calls(uint32_t node) const {
+    if (node == NhykAst::NO_NODE) return false;
+    const NhykNode& n = (*ast)[node];
+    switch (n.kind) {
+        case NhykNodeKind::CALL:
+            return true;
+        case NhykNodeKind::UNARY:
+            return calls(n.a);
+        case NhykNodeKind::BINARY:
+            return calls(n.a) || calls(n.b);
+        case NhykNodeKind::LIST: case NhykNodeKind::SET:
+            for (uint32_t element : ast->list(node)) {
+                if (calls(element)) return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+// Register holding the value of 'node': a variable's own register, or a temporary.
+// 'later' is code that runs before that register is read. The main program's
+// variables are globals, so one that a function assigns is copied first when 'later'
+// may call, and operands are read left to right.
+uint32_t NhykCompiler::operand(uint32_t node, uint32_t later) {
+    const NhykNode& n = (*ast)[node];
+    if (n.kind == NhykNodeKind::NAME) {
+        uint32_t r = local(n.symbol);
+        if (r != NONE && !(inMain && assignedByFunctions[n.symbol] != 0 && calls(later))) return r;
+    }
+    uint32_t t = temporary(node);
+    expression(node, t);
+    return t;
+}
+
+// Computes 'node' into register 'target', which is written only by the last
+// instruction, so 'target' may also be read by the expression.
+void NhykCompiler::expression(uint32_t node, uint32_t target) {
+    const NhykNode& n = (*ast)[node];
+    const uint32_t mark = top;
+    switch (n.kind) {
+        case NhykNodeKind::INT: case NhykNodeKind::DOUBLE: case NhykNodeKind::BOOL:
+        case NhykNodeKind::STRING:
+            emit(NhykOpcode::LOADK, target, constantOf(node), 0, node);
+            break;
+        case NhykNodeKind::NAME: {
+            uint32_t r = local(n.symbol);
+            if (r != NONE) {
+                if (r != target) emit(NhykOpcode::MOVE, target, r, 0, node);
+            } else if (global(n.symbol) != NONE) {
+                emit(NhykOpcode::GETG, target, global(n.symbol), 0, node);
+            } else {
+                if (n.symbol != NhykSymbolTable::NO_SYMBOL) error(NhykDiagnosticKind::UNDEFINED_NAME, n.token);
+                emit(NhykOpcode::LOADK, target, constant(NhykValue::none()), 0, node);
+            }
+            break;
+        }
+        case NhykNodeKind::LIST: case NhykNodeKind::SET: {
+            if (isConstant(node)) {
+                emit(NhykOpcode::LOADK, target, constantOf(node), 0, node);
+                break;
+            }
+            const uint32_t first = top;
+            for (uint32_t element : ast->list(node)) expression(element, temporary(element));
+            emit(NhykOpcode::MAKELIST, target, first, n.c, node);
+            break;
+        }
+        case NhykNodeKind::UNARY:
+            emit(n.op == NhykOp::NEG ? NhykOpcode::NEG : NhykOpcode::NOT, target, operand(n.a), 0, node);
+            break;
+        case NhykNodeKind::BINARY:
+            binary(node, target);
+            break;
+        case NhykNodeKind::CALL:
+            call(node, target);
+            break;
+        default:
+            emit(NhykOpcode::LOADK, target, constant(NhykValue::none()), 0, node);
+            break;
+    }
+    top = mark;
+}
+
+void NhykCompiler::binary(uint32_t node, uint32_t target) {
+    const NhykNode& n = (*ast)[node];
+    if (n.op == NhykOp::AND) {
+        std::vector<uint32_t> jumps;
+        condition(node, false, jumps);
+        emit(NhykOpcode::LOADK, target, constant(NhykValue::ofBool(true)), 0, node);
+        uint32_t skip = emit(NhykOpcode::JMP, 0, NONE, 0, node);
+        for (uint32_t jump : jumps) patch(jump, here());
+        emit(NhykOpcode::LOADK, target, constant(NhykValue::ofBool(false)), 0, node);
+        patch(skip, here());
+        return;
+    }
+
+    NhykOp op = n.op;
+    uint32_t left = n.a;
+    uint32_t right = n.b;
+    if (op == NhykOp::IN || op == NhykOp::NOT_IN) {
+        // A SET is hashed and a constant list goes in the K form; anything else is
+        // checked at run time.
+        uint32_t l = operand(left, right);
+        if ((*ast)[right].kind == NhykNodeKind::SET && isConstant(right))
+            emit(op == NhykOp::IN ? NhykOpcode::INSET : NhykOpcode::NOTINSET, target, l, setOf(right), node);
+        else if ((*ast)[right].kind == NhykNodeKind::LIST && isConstant(right))
+            emit(constantForm(op), target, l, constantOf(right), node);
+        else
+            emit(registerForm(op), target, l, operand(right), node);
+        return;
+    }
+    // A constant on the left moves to the right where the operator allows it; numbers
+    // also commute under '+', strings do not.
+    if (isConstant(left) && !isConstant(right)) {
+        NhykNodeKind kind = (*ast)[left].kind;
+        NhykOp other = op == NhykOp::ADD && (kind == NhykNodeKind::INT || kind == NhykNodeKind::DOUBLE) ? op : swapped(op);
+        if (other != NhykOp::NONE) {
+            op = other;
+            std::swap(left, right);
+        }
+    }
+    uint32_t l = operand(left, right);
+    NhykNodeKind rightKind = (*ast)[right].kind;
+    if (isConstant(right) && rightKind != NhykNodeKind::LIST && rightKind != NhykNodeKind::SET)
+        emit(constantForm(op), target, l, constantOf(right), node);
+    else
+        emit(registerForm(op), target, l, operand(right), node);
+}
+
+// Arguments go in consecutive temporaries; the callee's frame starts at the first one,
+// and its result comes back in it.
+void NhykCompiler::call(uint32_t node, uint32_t target) {
+    const NhykNode& n = (*ast)[node];
+    uint32_t function = n.symbol < functionOf.size() ? functionOf[n.symbol] : NONE;
+    NhykNodeList args = ast->list(node);
+    if (function == NONE || args.size() != program->functions[function].params) {
+        if (n.symbol != NhykSymbolTable::NO_SYMBOL) {
+            error(function == NONE ? NhykDiagnosticKind::UNDEFINED_FUNCTION : NhykDiagnosticKind::ARGUMENT_COUNT, n.token);
+        }
+        if (target != NONE) emit(NhykOpcode::LOADK, target, constant(NhykValue::none()), 0, node);
+        return;
+    }
+    // A target that is the newest temporary can be the frame base itself.
+    const uint32_t mark = top;
+    const uint32_t base = target != NONE && target >= variables && target + 1 == top ? target : top;
+    top = base;
+    for (uint32_t arg : args) expression(arg, temporary(arg));
+    if (top == base) temporary(node);
+    emit(NhykOpcode::CALL, base, function, args.size(), node);
+    if (target != NONE && target != base) emit(NhykOpcode::MOVE, target, base, 0, node);
+    top = mark;
+}
+
+// Emits jumps, added to 'jumps' for patching, that are taken when 'node' is 'jumpIf'
+// and fall through otherwise. AND and NOT become control flow; TRUE and FALSE become an
+// unconditional jump or nothing. 'negated' is the NOT whose operand 'node' is: a value
+// that is not a BOOL is reported there, as the NOT instruction would report it, so the
+// location does not depend on whether the NOT ended up in a condition.
+void NhykCompiler::condition(uint32_t node, bool jumpIf, std::vector<uint32_t>& jumps, uint32_t negated) {
+    const NhykNode& n = (*ast)[node];
+    if (n.kind == NhykNodeKind::BINARY && n.op == NhykOp::AND) {
+        if (!jumpIf) {
+            condition(n.a, false, jumps);
+            condition(n.b, false, jumps);
+        } else {
+            std::vector<uint32_t> skip;
+            condition(n.a, false, skip);
+            condition(n.b, true, jumps);
+            for (uint32_t jump : skip) patch(jump, here());
+        }
+        return;
+    }
+    if (n.kind == NhykNodeKind::UNARY && n.op == NhykOp::NOT) {
+        condition(n.a, !jumpIf, jumps, node);
+        return;
+    }
+    if (n.kind == NhykNodeKind::BOOL) {
+        if ((n.a != 0) == jumpIf) jumps.push_back(emit(NhykOpcode::JMP, 0, NONE, 0, node));
+        return;
+    }
+    const uint32_t mark = top;
+    uint32_t r = operand(node);
+    jumps.push_back(emit(jumpIf ? NhykOpcode::JMPT : NhykOpcode::JMPF, r, NONE, 0, negated != NhykAst::NO_NODE ? negated : node));
+    top = mark;
+}
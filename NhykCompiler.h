@@ -0,0 +1,145 @@
+#ifndef NHYKCOMPILER_H_INCLUDED
+#define NHYKCOMPILER_H_INCLUDED
+
+/**
+ * @file NhykCompiler.h
+ * @brief Defines NhykCompiler, which translates an NhykAst into an NhykProgram.
+ *
+ * Scoping is by function, not by block. The main program's variables (every name it
+ * declares, assigns, loops over or reads with INPUT, outside any FUNC) are globals. In a
+ * function, the parameters, the names it declares with VAR, its FOR variables, and the
+ * names it assigns or INPUTs that are not globals are its locals; any other name it
+ * reads must be a global. Every FUNC, wherever it appears, defines a function of the
+ * program that any code may call (there are no closures), and compiles to nothing
+ * where it stands. A variable declared with a type and no value starts as that type's
+ * zero (0, 0.0, "", FALSE); one declared with neither holds NONE until assigned.
+ *
+ * Each variable lives in a register for the whole function, and expressions compute
+ * into temporaries above the variables, freed at the end of each statement. Operands
+ * are evaluated left to right: a main program variable that a function assigns is
+ * copied to a temporary before an operand to its right that calls. Constant
+ * operands are folded into the K forms of instructions; constants are pooled, so
+ * every distinct value (and every distinct string, being a symbol id) is stored once.
+ * Conditions of IF, WHILE and AND compile to jumps rather than BOOL values, and WHILE
+ * tests its condition at the bottom of the loop so each iteration takes one jump. When
+ * the condition of an IF or WHILE is TRUE or FALSE (as NhykOptimizer leaves it where it
+ * cannot drop a branch), only the code that can run is compiled. IS IN and IS NOT IN
+ * over a SET probe a hash set built at compile time.
+ *
+ * The tree should come from a parse without errors: ERROR nodes compile to NONE.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "NhykAst.h"
+#include "NhykBytecode.h"
+#include "NhykDiagnostics.h"
+#include "NhykLines.h"
+#include "NhykSymbols.h"
+#include "TokenBuffer.h"
+
+class NhykCompiler {
+public:
+    // Registers per frame; an instruction's 'a' operand is 16 bits.
+    static constexpr uint32_t MAX_REGISTERS = 65535;
+
+    // 'names' is the table the tree's symbol ids refer to (NhykParser::getNames()). The
+    // compiler interns "", the zero value of STRING variables, into it.
+    explicit NhykCompiler(NhykSymbolTable& names);
+    NhykCompiler(const NhykCompiler&) = delete;
+    NhykCompiler& operator=(const NhykCompiler&) = delete;
+
+    // Compiles the tree parsed from 'tokens' into 'program', replacing its contents.
+    // Returns false if there were errors; the program is then incomplete and must not
+    // be run. The tokens' source must outlive the program and getErrors() calls.
+    bool compile(const NhykAst& ast, const TokenBuffer& tokens, NhykProgram& program);
+
+    // Errors of the last compile, with their lines, columns and messages.
+    std::vector<ErrorToken> getErrors() const;
+    const NhykDiagnostics& getDiagnostics() const {return diagnostics;}
+    void setErrorLimit(size_t maxErrors) {diagnostics.setLimit(maxErrors);}
+
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    struct ConstantKey {
+        NhykType type;
+        uint64_t bits;
+        bool operator==(const ConstantKey& other) const {return type == other.type && bits == other.bits;}
+    };
+    struct ConstantHash {
+        size_t operator()(const ConstantKey& key) const {
+            return static_cast<size_t>((key.bits ^ static_cast<uint64_t>(key.type)) * 0x9E3779B97F4A7C15ull >> 16);
+        }
+    };
+
+    NhykSymbolTable& names;
+    NhykDiagnostics diagnostics;
+    mutable NhykLineIndex lines;       // Built on the first getErrors() after a compile.
+    std::string_view source;
+
+    const NhykAst* ast;
+    const TokenBuffer* tokens;
+    NhykProgram* program;
+    std::unordered_map<ConstantKey, uint32_t, ConstantHash> constantIndex;
+
+    // Per symbol id: its global, its register in the function being compiled, and the
+    // function it names; NONE where it has none.
+    std::vector<uint32_t> globalOf;
+    std::vector<uint32_t> localOf;
+    std::vector<uint32_t> functionOf;
+    std::vector<uint32_t> bound;       // Symbols with a localOf entry, to reset.
+    std::vector<uint32_t> functionNodes; // FUNC node of each function but main.
+    std::vector<uint8_t> assignedByFunctions; // Per symbol id: assigned in some FUNC.
+
+    bool inMain;
+    uint32_t variables;                // Registers taken by variables.
+    uint32_t top;                      // First free temporary.
+    uint32_t maxTop;                   // Frame size so far.
+    bool registersExhausted;
+
+    NhykSpan spanOf(uint32_t token) const;
+    void error(NhykDiagnosticKind kind, uint32_t token);
+
+    // Collecting functions and variables.
+    void collectFunctions(uint32_t id);
+    void collectVariables(uint32_t id);
+    void collectAssigned(uint32_t id);
+    void bind(uint32_t symbol, bool declared);
+    void checkFrame(uint32_t frameSize, uint32_t token);
+    uint32_t local(uint32_t symbol) const {return symbol < localOf.size() ? localOf[symbol] : NONE;}
+    uint32_t global(uint32_t symbol) const {return symbol < globalOf.size() ? globalOf[symbol] : NONE;}
+    void compileFunction(uint32_t index);
+
+    // Emitting code.
+    uint32_t emit(NhykOpcode op, uint32_t a, uint32_t b, uint32_t c, uint32_t node);
+    uint32_t here() const {return static_cast<uint32_t>(program->code.size());}
+    void patch(uint32_t jump, uint32_t target);
+    uint32_t constant(const NhykValue& value);
+    uint32_t constantOf(uint32_t node);
+    uint32_t setOf(uint32_t node);
+    bool isConstant(uint32_t node) const;
+    uint32_t temporary(uint32_t node);
+
+    void statement(uint32_t id);
+    void declare(uint32_t decl);
+    void store(uint32_t symbol, uint32_t value, uint32_t node);
+    void forStatement(uint32_t id);
+    void matchStatement(uint32_t id);
+    bool calls(uint32_t node) const;
+    uint32_t operand(uint32_t node, uint32_t later = NhykAst::NO_NODE);
+    void expression(uint32_t node, uint32_t target);
+    void binary(uint32_t node, uint32_t target);
+    void call(uint32_t node, uint32_t target);
+    void condition(uint32_t node, bool jumpIf, std::vector<uint32_t>& jumps, uint32_t negated = NhykAst::NO_NODE);
+};
+
+#endif // NHYKCOMPILER_H_INCLUDED
@@ -0,0 +1,442 @@
+#ifndef NHYKDFA_H_INCLUDED
+#define NHYKDFA_H_INCLUDED
+
+/**
+ * @file NhykDfa.h
+ * @brief Compiles a list of token patterns into one minimized DFA at compile time.
+ *
+ * nhykCompileDfa() takes an array of rules, each with a regex-like 'pattern', and
+ * returns an NhykDfa: a byte-class table recognizing all of them at once. It runs
+ * entirely in constant evaluation, so the table is emitted as read-only data and the
+ * lexer does no work at startup. The construction is the textbook one:
+ *
+ *  1. Each pattern is parsed into a Thompson NFA fragment; the end of rule i's fragment
+ *     accepts rule i.
+ *  2. Bytes that no pattern can tell apart are merged into byte classes.
+ *  3. Subset construction over the classes yields a DFA. A DFA state that contains
+ *     accepting NFA states accepts the rule listed first, so earlier rules win ties.
+ *  4. Moore partition refinement merges equivalent states, and the result is renumbered
+ *     breadth-first from the start state, which becomes state 0.
+ *  5. States that loop on every byte of an NhykScanKind class get that scanner, so the
+ *     driver can skip such runs with nhykScan as it does for the LexGraph tables.
+ *
+ * Pattern syntax: literal bytes; '\' escapes the next byte ('\t', '\n', '\r', '\v',
+ * '\f' as in C; '\xNN' is the byte NN in hex); '.' is any byte; [...] is a class with
+ * ranges and a leading '^' for negation; ( ) groups; | alternates; * + ? repeat. A
+ * malformed pattern or a spec too large for the fixed limits below fails compilation at
+ * the offending throw.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "NhykScan.h"
+
+struct NhykDfa {
+    static constexpr int MAX_STATES = 64;
+    static constexpr int MAX_CLASSES = 64;
+    static constexpr uint8_t NO_STATE = 0xFF;
+    static constexpr uint8_t START = 0;
+
+    uint8_t byteClass[256] = {};
+    uint8_t next[MAX_STATES][MAX_CLASSES] = {};
+    int8_t accept[MAX_STATES] = {};               // Rule accepted in each state, or -1.
+    NhykScanKind scan[MAX_STATES] = {};           // Run scanner attached to each state.
+    uint8_t stateCount = 0;
+    uint8_t classCount = 0;
+
+    // Successor of 'state' on 'byte', or NO_STATE.
+    constexpr uint8_t step(uint8_t state, unsigned char byte) const {return next[state][byteClass[byte]];}
+    constexpr bool isAccepting(uint8_t state) const {return accept[state] >= 0;}
+};
+
+namespace nhyk_dfa {
+
+constexpr int MAX_NFA = 256;
+constexpr int MAX_RULES = 32;
+
+// 256-bit set, used both for sets of bytes and for sets of NFA states.
+struct Bits {
+    uint64_t word[4] = {};
+
+    constexpr void add(int i) {word[i >> 6] |= uint64_t(1) << (i & 63);}
+    constexpr bool has(int i) const {return (word[i >> 6] >> (i & 63)) & 1;}
+    constexpr bool empty() const {return (word[0] | word[1] | word[2] | word[3]) == 0;}
+    constexpr void invert() {for (uint64_t& w : word) w = ~w;}
+    constexpr bool operator==(const Bits& other) const {
+        return word[0] == other.word[0] && word[1] == other.word[1] &&
+               word[2] == other.word[2] && word[3] == other.word[3];
+    }
+};
+
+struct NfaState {
+    int16_t epsilon[2] = {-1, -1};     // Empty transitions.
+    int16_t target = -1;               // Transition on any byte of 'on'.
+    Bits on;
+    int8_t rule = -1;                  // Rule accepted here, or -1.
+};
+
+struct Nfa {
+    NfaState states[MAX_NFA];
+    int count = 0;
+    int16_t ruleStart[MAX_RULES] = {};
+    int rules = 0;
+
+    constexpr int16_t add() {
+        if (count == MAX_NFA) throw std::length_error("nhykCompileDfa: patterns too large for MAX_NFA");
+        return static_cast<int16_t>(count++);
+    }
+    constexpr void link(int from, int to) {
+        NfaState& state = states[from];
+        if (state.epsilon[0] < 0) state.epsilon[0] = static_cast<int16_t>(to);
+        else if (state.epsilon[1] < 0) state.epsilon[1] = static_cast<int16_t>(to);
+        else throw std::logic_error("nhykCompileDfa: NFA state with three empty transitions");
+    }
+};
+
+// A piece of NFA with one entry and one exit that has no transitions yet.
+struct Fragment {
+    int16_t start;
+    int16_t end;
+};
+
+constexpr int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    throw std::invalid_argument("nhykCompileDfa: bad \\x escape in pattern");
+}
+
+// The byte named by the escape at 'at' (just past the '\'), consuming it.
+constexpr unsigned char escaped(const char*& at) {
+    char c = *at++;
+    switch (c) {
+        case 't': return '\t';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 'v': return '\v';
+        case 'f': return '\f';
+        case 'x': {
+            int high = hexDigit(*at++);
+            int low = hexDigit(*at++);
+            return static_cast<unsigned char>(high * 16 + low);
+        }
+        default:  return static_cast<unsigned char>(c);
+    }
+}
+
+// Recursive-descent parser from pattern text to a Thompson fragment.
+struct Parser {
+    Nfa& nfa;
+    const char* at;
+
+    constexpr char peek() const {return *at;}
+
+    constexpr Fragment byteSet(const Bits& set) {
+        int16_t from = nfa.add();
+        int16_t to = nfa.add();
+        nfa.states[from].on = set;
+        nfa.states[from].target = to;
+        return Fragment{from, to};
+    }
+
+    constexpr Fragment empty() {
+        int16_t state = nfa.add();
+        return Fragment{state, state};
+    }
+
+    // '[' already consumed.
+    constexpr Bits charClass() {
+        Bits set;
+        bool negate = false;
+        if (peek() == '^') {
+            negate = true;
+            ++at;
+        }
+        bool first = true;
+        while (peek() != ']' || first) {
+            if (peek() == '\0') throw std::invalid_argument("nhykCompileDfa: unterminated [ in pattern");
+            first = false;
+            unsigned char low = static_cast<unsigned char>(*at++);
+            if (low == '\\') low = escaped(at);
+            unsigned char high = low;
+            if (peek() == '-' && at[1] != ']' && at[1] != '\0') {
+                ++at;
+                high = static_cast<unsigned char>(*at++);
+                if (high == '\\') high = escaped(at);
+                if (high < low) throw std::invalid_argument("nhykCompileDfa: reversed range in pattern");
+            }
+            for (int c = low; c <= high; ++c) set.add(c);
+        }
+        ++at;
+        if (negate) set.invert();
+        return set;
+    }
+
+    constexpr Fragment atom() {
+        char c = *at++;
+        Bits set;
+        switch (c) {
+            case '(': {
+                Fragment inner = alternation();
+                if (*at++ != ')') throw std::invalid_argument("nhykCompileDfa: missing ) in pattern");
+                return inner;
+            }
+            case '[':
+                return byteSet(charClass());
+            case '.':
+                set.invert();
+                return byteSet(set);
+            case '\\':
+                if (peek() == '\0') throw std::invalid_argument("nhykCompileDfa: trailing \\ in pattern");
+                set.add(escaped(at));
+                return byteSet(set);
+            case '*': case '+': case '?': case ')': case '|': case '\0':
+                throw std::invalid_argument("nhykCompileDfa: misplaced operator in pattern");
+            default:
+                set.add(static_cast<unsigned char>(c));
+                return byteSet(set);
+        }
+    }
+
+    constexpr Fragment repetition() {
+        Fragment fragment = atom();
+        while (peek() == '*' || peek() == '+' || peek() == '?') {
+            char op = *at++;
+            int16_t entry = nfa.add();
+            int16_t exit = nfa.add();
+            nfa.link(entry, fragment.start);
+            if (op != '+') nfa.link(entry, exit);            // May be skipped.
+            if (op != '?') nfa.link(fragment.end, fragment.start);  // May repeat.
+            nfa.link(fragment.end, exit);
+            fragment = Fragment{entry, exit};
+        }
+        return fragment;
+    }
+
+    constexpr Fragment sequence() {
+        Fragment whole = empty();
+        while (peek() != '\0' && peek() != '|' && peek() != ')') {
+            Fragment part = repetition();
+            nfa.link(whole.end, part.start);
+            whole.end = part.end;
+        }
+        return whole;
+    }
+
+    constexpr Fragment alternation() {
+        Fragment result = sequence();
+        while (peek() == '|') {
+            ++at;
+            Fragment option = sequence();
+            int16_t entry = nfa.add();
+            int16_t exit = nfa.add();
+            nfa.link(entry, result.start);
+            nfa.link(entry, option.start);
+            nfa.link(result.end, exit);
+            nfa.link(option.end, exit);
+            result = Fragment{entry, exit};
+        }
+        return result;
+    }
+};
+
+constexpr Bits closure(const Nfa& nfa, Bits set) {
+    int stack[MAX_NFA] = {};
+    int top = 0;
+    for (int s = 0; s < nfa.count; ++s)
+        if (set.has(s)) stack[top++] = s;
+    while (top > 0) {
+        const NfaState& state = nfa.states[stack[--top]];
+        for (int16_t to : state.epsilon) {
+            if (to >= 0 && !set.has(to)) {
+                set.add(to);
+                stack[top++] = to;
+            }
+        }
+    }
+    return set;
+}
+
+// Everything the builder needs besides the output table.
+struct Builder {
+    Nfa nfa;
+    int classes = 0;
+    int classOf[256] = {};
+    int representative[NhykDfa::MAX_CLASSES] = {};
+    Bits subsets[NhykDfa::MAX_STATES];
+    int16_t moves[NhykDfa::MAX_STATES][NhykDfa::MAX_CLASSES] = {};
+    int8_t accepts[NhykDfa::MAX_STATES] = {};
+    int states = 0;
+
+    // Splits the bytes into classes that every transition in the NFA treats alike.
+    constexpr void buildClasses() {
+        classes = 1;
+        for (int s = 0; s < nfa.count; ++s) {
+            if (nfa.states[s].target < 0) continue;
+            const Bits& on = nfa.states[s].on;
+            int split[NhykDfa::MAX_CLASSES * 2] = {};
+            for (int& id : split) id = -1;
+            int renumbered = 0;
+            for (int b = 0; b < 256; ++b) {
+                int key = classOf[b] * 2 + (on.has(b) ? 1 : 0);
+                if (split[key] < 0) {
+                    if (renumbered == NhykDfa::MAX_CLASSES)
+                        throw std::length_error("nhykCompileDfa: more than MAX_CLASSES byte classes");
+                    split[key] = renumbered++;
+                }
+                classOf[b] = split[key];
+            }
+            classes = renumbered;
+        }
+        for (int b = 255; b >= 0; --b) representative[classOf[b]] = b;
+    }
+
+    constexpr int8_t acceptOf(const Bits& set) const {
+        int8_t best = -1;
+        for (int s = 0; s < nfa.count; ++s) {
+            int8_t rule = nfa.states[s].rule;
+            if (rule >= 0 && set.has(s) && (best < 0 || rule < best)) best = rule;
+        }
+        return best;
+    }
+
+    constexpr int16_t findOrAdd(const Bits& set) {
+        for (int d = 0; d < states; ++d)
+            if (subsets[d] == set) return static_cast<int16_t>(d);
+        if (states == NhykDfa::MAX_STATES) throw std::length_error("nhykCompileDfa: more than MAX_STATES DFA states");
+        subsets[states] = set;
+        accepts[states] = acceptOf(set);
+        return static_cast<int16_t>(states++);
+    }
+
+    constexpr void buildSubsets() {
+        Bits start;
+        for (int r = 0; r < nfa.rules; ++r) start.add(nfa.ruleStart[r]);
+        findOrAdd(closure(nfa, start));
+        for (int d = 0; d < states; ++d) {
+            for (int c = 0; c < classes; ++c) {
+                Bits moved;
+                for (int s = 0; s < nfa.count; ++s) {
+                    const NfaState& state = nfa.states[s];
+                    if (state.target >= 0 && subsets[d].has(s) && state.on.has(representative[c])) moved.add(state.target);
+                }
+                moves[d][c] = moved.empty() ? int16_t(-1) : findOrAdd(closure(nfa, moved));
+            }
+        }
+    }
+};
+
+template <typename Rule, size_t N>
+constexpr NhykDfa compile(const Rule (&rules)[N]) {
+    static_assert(N > 0 && N <= MAX_RULES, "nhykCompileDfa: between 1 and MAX_RULES rules");
+    Builder builder;
+    for (size_t r = 0; r < N; ++r) {
+        Parser parser{builder.nfa, rules[r].pattern};
+        Fragment fragment = parser.alternation();
+        if (parser.peek() != '\0') throw std::invalid_argument("nhykCompileDfa: unbalanced ) in pattern");
+        builder.nfa.states[fragment.end].rule = static_cast<int8_t>(r);
+        builder.nfa.ruleStart[builder.nfa.rules++] = fragment.start;
+    }
+    builder.buildClasses();
+    builder.buildSubsets();
+    const int states = builder.states;
+    const int classes = builder.classes;
+
+    // Moore refinement: start from "same rule accepted", split on successor blocks.
+    int block[NhykDfa::MAX_STATES] = {};
+    int blocks = 0;
+    for (int d = 0; d < states; ++d) {
+        block[d] = -1;
+        for (int e = 0; e < d && block[d] < 0; ++e)
+            if (builder.accepts[e] == builder.accepts[d]) block[d] = block[e];
+        if (block[d] < 0) block[d] = blocks++;
+    }
+    while (true) {
+        int refined[NhykDfa::MAX_STATES] = {};
+        int count = 0;
+        for (int d = 0; d < states; ++d) {
+            refined[d] = -1;
+            for (int e = 0; e < d && refined[d] < 0; ++e) {
+                bool same = block[e] == block[d];
+                for (int c = 0; c < classes && same; ++c) {
+                    int to1 = builder.moves[d][c], to2 = builder.moves[e][c];
+                    same = (to1 < 0 ? -1 : block[to1]) == (to2 < 0 ? -1 : block[to2]);
+                }
+                if (same) refined[d] = refined[e];
+            }
+            if (refined[d] < 0) refined[d] = count++;
+        }
+        for (int d = 0; d < states; ++d) block[d] = refined[d];
+        if (count == blocks) break;
+        blocks = count;
+    }
+
+    // Renumber the blocks breadth-first from the start state and emit the table.
+    NhykDfa dfa;
+    int number[NhykDfa::MAX_STATES] = {};
+    int member[NhykDfa::MAX_STATES] = {};      // One DFA state of each numbered block.
+    for (int b = 0; b < blocks; ++b) number[b] = -1;
+    number[block[0]] = 0;
+    member[0] = 0;
+    int numbered = 1;
+    for (int n = 0; n < numbered; ++n) {
+        for (int c = 0; c < classes; ++c) {
+            int to = builder.moves[member[n]][c];
+            if (to >= 0 && number[block[to]] < 0) {
+                number[block[to]] = numbered;
+                member[numbered++] = to;
+            }
+        }
+    }
+    dfa.stateCount = static_cast<uint8_t>(numbered);
+    dfa.classCount = static_cast<uint8_t>(classes);
+    for (int b = 0; b < 256; ++b) dfa.byteClass[b] = static_cast<uint8_t>(builder.classOf[b]);
+    for (int n = 0; n < NhykDfa::MAX_STATES; ++n) {
+        dfa.accept[n] = -1;
+        dfa.scan[n] = NhykScanKind::NONE;
+        for (int c = 0; c < NhykDfa::MAX_CLASSES; ++c) dfa.next[n][c] = NhykDfa::NO_STATE;
+    }
+    for (int n = 0; n < numbered; ++n) {
+        dfa.accept[n] = builder.accepts[member[n]];
+        for (int c = 0; c < classes; ++c) {
+            int to = builder.moves[member[n]][c];
+            if (to >= 0) dfa.next[n][c] = static_cast<uint8_t>(number[block[to]]);
+        }
+    }
+
+    // Attach a run scanner to states that loop on every byte of its class.
+    constexpr NhykScanKind candidates[] = {
+        NhykScanKind::STRING_BODY, NhykScanKind::IDENT_CONTINUE, NhykScanKind::DIGITS, NhykScanKind::WHITESPACE
+    };
+    for (int n = 0; n < numbered; ++n) {
+        for (NhykScanKind kind : candidates) {
+            bool loops = true;
+            for (int b = 0; b < 256 && loops; ++b)
+                if (nhykInScanClass(kind, static_cast<unsigned char>(b)) && dfa.step(static_cast<uint8_t>(n), static_cast<unsigned char>(b)) != n)
+                    loops = false;
+            if (loops) {
+                dfa.scan[n] = kind;
+                break;
+            }
+        }
+    }
+    return dfa;
+}
+
+} // namespace nhyk_dfa
+
+// Compiles 'rules' (any type with a 'const char* pattern' member; earlier rules win
+// ties) into a minimized DFA. Meant to initialize a constexpr variable.
+template <typename Rule, size_t N>
+constexpr NhykDfa nhykCompileDfa(const Rule (&rules)[N]) {
+    return nhyk_dfa::compile(rules);
+}
+
+#endif // NHYKDFA_H_INCLUDED
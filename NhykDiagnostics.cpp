@@ -0,0 +1,133 @@
+#include "NhykDiagnostics.h"
+#include "Keywords.h"
+/**
+ * @file NhykDiagnostics.cpp
+ * @brief Implementation of diagnostic messages.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+// Quoted text of an error: quotes and backslashes are escaped, other bytes outside
+// printable ASCII are written as \xNN, and long runs of garbage are cut short.
+std::string quote(std::string_view text) {
+    static const char digits[] = "0123456789ABCDEF";
+    const size_t shown = 32;
+    std::string quoted = "\"";
+    for (size_t i = 0; i < text.size() && i < shown; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += static_cast<char>(c);
+        } else if (c >= 32 && c <= 126) {
+            quoted += static_cast<char>(c);
+        } else {
+            quoted += "\\x";
+            quoted += digits[c >> 4];
+            quoted += digits[c & 0xF];
+        }
+    }
+    if (text.size() > shown) quoted += "...";
+    quoted += '"';
+    return quoted;
+}
+
+// Where a syntax error was found: before the token, or at the end of the source.
+std::string where(std::string_view text) {
+    return text.empty() ? "at end of input" : "before " + quote(text);
+}
+
+} // namespace
+
+void NhykDiagnostics::append(const NhykDiagnostics& other, uint32_t shift) {
+    size_t recorded = 0;
+    uint32_t marker = shift;
+    for (const NhykDiagnostic& entry : other.entries) {
+        if (entry.kind == NhykDiagnosticKind::TOO_MANY_ERRORS) {
+            marker = entry.offset + shift;
+            continue;
+        }
+        report(entry.kind, entry.offset + shift, entry.length, entry.detail);
+        ++recorded;
+    }
+    for (size_t i = recorded; i < other.total; ++i) {
+        ++total;
+        if (total == limit + 1 && limit != 0) entries.push_back(NhykDiagnostic{marker, 0, NhykDiagnosticKind::TOO_MANY_ERRORS, 0});
+    }
+}
+
+std::string NhykDiagnostics::message(const NhykDiagnostic& diagnostic, std::string_view source) {
+    std::string_view text;
+    if (diagnostic.offset < source.size()) text = source.substr(diagnostic.offset, diagnostic.length);
+    switch (diagnostic.kind) {
+        case NhykDiagnosticKind::INVALID_CHARACTERS:
+            return (diagnostic.length == 1 ? "Unknown token " : "Unknown characters ") + quote(text) + ".";
+        case NhykDiagnosticKind::MALFORMED_TOKEN:
+            return "Malformed token " + quote(text) + ".";
+        case NhykDiagnosticKind::INCOMPLETE_TOKEN:
+            return "Incomplete token " + quote(text) + ".";
+        case NhykDiagnosticKind::NUMBER_OUT_OF_RANGE:
+            return "Numeric literal " + quote(text) + " is out of range.";
+        case NhykDiagnosticKind::EXPECTED_TOKEN:
+            return std::string("Expected '") + static_cast<char>(diagnostic.detail) + "' " + where(text) + ".";
+        case NhykDiagnosticKind::EXPECTED_KEYWORD:
+            return "Expected " + std::string(keywordText(static_cast<KeywordKind>(diagnostic.detail))) + " " + where(text) + ".";
+        case NhykDiagnosticKind::EXPECTED_NAME:
+            return "Expected a name " + where(text) + ".";
+        case NhykDiagnosticKind::EXPECTED_EXPRESSION:
+            return "Expected an expression " + where(text) + ".";
+        case NhykDiagnosticKind::UNEXPECTED_TOKEN:
+            return text.empty() ? std::string("Unexpected end of input.") : "Unexpected " + quote(text) + ".";
+        case NhykDiagnosticKind::NESTING_TOO_DEEP:
+            return "Nesting too deep " + where(text) + ".";
+        case NhykDiagnosticKind::UNDEFINED_NAME:
+            return "Undefined name " + quote(text) + ".";
+        case NhykDiagnosticKind::UNDEFINED_FUNCTION:
+            return "Undefined function " + quote(text) + ".";
+        case NhykDiagnosticKind::DUPLICATE_FUNCTION:
+            return "Function " + quote(text) + " is already defined.";
+        case NhykDiagnosticKind::ARGUMENT_COUNT:
+            return "Wrong number of arguments in call to " + quote(text) + ".";
+        case NhykDiagnosticKind::TOO_MANY_REGISTERS:
+            return "Too many variables and temporaries in function " + quote(text) + ".";
+        case NhykDiagnosticKind::TYPE_ERROR:
+            return "Operand of the wrong type for " + quote(text) + ".";
+        case NhykDiagnosticKind::DIVISION_BY_ZERO:
+            return "Division by zero at " + quote(text) + ".";
+        case NhykDiagnosticKind::STACK_OVERFLOW:
+            return "Call stack overflow in call to " + quote(text) + ".";
+        case NhykDiagnosticKind::TOO_MANY_ERRORS:
+            return "Too many errors; further errors are not reported.";
+    }
+    return std::string();
+}
+
+std::string NhykDiagnosticKindToString(NhykDiagnosticKind kind) {
+    switch (kind) {
+        case NhykDiagnosticKind::INVALID_CHARACTERS:  return "INVALID_CHARACTERS";
+        case NhykDiagnosticKind::MALFORMED_TOKEN:     return "MALFORMED_TOKEN";
+        case NhykDiagnosticKind::INCOMPLETE_TOKEN:    return "INCOMPLETE_TOKEN";
+        case NhykDiagnosticKind::NUMBER_OUT_OF_RANGE: return "NUMBER_OUT_OF_RANGE";
+        case NhykDiagnosticKind::EXPECTED_TOKEN:      return "EXPECTED_TOKEN";
+        case NhykDiagnosticKind::EXPECTED_KEYWORD:    return "EXPECTED_KEYWORD";
+        case NhykDiagnosticKind::EXPECTED_NAME:       return "EXPECTED_NAME";
+        case NhykDiagnosticKind::EXPECTED_EXPRESSION: return "EXPECTED_EXPRESSION";
+        case NhykDiagnosticKind::UNEXPECTED_TOKEN:    return "UNEXPECTED_TOKEN";
+        case NhykDiagnosticKind::NESTING_TOO_DEEP:    return "NESTING_TOO_DEEP";
+        case NhykDiagnosticKind::UNDEFINED_NAME:      return "UNDEFINED_NAME";
+        case NhykDiagnosticKind::UNDEFINED_FUNCTION:  return "UNDEFINED_FUNCTION";
+        case NhykDiagnosticKind::DUPLICATE_FUNCTION:  return "DUPLICATE_FUNCTION";
+        case NhykDiagnosticKind::ARGUMENT_COUNT:      return "ARGUMENT_COUNT";
+        case NhykDiagnosticKind::TOO_MANY_REGISTERS:  return "TOO_MANY_REGISTERS";
+        case NhykDiagnosticKind::TYPE_ERROR:          return "TYPE_ERROR";
+        case NhykDiagnosticKind::DIVISION_BY_ZERO:    return "DIVISION_BY_ZERO";
+        case NhykDiagnosticKind::STACK_OVERFLOW:      return "STACK_OVERFLOW";
+        case NhykDiagnosticKind::TOO_MANY_ERRORS:     return "TOO_MANY_ERRORS";
+    }
+    return "UNKNOWN";
+}
@@ -0,0 +1,117 @@
+#ifndef NHYKDIAGNOSTICS_H_INCLUDED
+#define NHYKDIAGNOSTICS_H_INCLUDED
+
+/**
+ * @file NhykDiagnostics.h
+ * @brief Defines NhykDiagnostics, the error list of every stage, and ErrorToken.
+ *
+ * While lexing, parsing, compiling or running, an error is only recorded: a 12-byte (kind, offset, length)
+ * entry is appended to a vector, and nothing is formatted or written. Adjacent invalid
+ * bytes extend the previous entry instead of adding one, so a binary blob costs one
+ * entry per run rather than one per byte. Past the error limit, errors are only counted.
+ *
+ * Lines, columns and messages are produced afterwards, on request, as ErrorTokens.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class NhykDiagnosticKind : uint8_t {
+    INVALID_CHARACTERS,  // A run of bytes no token can start with.
+    MALFORMED_TOKEN,     // Text matched by an error rule, e.g. "7pop".
+    INCOMPLETE_TOKEN,    // A token that was started but never finished, e.g. an unterminated string.
+    NUMBER_OUT_OF_RANGE, // A numeric literal too large for int64_t or double.
+    // Syntax errors, reported by NhykParser at the token where they were found.
+    EXPECTED_TOKEN,      // A punctuation or operator was missing; 'detail' is its character.
+    EXPECTED_KEYWORD,    // A keyword was missing; 'detail' is its KeywordKind.
+    EXPECTED_NAME,       // An identifier was missing.
+    EXPECTED_EXPRESSION, // An expression was missing.
+    UNEXPECTED_TOKEN,    // A token that cannot start a statement where it appears.
+    NESTING_TOO_DEEP,    // Statements or expressions nested past NhykParser::MAX_DEPTH.
+    // Compile errors, reported by NhykCompiler at the node's token.
+    UNDEFINED_NAME,      // A variable that is read but never declared or assigned.
+    UNDEFINED_FUNCTION,  // A call to a function that no FUNC defines.
+    DUPLICATE_FUNCTION,  // A second FUNC with the same name.
+    ARGUMENT_COUNT,      // A call with more or fewer arguments than the function has parameters.
+    TOO_MANY_REGISTERS,  // A function needing more than NhykCompiler::MAX_REGISTERS registers.
+    // Runtime errors, reported by NhykVM at the token of the failing instruction.
+    TYPE_ERROR,          // An operation on values of the wrong types.
+    DIVISION_BY_ZERO,    // An INTEGER divided by zero.
+    STACK_OVERFLOW,      // Calls nested past NhykVM::MAX_CALL_DEPTH.
+    TOO_MANY_ERRORS      // The error limit was reached; later errors are only counted.
+};
+
+struct NhykDiagnostic {
+    uint32_t offset;
+    uint32_t length;
+    NhykDiagnosticKind kind;
+    uint8_t detail;                    // What was expected; see NhykDiagnosticKind.
+};
+
+// A diagnostic resolved against its source, for display.
+struct ErrorToken {
+    NhykDiagnosticKind kind;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t line;
+    uint32_t col;
+    std::string message;
+};
+
+class NhykDiagnostics {
+public:
+    static constexpr size_t DEFAULT_LIMIT = 1000;
+
+    NhykDiagnostics() : limit(DEFAULT_LIMIT), total(0) {}
+
+    // Records an error at [offset, offset + length). An INVALID_CHARACTERS error that
+    // starts where the previous one ends extends it instead.
+    void report(NhykDiagnosticKind kind, uint32_t offset, uint32_t length, uint8_t detail = 0) {
+        if (kind == NhykDiagnosticKind::INVALID_CHARACTERS && !entries.empty()) {
+            NhykDiagnostic& last = entries.back();
+            if (last.kind == kind && last.offset + last.length == offset) {
+                last.length += length;
+                return;
+            }
+        }
+        ++total;
+        if (total <= limit) entries.push_back(NhykDiagnostic{offset, length, kind, detail});
+        else if (total == limit + 1 && limit != 0) entries.push_back(NhykDiagnostic{offset, 0, NhykDiagnosticKind::TOO_MANY_ERRORS, 0});
+    }
+
+    // Adds the entries of 'other' with their offsets moved by 'shift', as if each were
+    // reported here (so a run of invalid bytes continuing the last entry extends it).
+    // Errors 'other' only counted past its limit are counted here too.
+    void append(const NhykDiagnostics& other, uint32_t shift);
+
+    // Keeps at most 'maxErrors' entries (plus one TOO_MANY_ERRORS marker); 0 records none.
+    void setLimit(size_t maxErrors) {limit = maxErrors;}
+    size_t getLimit() const {return limit;}
+    void clear() {entries.clear(); total = 0;}
+
+    const std::vector<NhykDiagnostic>& getEntries() const {return entries;}
+    // Every error reported since clear(), including those past the limit.
+    size_t count() const {return total;}
+    bool empty() const {return total == 0;}
+
+    // The message of a diagnostic found in 'source', quoting (and escaping) its text.
+    static std::string message(const NhykDiagnostic& diagnostic, std::string_view source);
+
+private:
+    std::vector<NhykDiagnostic> entries;
+    size_t limit;
+    size_t total;
+};
+
+std::string NhykDiagnosticKindToString(NhykDiagnosticKind kind);
+
+#endif // NHYKDIAGNOSTICS_H_INCLUDED
@@ -0,0 +1,228 @@
+#include "NhykDump.h"
+#include "TokenBuffer.h"
+#include <charconv>
+#include <cstring>
+#include <string>
+/**
+ * @file NhykDump.cpp
+ * @brief Implementation of the buffered token writer.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+constexpr size_t TYPE_COUNT = static_cast<size_t>(TokenType::END_OF_INPUT) + 1;
+
+// Text written before a row's lexeme, padded so it can be copied with a fixed-size
+// memcpy (two vector moves) whatever its length.
+struct Prefix {
+    char text[48];
+    size_t size;
+};
+
+// The prefixes per format and token type. Built once.
+struct Prefixes {
+    Prefix table[TYPE_COUNT];
+    Prefix json[TYPE_COUNT];
+    Prefix csv[TYPE_COUNT];
+
+    static void set(Prefix& prefix, const std::string& text) {
+        std::memset(prefix.text, 0, sizeof(prefix.text));
+        std::memcpy(prefix.text, text.data(), text.size());
+        prefix.size = text.size();
+    }
+
+    Prefixes() {
+        for (size_t t = 0; t < TYPE_COUNT; ++t) {
+            std::string name(tokenTypeNames[t]);
+            TokenType type = static_cast<TokenType>(t);
+            // The table gives these types an extra tab, as operator<< always has.
+            bool wide = type == TokenType::KEYWORD || type == TokenType::OPERATOR ||
+                        type == TokenType::LITERAL || type == TokenType::UNKNOWN;
+            set(table[t], "Type: " + name + (wide ? ":\t\tLexeme: " : ":\tLexeme: "));
+            set(json[t], "{\"type\":\"" + name + "\",\"lexeme\":\"");
+            set(csv[t], name + ",");
+        }
+    }
+};
+
+const Prefixes& prefixes() {
+    static const Prefixes built;
+    return built;
+}
+
+inline char* put(char* at, const char* text, size_t size) {
+    std::memcpy(at, text, size);
+    return at + size;
+}
+
+inline char* put(char* at, const Prefix& prefix) {
+    std::memcpy(at, prefix.text, sizeof(prefix.text));
+    return at + prefix.size;
+}
+
+inline char* putNumber(char* at, uint32_t value) {
+    return std::to_chars(at, at + 10, value).ptr;
+}
+
+// Writes 'text' escaped for a JSON string; runs that need no escaping go in one piece.
+char* putEscaped(char* at, std::string_view text) {
+    static const char digits[] = "0123456789abcdef";
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        at = put(at, text.data() + run, i - run);
+        run = i + 1;
+        *at++ = '\\';
+        switch (c) {
+            case '"':  *at++ = '"';  break;
+            case '\\': *at++ = '\\'; break;
+            case '\n': *at++ = 'n';  break;
+            case '\t': *at++ = 't';  break;
+            case '\r': *at++ = 'r';  break;
+            default:
+                at = put(at, "u00", 3);
+                *at++ = digits[c >> 4];
+                *at++ = digits[c & 0xF];
+        }
+    }
+    return put(at, text.data() + run, text.size() - run);
+}
+
+// Writes 'text' as the inside of a quoted CSV field: quotes are doubled.
+char* putCsvQuoted(char* at, std::string_view text) {
+    size_t run = 0;
+    for (size_t quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"', quote + 1)) {
+        at = put(at, text.data() + run, quote + 1 - run);
+        *at++ = '"';
+        run = quote + 1;
+    }
+    return put(at, text.data() + run, text.size() - run);
+}
+
+const char TABLE_HEADER[] = "\n TokenType\t\tLexeme: Lex\n------------------------------------\n";
+const char CSV_HEADER[] = "type,offset,length,lexeme\n";
+
+} // namespace
+
+// --- NhykTokenWriter Implementation ---
+
+NhykTokenWriter::NhykTokenWriter(std::FILE* out, NhykDumpFormat fmt, size_t bufferSize)
+    : file(out), stream(nullptr), format(fmt), buffer(new char[bufferSize < 64 ? 64 : bufferSize]),
+      capacity(bufferSize < 64 ? 64 : bufferSize), used(0), headerWritten(false), ok(true) {}
+
+NhykTokenWriter::NhykTokenWriter(std::ostream& out, NhykDumpFormat fmt, size_t bufferSize)
+    : file(nullptr), stream(&out), format(fmt), buffer(new char[bufferSize < 64 ? 64 : bufferSize]),
+      capacity(bufferSize < 64 ? 64 : bufferSize), used(0), headerWritten(false), ok(true) {}
+
+NhykTokenWriter::~NhykTokenWriter() {
+    flush();
+}
+
+void NhykTokenWriter::flush() {
+    if (used == 0) return;
+    if (file != nullptr) {
+        if (std::fwrite(buffer.get(), 1, used, file) != used) ok = false;
+    } else {
+        stream->write(buffer.get(), static_cast<std::streamsize>(used));
+        if (!*stream) ok = false;
+    }
+    used = 0;
+}
+
+char* NhykTokenWriter::reserve(size_t size) {
+    if (capacity - used < size) {
+        flush();
+        // A row longer than the whole buffer (a huge string literal) grows it for good.
+        if (size > capacity) {
+            buffer.reset(new char[size]);
+            capacity = size;
+        }
+    }
+    return buffer.get() + used;
+}
+
+void NhykTokenWriter::append(const char* data, size_t size) {
+    used = static_cast<size_t>(put(reserve(size), data, size) - buffer.get());
+}
+
+void NhykTokenWriter::begin() {
+    if (format == NhykDumpFormat::TABLE) {
+        append(TABLE_HEADER, sizeof(TABLE_HEADER) - 1);
+    } else if (format == NhykDumpFormat::CSV && !headerWritten) {
+        append(CSV_HEADER, sizeof(CSV_HEADER) - 1);
+        headerWritten = true;
+    }
+}
+
+/**
+ * @brief Formats one token into the buffer.
+ *
+ * @details Room for the longest possible row (every lexeme byte escaped to six) is made
+ * first, so the row itself is written through a plain pointer with no further checks.
+ * Only LITERAL and UNKNOWN lexemes can hold bytes that need escaping or quoting.
+ */
+void NhykTokenWriter::row(TokenType type, std::string_view lexeme, bool positioned, uint32_t offset) {
+    const Prefixes& prefix = prefixes();
+    const size_t t = static_cast<size_t>(type);
+    const bool plain = type != TokenType::LITERAL && type != TokenType::UNKNOWN;
+    char* const start = reserve(sizeof(Prefix::text) + 6 * lexeme.size() + 48);
+    char* at = start;
+    switch (format) {
+        case NhykDumpFormat::TABLE:
+            at = put(at, prefix.table[t]);
+            at = put(at, lexeme.data(), lexeme.size());
+            *at++ = '\n';
+            break;
+        case NhykDumpFormat::JSON_LINES:
+            at = put(at, prefix.json[t]);
+            at = plain ? put(at, lexeme.data(), lexeme.size()) : putEscaped(at, lexeme);
+            if (positioned) {
+                at = put(at, "\",\"offset\":", 11);
+                at = putNumber(at, offset);
+                at = put(at, ",\"length\":", 10);
+                at = putNumber(at, static_cast<uint32_t>(lexeme.size()));
+                at = put(at, "}\n", 2);
+            } else {
+                at = put(at, "\"}\n", 3);
+            }
+            break;
+        case NhykDumpFormat::CSV:
+            at = put(at, prefix.csv[t]);
+            if (positioned) {
+                at = putNumber(at, offset);
+                *at++ = ',';
+                at = putNumber(at, static_cast<uint32_t>(lexeme.size()));
+            } else {
+                *at++ = ',';
+            }
+            at = put(at, ",\"", 2);
+            at = plain ? put(at, lexeme.data(), lexeme.size()) : putCsvQuoted(at, lexeme);
+            at = put(at, "\"\n", 2);
+            break;
+    }
+    used += static_cast<size_t>(at - start);
+}
+
+void NhykTokenWriter::write(const std::vector<Token>& tokens, std::string_view source) {
+    begin();
+    const bool positioned = !source.empty();
+    for (const Token& token : tokens) {
+        std::string_view lexeme = token.getLexeme();
+        uint32_t offset = positioned ? static_cast<uint32_t>(lexeme.data() - source.data()) : 0;
+        row(token.getType(), lexeme, positioned, offset);
+    }
+}
+
+void NhykTokenWriter::write(const TokenBuffer& tokens) {
+    begin();
+    const size_t count = tokens.size();
+    for (size_t i = 0; i < count; ++i)
+        row(tokens.kind(i), tokens.lexeme(i), true, tokens.offset(i));
+}
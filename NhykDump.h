@@ -0,0 +1,84 @@
+#ifndef NHYKDUMP_H_INCLUDED
+#define NHYKDUMP_H_INCLUDED
+
+/**
+ * @file NhykDump.h
+ * @brief Defines NhykTokenWriter, which prints token lists as a table, JSON lines or CSV.
+ *
+ * Tokens are formatted straight into one reusable byte buffer: each row is a memcpy of
+ * a prefix precomputed per token type, the lexeme, and for JSON and CSV the position
+ * written with std::to_chars. The buffer goes to its FILE* or std::ostream in a single
+ * fwrite or write when it fills and when the writer is flushed or destroyed.
+ *
+ *   TABLE       the format of operator<< on std::vector<Token> (and doc/Lexar.txt)
+ *   JSON_LINES  {"type":"IDENTIFIER","lexeme":"x","offset":12,"length":1} per line
+ *   CSV         a "type,offset,length,lexeme" header, then one row per token
+ *
+ * Offsets are known for a TokenBuffer, and for a vector of tokens when the source they
+ * view is given; otherwise JSON lines leave them out and CSV leaves the fields empty.
+ * Lexemes are escaped for JSON ('"', '\\' and control bytes) and quoted for CSV; other
+ * bytes, including non-ASCII ones, are written unchanged.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "Token.h"
+
+class TokenBuffer;
+
+enum class NhykDumpFormat : uint8_t {
+    TABLE,
+    JSON_LINES,
+    CSV
+};
+
+class NhykTokenWriter {
+public:
+    static constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+    explicit NhykTokenWriter(std::FILE* file, NhykDumpFormat format = NhykDumpFormat::TABLE,
+                             size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    explicit NhykTokenWriter(std::ostream& stream, NhykDumpFormat format = NhykDumpFormat::TABLE,
+                             size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    // Flushes what is still buffered.
+    ~NhykTokenWriter();
+    NhykTokenWriter(const NhykTokenWriter&) = delete;
+    NhykTokenWriter& operator=(const NhykTokenWriter&) = delete;
+
+    // Writes 'tokens', preceded by the table header (each call) or the CSV header (the
+    // first call). With 'source' given, offsets are taken relative to it.
+    void write(const std::vector<Token>& tokens, std::string_view source = std::string_view());
+    void write(const TokenBuffer& tokens);
+
+    // Hands the buffered bytes to the file or stream.
+    void flush();
+    // False once a flush has failed.
+    bool good() const {return ok;}
+
+private:
+    std::FILE* file;
+    std::ostream* stream;
+    NhykDumpFormat format;
+    std::unique_ptr<char[]> buffer;
+    size_t capacity;
+    size_t used;
+    bool headerWritten;                // CSV header, written once per writer.
+    bool ok;
+
+    void begin();
+    void row(TokenType type, std::string_view lexeme, bool positioned, uint32_t offset);
+    void append(const char* data, size_t size);
+    // Makes room for 'size' contiguous bytes, flushing (or growing) if needed.
+    char* reserve(size_t size);
+};
+
+#endif // NHYKDUMP_H_INCLUDED
@@ -0,0 +1,136 @@
+#include "NhykIncremental.h"
+#include <algorithm>
+#include <climits>
+#include <stdexcept>
+/**
+ * @file NhykIncremental.cpp
+ * @brief Implementation of the incremental re-lexer.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+NhykIncrementalLexer::NhykIncrementalLexer(std::string initial) : lexer(std::string()) {
+    lexer.setErrorLimit(0);
+    setText(std::move(initial));
+}
+
+uint32_t NhykIncrementalLexer::horizon(size_t i) const {
+    return tokens.offset(i) + tokens.length(i) + horizonAhead[i];
+}
+
+void NhykIncrementalLexer::setText(std::string newText) {
+    if (newText.size() >= UINT_MAX)
+        throw std::length_error("NhykIncrementalLexer: document larger than 4 GiB");
+    text = std::move(newText);
+    tokens.reset(text);
+    ahead.clear();
+    horizonAhead.clear();
+
+    lexer.setSourceView(text);
+    uint32_t far = 0;
+    for (Token token = lexer.next(); token.getType() != TokenType::END_OF_INPUT; token = lexer.next()) {
+        const uint32_t end = lexer.offsetOf(token) + static_cast<uint32_t>(token.getLexeme().size());
+        tokens.push(token, lexer.offsetOf(token));
+        far = std::max<uint32_t>(far, lexer.getReach());
+        ahead.push_back(lexer.getReach() - end);
+        horizonAhead.push_back(far - end);
+    }
+}
+
+void NhykIncrementalLexer::resetSymbols() {
+    lexer.getSymbolTable()->clear();
+    setText(std::move(text));
+}
+
+/**
+ * @brief Applies one edit to the text and re-lexes the part of it that can change.
+ *
+ * @details See NhykIncremental.h for the restart, resync and splice steps. The old
+ * tokens that lexing is compared against are looked up by their start offset, shifted
+ * by the size change; they are found with a forward-moving cursor, so the whole update
+ * is linear in the number of re-lexed tokens plus the cost of moving the tail. Reaches
+ * are stored relative to the end of their token, so only the offsets column has to be
+ * shifted.
+ *
+ * @param offset First byte replaced.
+ * @param removed Number of bytes replaced.
+ * @param inserted Replacement text.
+ * @return Which rows of the token buffer changed.
+ */
+NhykTokenEdit NhykIncrementalLexer::applyEdit(size_t offset, size_t removed, std::string_view inserted) {
+    if (offset > text.size() || removed > text.size() - offset)
+        throw std::out_of_range("NhykIncrementalLexer: edit outside the text");
+    if (text.size() - removed + inserted.size() >= UINT_MAX)
+        throw std::length_error("NhykIncrementalLexer: document larger than 4 GiB");
+    const int64_t delta = static_cast<int64_t>(inserted.size()) - static_cast<int64_t>(removed);
+
+    // Keep the tokens whose walks all stopped at or before the edit: the horizon is
+    // non-decreasing, so they form a prefix.
+    NhykTokenEdit edit;
+    size_t low = 0, high = tokens.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (horizon(middle) <= offset) low = middle + 1;
+        else high = middle;
+    }
+    edit.first = low;
+    const uint32_t restart = edit.first == 0 ? 0 : tokens.offset(edit.first - 1) + tokens.length(edit.first - 1);
+
+    text.replace(offset, removed, inserted.data(), inserted.size());
+    tokens.rebase(text);
+
+    // Old tokens from 'oldIndex' on start after the removed bytes; one of them is where
+    // the new token stream may rejoin the old one.
+    const uint32_t* oldOffsets = tokens.offsetData();
+    const size_t oldCount = tokens.size();
+    size_t oldIndex = static_cast<size_t>(std::lower_bound(oldOffsets + edit.first, oldOffsets + oldCount,
+                                                           static_cast<uint32_t>(offset + removed)) - oldOffsets);
+    const size_t editEnd = offset + inserted.size();
+
+    fresh.reset(text, 16);
+    freshAhead.clear();
+    lexer.setSourceView(text);
+    lexer.seek(restart);
+    bool resynced = false;
+    for (Token token = lexer.next(); token.getType() != TokenType::END_OF_INPUT; token = lexer.next()) {
+        const uint32_t start = lexer.offsetOf(token);
+        if (start >= editEnd) {
+            const uint32_t oldStart = static_cast<uint32_t>(start - delta);
+            while (oldIndex < oldCount && oldOffsets[oldIndex] < oldStart) ++oldIndex;
+            if (oldIndex < oldCount && oldOffsets[oldIndex] == oldStart) {
+                resynced = true;
+                break;
+            }
+        }
+        const uint32_t length = static_cast<uint32_t>(token.getLexeme().size());
+        fresh.push(token, start);
+        freshAhead.push_back(lexer.getReach() - (start + length));
+    }
+    // Without a resync the new tokens run to the end and replace every old one.
+    if (!resynced) oldIndex = oldCount;
+    edit.removed = oldIndex - edit.first;
+    edit.inserted = fresh.size();
+
+    // Splice the new rows in and move everything after them.
+    tokens.splice(edit.first, edit.removed, fresh);
+    const size_t tail = edit.first + edit.inserted;
+    if (delta != 0) tokens.shift(tail, delta);
+    nhykSpliceColumn(ahead, edit.first, edit.removed, freshAhead);
+    nhykSpliceColumn(horizonAhead, edit.first, edit.removed, freshAhead);
+
+    // Recompute the running maximum until it agrees with the old values again; from
+    // there on the old relative horizons are still right.
+    uint32_t far = edit.first == 0 ? 0 : horizon(edit.first - 1);
+    for (size_t i = edit.first; i < tokens.size(); ++i) {
+        const uint32_t end = tokens.offset(i) + tokens.length(i);
+        const uint32_t old = end + horizonAhead[i];
+        far = std::max(far, end + ahead[i]);
+        horizonAhead[i] = far - end;
+        if (i >= tail && far == old) break;
+    }
+    return edit;
+}
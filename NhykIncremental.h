@@ -0,0 +1,88 @@
+#ifndef NHYKINCREMENTAL_H_INCLUDED
+#define NHYKINCREMENTAL_H_INCLUDED
+
+/**
+ * @file NhykIncremental.h
+ * @brief Defines NhykIncrementalLexer, which keeps a document's tokens current under edits.
+ *
+ * The lexer owns the document text and its tokens (a TokenBuffer). applyEdit() changes
+ * the text and re-lexes only what the edit can affect:
+ *
+ *  - Restart. Every token records its reach, the end of the bytes its DFA walk looked at
+ *    (NhykLexer::getReach()). A token whose reach is at or before the edit offset cannot
+ *    change. The horizon, the running maximum of the reaches, lets a binary search find
+ *    the longest prefix of tokens that is safe to keep; lexing restarts at its end.
+ *  - Resync. Lexing is context-free from any token start, so once a re-lexed token starts
+ *    past the inserted text at the (shifted) start of an old token, the old tokens from
+ *    there on are still right and lexing stops.
+ *  - Splice. The re-lexed tokens replace the old ones between the two points, and the
+ *    offsets of the rest are shifted by the size change.
+ *
+ * A one-character edit re-lexes a token or two. The remaining cost is moving the text
+ * after the edit and adding the size change to the offsets after it (nhykAddEach).
+ *
+ * Re-lexed tokens are interned into the lexer's symbol table, which never forgets a
+ * name: typing "counter" interns "c", "co", "cou" and so on as it goes. That is what
+ * keeps symbol ids stable across edits, but a long editing session grows the table
+ * without bound. getSymbols().size() tells how far it has grown; resetSymbols() drops
+ * the dead names at the price of a full re-lex and new ids.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LexGraph.h"
+#include "TokenBuffer.h"
+
+// Which tokens an edit replaced: rows [first, first + removed) of the old buffer became
+// rows [first, first + inserted) of the new one. Later rows only moved.
+struct NhykTokenEdit {
+    size_t first = 0;
+    size_t removed = 0;
+    size_t inserted = 0;
+};
+
+class NhykIncrementalLexer {
+public:
+    explicit NhykIncrementalLexer(std::string text = std::string());
+    NhykIncrementalLexer(const NhykIncrementalLexer&) = delete;
+    NhykIncrementalLexer& operator=(const NhykIncrementalLexer&) = delete;
+
+    // Replaces the whole document and lexes it from scratch.
+    void setText(std::string newText);
+
+    // Replaces 'removed' bytes at 'offset' with 'inserted' and updates the tokens.
+    // Throws std::out_of_range if the range is not inside the text.
+    NhykTokenEdit applyEdit(size_t offset, size_t removed, std::string_view inserted);
+
+    std::string_view getText() const {return text;}
+    // Tokens of the current text; lexemes view getText().
+    const TokenBuffer& getTokens() const {return tokens;}
+    // Symbol ids stay stable across edits, so the table keeps every name ever lexed,
+    // including those of tokens since edited away.
+    const NhykSymbolTable& getSymbols() const {return *lexer.getSymbolTable();}
+    // Empties the symbol table and re-lexes the whole text, so that it holds only the
+    // names of the current tokens. Ids change: symbol ids taken earlier are invalid.
+    void resetSymbols();
+
+private:
+    std::string text;
+    TokenBuffer tokens;
+    // Both relative to the end of each token, so they survive shifting unchanged:
+    std::vector<uint32_t> ahead;       // NhykLexer::getReach() of the token.
+    std::vector<uint32_t> horizonAhead;// Running maximum of the reaches up to the token.
+    NhykLexer lexer;
+    TokenBuffer fresh;                 // Scratch rows for the re-lexed tokens.
+    std::vector<uint32_t> freshAhead;
+
+    // Absolute horizon of token i.
+    uint32_t horizon(size_t i) const;
+};
+
+#endif // NHYKINCREMENTAL_H_INCLUDED
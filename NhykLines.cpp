@@ -0,0 +1,44 @@
+#include "NhykLines.h"
+#include "NhykScan.h"
+#include <algorithm>
+/**
+ * @file NhykLines.cpp
+ * @brief Implementation of the line-start index.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+void NhykLineIndex::build(std::string_view text) {
+    source = text;
+    starts.clear();
+    // Typical source lines are a few dozen bytes; one reservation avoids regrowth.
+    starts.reserve(text.size() / 32 + 1);
+    starts.push_back(0);
+    nhykLineStarts(text.data(), text.size(), starts);
+}
+
+void NhykLineIndex::clear() {
+    source = std::string_view();
+    starts.clear();
+}
+
+NhykLocation NhykLineIndex::locate(uint32_t offset) const {
+    NhykLocation location;
+    if (starts.empty()) return location;
+    if (offset > source.size()) offset = static_cast<uint32_t>(source.size());
+    // The line is the last one starting at or before 'offset'.
+    size_t line = static_cast<size_t>(std::upper_bound(starts.begin(), starts.end(), offset) - starts.begin());
+    location.line = static_cast<uint32_t>(line);
+    location.column = offset - starts[line - 1] + 1;
+    return location;
+}
+
+std::string_view NhykLineIndex::lineText(size_t line) const {
+    uint32_t begin = starts[line - 1];
+    uint32_t end = line < starts.size() ? starts[line] - 1 : static_cast<uint32_t>(source.size());
+    return source.substr(begin, end - begin);
+}
@@ -0,0 +1,57 @@
+#ifndef NHYKLINES_H_INCLUDED
+#define NHYKLINES_H_INCLUDED
+
+/**
+ * @file NhykLines.h
+ * @brief Defines NhykLineIndex, which turns byte offsets into line and column numbers.
+ *
+ * Tokens only know where they are as a byte offset into the source. When a location
+ * is needed (a diagnostic, an editor hover) the index of line start offsets is built
+ * once, with a vectorized newline scan, and each lookup is a binary search over it.
+ * Nothing is counted while lexing.
+ *
+ * Lines and columns are 1-based; a column counts bytes from the start of the line.
+ * Only '\n' ends a line, so a "\r\n" file reports the '\r' as the line's last column.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+struct NhykLocation {
+    uint32_t line = 1;
+    uint32_t column = 1;
+};
+
+class NhykLineIndex {
+public:
+    NhykLineIndex() {}
+    explicit NhykLineIndex(std::string_view source) {build(source);}
+
+    // Indexes 'source', which must outlive the index for lineText().
+    void build(std::string_view source);
+    // Forgets the source; built() is false until the next build().
+    void clear();
+    bool built() const {return !starts.empty();}
+
+    // Line and column of byte 'offset' (offsets past the end map to the end).
+    NhykLocation locate(uint32_t offset) const;
+
+    size_t lineCount() const {return starts.size();}
+    // Offset of the first byte of 1-based line 'line'.
+    uint32_t lineStart(size_t line) const {return starts[line - 1];}
+    // Text of 1-based line 'line', without its '\n'.
+    std::string_view lineText(size_t line) const;
+
+private:
+    std::string_view source;
+    std::vector<uint32_t> starts;      // starts[i] = offset of line i + 1; starts[0] = 0.
+};
+
+#endif // NHYKLINES_H_INCLUDED
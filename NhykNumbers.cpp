@@ -0,0 +1,32 @@
+#include "NhykNumbers.h"
+#include <charconv>
+#include <limits>
+#include <system_error>
+/**
+ * @file NhykNumbers.cpp
+ * @brief Implementation of the floating-point literal conversion.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+bool nhykParseDouble(std::string_view text, double& value) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    std::from_chars_result result = std::from_chars(first, last, value, std::chars_format::fixed);
+    if (result.ec != std::errc::result_out_of_range) return true;
+
+    // Out of range either way: too large if any digit before the point is not zero,
+    // otherwise too small (a long run of zeros after the point), which rounds to zero.
+    for (const char* at = first; at != last && *at != '.'; ++at) {
+        if (*at != '0') {
+            value = std::numeric_limits<double>::infinity();
+            return false;
+        }
+    }
+    value = 0.0;
+    return true;
+}
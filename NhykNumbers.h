@@ -0,0 +1,56 @@
+#ifndef NHYKNUMBERS_H_INCLUDED
+#define NHYKNUMBERS_H_INCLUDED
+
+/**
+ * @file NhykNumbers.h
+ * @brief Converts the text of numeric literals to their values.
+ *
+ * The lexer calls these once per INT_LITERAL and DOUBLE_LITERAL token, right after the
+ * DFA has matched it, so the digits are still in cache and are known to be well formed:
+ * no sign, no exponent, no stray characters. Integers are accumulated in one pass with
+ * an overflow check only past the 19th digit; doubles go through std::from_chars, which
+ * rounds correctly without the locale and allocation of strtod or std::stod.
+ *
+ * Both functions return false when the constant cannot be represented and then store the
+ * nearest value that can (INT64_MAX, or infinity), so callers can report the error and
+ * carry on.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <string_view>
+
+// Value of the digits of an INT_LITERAL ("[0-9]+"); false if it exceeds INT64_MAX.
+inline bool nhykParseInt(std::string_view digits, int64_t& value) {
+    const size_t size = digits.size();
+    // Nineteen decimal digits always fit in 64 unsigned bits.
+    const size_t safe = size < 19 ? size : 19;
+    uint64_t result = 0;
+    size_t i = 0;
+    for (; i < safe; ++i) result = result * 10 + static_cast<unsigned>(digits[i] - '0');
+    for (; i < size; ++i) {
+        const unsigned digit = static_cast<unsigned>(digits[i] - '0');
+        if (result > (UINT64_MAX - digit) / 10) {
+            value = INT64_MAX;
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    if (result > static_cast<uint64_t>(INT64_MAX)) {
+        value = INT64_MAX;
+        return false;
+    }
+    value = static_cast<int64_t>(result);
+    return true;
+}
+
+// Value of a DOUBLE_LITERAL ("[0-9]+\.[0-9]*"), correctly rounded; false if it is too large
+// for a double. Constants too small to represent round to zero and are not errors.
+bool nhykParseDouble(std::string_view text, double& value);
+
+#endif // NHYKNUMBERS_H_INCLUDED
@@ -0,0 +1,457 @@
+#include "NhykOptimizer.h"
+#include <vector>
+/**
+ * @file NhykOptimizer.cpp
+ * @brief Implementation of constant folding, membership sets and dead branch removal.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+bool isNumber(const NhykValue& value) {
+    return value.type == NhykType::INTEGER || value.type == NhykType::DOUBLE;
+}
+
+double toDouble(const NhykValue& value) {
+    return value.type == NhykType::INTEGER ? static_cast<double>(value.integer) : value.real;
+}
+
+// INTEGER arithmetic wraps around, as in NhykVM.
+int64_t wrap(uint64_t value) {
+    return static_cast<int64_t>(value);
+}
+
+template <typename T>
+bool order(NhykOp op, const T& x, const T& y) {
+    switch (op) {
+        case NhykOp::LT: return x < y;
+        case NhykOp::LE: return x <= y;
+        case NhykOp::GT: return x > y;
+        default:         return x >= y;
+    }
+}
+
+} // namespace
+
+// --- NhykOptimizer Implementation ---
+
+NhykOptimizer::NhykOptimizer(NhykSymbolTable& names)
+    : names(names), ast(nullptr), scope(NhykAst::NO_NODE) {}
+
+void NhykOptimizer::optimize(NhykAst& tree) {
+    ast = &tree;
+    stats = NhykOptimizerStats();
+    bindings.clear();
+    scope = NhykAst::NO_NODE;
+    const uint32_t root = ast->getRoot();
+    if (root == NhykAst::NO_NODE) return;
+    bool hasFunction = false;
+    countBindings(root, NhykAst::NO_NODE, bindings, hasFunction);
+    statement(root);
+}
+
+// --- Bindings ---
+
+// Adds the names bound by statement 'id', which runs in scope 'inScope', to 'into'.
+void NhykOptimizer::countBindings(uint32_t id, uint32_t inScope, BindingMap& into, bool& hasFunction) const {
+    if (id == NhykAst::NO_NODE) return;
+    const NhykNode& n = (*ast)[id];
+    switch (n.kind) {
+        case NhykNodeKind::PROGRAM:
+        case NhykNodeKind::BLOCK:
+        case NhykNodeKind::CASE:
+            for (uint32_t child : ast->list(id)) countBindings(child, inScope, into, hasFunction);
+            break;
+        case NhykNodeKind::VAR:
+            for (uint32_t decl : ast->list(id)) {
+                Bindings& b = into[keyOf(inScope, (*ast)[decl].symbol)];
+                ++b.all;
+                ++b.declared;
+            }
+            break;
+        case NhykNodeKind::FUNC:
+            hasFunction = true;
+            for (uint32_t param : ast->list(id)) {
+                Bindings& b = into[keyOf(id, (*ast)[param].symbol)];
+                ++b.all;
+                ++b.declared;
+            }
+            countBindings(n.a, id, into, hasFunction);
+            break;
+        case NhykNodeKind::ASSIGN:
+        case NhykNodeKind::INPUT:
+            ++into[keyOf(inScope, n.symbol)].all;
+            break;
+        case NhykNodeKind::IF:
+            countBindings(n.b, inScope, into, hasFunction);
+            countBindings(n.c, inScope, into, hasFunction);
+            break;
+        case NhykNodeKind::WHILE:
+            countBindings(n.b, inScope, into, hasFunction);
+            break;
+        case NhykNodeKind::FOR: {
+            Bindings& b = into[keyOf(inScope, n.symbol)];
+            ++b.all;
+            ++b.declared;
+            countBindings(n.c, inScope, into, hasFunction);
+            break;
+        }
+        case NhykNodeKind::MATCH:
+            for (uint32_t arm : ast->list(id)) countBindings(arm, inScope, into, hasFunction);
+            break;
+        default:
+            break;
+    }
+}
+
+// Whether the statements ids[0, count) can be dropped without changing the functions
+// or any scope's variables. On success their bindings are left in 'removed' for remove().
+bool NhykOptimizer::removable(const uint32_t* ids, size_t count) {
+    removed.clear();
+    bool hasFunction = false;
+    for (size_t k = 0; k < count; ++k) countBindings(ids[k], scope, removed, hasFunction);
+    if (hasFunction) return false;
+    for (const auto& entry : removed) {
+        const Bindings& all = bindings[entry.first];
+        if (all.all <= entry.second.all) return false;
+        if (entry.second.declared != 0 && all.declared <= entry.second.declared) return false;
+    }
+    return true;
+}
+
+void NhykOptimizer::remove() {
+    for (const auto& entry : removed) {
+        Bindings& all = bindings[entry.first];
+        all.all -= entry.second.all;
+        all.declared -= entry.second.declared;
+    }
+    removed.clear();
+    ++stats.branches;
+}
+
+// --- Node rewriting ---
+
+bool NhykOptimizer::isLiteral(uint32_t id) const {
+    switch ((*ast)[id].kind) {
+        case NhykNodeKind::INT:
+        case NhykNodeKind::DOUBLE:
+        case NhykNodeKind::BOOL:
+        case NhykNodeKind::STRING:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Whether 'id' gives a BOOL whenever it gives a value at all.
+bool NhykOptimizer::isBoolean(uint32_t id) const {
+    const NhykNode& n = (*ast)[id];
+    switch (n.kind) {
+        case NhykNodeKind::BOOL:
+            return true;
+        case NhykNodeKind::UNARY:
+            return n.op == NhykOp::NOT;
+        case NhykNodeKind::BINARY:
+            return n.op != NhykOp::ADD && n.op != NhykOp::SUB && n.op != NhykOp::MUL && n.op != NhykOp::DIV;
+        default:
+            return false;
+    }
+}
+
+NhykValue NhykOptimizer::valueOf(uint32_t id) const {
+    const NhykNode& n = (*ast)[id];
+    switch (n.kind) {
+        case NhykNodeKind::INT:    return NhykValue::ofInt(ast->getInt(id));
+        case NhykNodeKind::DOUBLE: return NhykValue::ofDouble(ast->getDouble(id));
+        case NhykNodeKind::BOOL:   return NhykValue::ofBool(n.a != 0);
+        case NhykNodeKind::STRING: return NhykValue::ofString(n.symbol);
+        default:                   return NhykValue::none();
+    }
+}
+
+// Turns node 'id' into the literal 'value', keeping its token.
+void NhykOptimizer::setLiteral(uint32_t id, const NhykValue& value) {
+    uint32_t a = NhykAst::NO_NODE;
+    uint32_t symbol = NhykSymbolTable::NO_SYMBOL;
+    NhykNodeKind kind = NhykNodeKind::BOOL;
+    switch (value.type) {
+        case NhykType::INTEGER: kind = NhykNodeKind::INT; a = ast->addInt(value.integer); break;
+        case NhykType::DOUBLE:  kind = NhykNodeKind::DOUBLE; a = ast->addDouble(value.real); break;
+        case NhykType::STRING:  kind = NhykNodeKind::STRING; symbol = value.symbol; break;
+        default:                a = value.boolean ? 1 : 0; break;
+    }
+    NhykNode& n = (*ast)[id];
+    n.kind = kind;
+    n.op = NhykOp::NONE;
+    n.symbol = symbol;
+    n.a = a;
+    n.b = NhykAst::NO_NODE;
+    n.c = NhykAst::NO_NODE;
+    ++stats.folded;
+}
+
+// Makes node 'id' a copy of node 'with', so whatever refers to 'id' now sees 'with'.
+void NhykOptimizer::replace(uint32_t id, uint32_t with) {
+    (*ast)[id] = (*ast)[with];
+}
+
+void NhykOptimizer::makeEmptyBlock(uint32_t id) {
+    NhykNode& n = (*ast)[id];
+    n.kind = NhykNodeKind::BLOCK;
+    n.op = NhykOp::NONE;
+    n.symbol = NhykSymbolTable::NO_SYMBOL;
+    n.a = NhykAst::NO_NODE;
+    n.b = 0;
+    n.c = 0;
+}
+
+// --- Statements ---
+
+void NhykOptimizer::statement(uint32_t id) {
+    if (id == NhykAst::NO_NODE) return;
+    const NhykNode n = (*ast)[id];
+    switch (n.kind) {
+        case NhykNodeKind::PROGRAM:
+        case NhykNodeKind::BLOCK:
+            for (uint32_t child : ast->list(id)) statement(child);
+            break;
+        case NhykNodeKind::VAR:
+            for (uint32_t decl : ast->list(id)) {
+                if ((*ast)[decl].a != NhykAst::NO_NODE) expression((*ast)[decl].a);
+            }
+            break;
+        case NhykNodeKind::FUNC: {
+            const uint32_t outer = scope;
+            scope = id;
+            statement(n.a);
+            scope = outer;
+            break;
+        }
+        case NhykNodeKind::ASSIGN:
+        case NhykNodeKind::RETURN:
+        case NhykNodeKind::EXPRESSION:
+            if (n.a != NhykAst::NO_NODE) expression(n.a);
+            break;
+        case NhykNodeKind::IF:
+            ifStatement(id);
+            break;
+        case NhykNodeKind::WHILE:
+            expression(n.a);
+            statement(n.b);
+            if ((*ast)[n.a].kind == NhykNodeKind::BOOL && (*ast)[n.a].a == 0 && removable(&n.b, 1)) {
+                remove();
+                makeEmptyBlock(id);
+            }
+            break;
+        case NhykNodeKind::FOR:
+            expression(n.a);
+            expression(n.b);
+            statement(n.c);
+            break;
+        case NhykNodeKind::MATCH:
+            matchStatement(id);
+            break;
+        case NhykNodeKind::OUTPUT:
+            for (uint32_t value : ast->list(id)) expression(value);
+            break;
+        default:
+            break;
+    }
+}
+
+// An ELIF is an IF in the ELSE branch, so a chain is reduced from its end.
+void NhykOptimizer::ifStatement(uint32_t id) {
+    const NhykNode n = (*ast)[id];
+    expression(n.a);
+    statement(n.b);
+    statement(n.c);
+    const NhykNode& condition = (*ast)[n.a];
+    if (condition.kind != NhykNodeKind::BOOL) return;
+    const uint32_t live = condition.a != 0 ? n.b : n.c;
+    const uint32_t dead = condition.a != 0 ? n.c : n.b;
+    if (!removable(&dead, dead != NhykAst::NO_NODE ? 1 : 0)) return;
+    remove();
+    if (live == NhykAst::NO_NODE) makeEmptyBlock(id);
+    else replace(id, live);
+}
+
+// A MATCH on a literal, with literal arm values, becomes the arm it would run.
+void NhykOptimizer::matchStatement(uint32_t id) {
+    const uint32_t subject = (*ast)[id].a;
+    expression(subject);
+    bool constant = isLiteral(subject);
+    for (uint32_t arm : ast->list(id)) {
+        const uint32_t value = (*ast)[arm].a;
+        if (value != NhykAst::NO_NODE) {
+            expression(value);
+            constant = constant && isLiteral(value);
+        }
+        for (uint32_t child : ast->list(arm)) statement(child);
+    }
+    if (!constant) return;
+
+    const NhykValue x = valueOf(subject);
+    uint32_t chosen = NhykAst::NO_NODE;
+    uint32_t fallback = NhykAst::NO_NODE;
+    for (uint32_t arm : ast->list(id)) {
+        const uint32_t value = (*ast)[arm].a;
+        if (value == NhykAst::NO_NODE) fallback = arm;
+        else if (chosen == NhykAst::NO_NODE && nhykScalarEqual(x, valueOf(value))) chosen = arm;
+    }
+    if (chosen == NhykAst::NO_NODE) chosen = fallback;
+    std::vector<uint32_t> dead;
+    for (uint32_t arm : ast->list(id)) {
+        if (arm != chosen) dead.push_back(arm);
+    }
+    if (!removable(dead.data(), dead.size())) return;
+    remove();
+    if (chosen == NhykAst::NO_NODE) {
+        makeEmptyBlock(id);
+    } else {
+        replace(id, chosen);
+        NhykNode& n = (*ast)[id];
+        n.kind = NhykNodeKind::BLOCK;
+        n.a = NhykAst::NO_NODE;
+    }
+}
+
+// --- Expressions ---
+
+void NhykOptimizer::expression(uint32_t id) {
+    const NhykNode n = (*ast)[id];
+    switch (n.kind) {
+        case NhykNodeKind::UNARY:
+            expression(n.a);
+            unary(id);
+            break;
+        case NhykNodeKind::BINARY:
+            expression(n.a);
+            expression(n.b);
+            binary(id);
+            break;
+        case NhykNodeKind::LIST:
+        case NhykNodeKind::CALL:
+            for (uint32_t child : ast->list(id)) expression(child);
+            break;
+        default:
+            break;
+    }
+}
+
+void NhykOptimizer::unary(uint32_t id) {
+    const NhykNode& n = (*ast)[id];
+    const NhykNodeKind kind = (*ast)[n.a].kind;
+    if (n.op == NhykOp::NEG && kind == NhykNodeKind::INT)
+        setLiteral(id, NhykValue::ofInt(wrap(0 - static_cast<uint64_t>(ast->getInt(n.a)))));
+    else if (n.op == NhykOp::NEG && kind == NhykNodeKind::DOUBLE)
+        setLiteral(id, NhykValue::ofDouble(-ast->getDouble(n.a)));
+    else if (n.op == NhykOp::NOT && kind == NhykNodeKind::BOOL)
+        setLiteral(id, NhykValue::ofBool((*ast)[n.a].a == 0));
+}
+
+void NhykOptimizer::binary(uint32_t id) {
+    const NhykNode n = (*ast)[id];
+    if (n.op == NhykOp::AND) {
+        // The right operand is skipped after FALSE, and otherwise must be a BOOL.
+        if ((*ast)[n.a].kind == NhykNodeKind::BOOL) {
+            if ((*ast)[n.a].a == 0) {
+                setLiteral(id, NhykValue::ofBool(false));
+            } else if (isBoolean(n.b)) {
+                replace(id, n.b);
+                ++stats.folded;
+            }
+        } else if ((*ast)[n.b].kind == NhykNodeKind::BOOL && (*ast)[n.b].a != 0 && isBoolean(n.a)) {
+            replace(id, n.a);
+            ++stats.folded;
+        }
+        return;
+    }
+
+    if (n.op == NhykOp::IN || n.op == NhykOp::NOT_IN) {
+        if ((*ast)[n.b].kind != NhykNodeKind::LIST) return;
+        NhykNodeList items = ast->list(n.b);
+        for (uint32_t item : items) {
+            if (!isLiteral(item)) return;
+        }
+        if (isLiteral(n.a)) {
+            const NhykValue x = valueOf(n.a);
+            bool found = false;
+            for (uint32_t item : items) {
+                if (nhykScalarEqual(x, valueOf(item))) {
+                    found = true;
+                    break;
+                }
+            }
+            setLiteral(id, NhykValue::ofBool(found == (n.op == NhykOp::IN)));
+        } else {
+            (*ast)[n.b].kind = NhykNodeKind::SET;
+            ++stats.sets;
+        }
+        return;
+    }
+
+    NhykValue result;
+    if (isLiteral(n.a) && isLiteral(n.b) && fold(n.op, valueOf(n.a), valueOf(n.b), result))
+        setLiteral(id, result);
+}
+
+// Computes 'x op y' as NhykVM would. Returns false, leaving the operation to run and
+// fail at run time, when the VM would report an error.
+bool NhykOptimizer::fold(NhykOp op, const NhykValue& x, const NhykValue& y, NhykValue& result) {
+    const bool integers = x.type == NhykType::INTEGER && y.type == NhykType::INTEGER;
+    const bool numbers = isNumber(x) && isNumber(y);
+    const uint64_t ux = static_cast<uint64_t>(x.integer);
+    const uint64_t uy = static_cast<uint64_t>(y.integer);
+    switch (op) {
+        case NhykOp::ADD:
+            if (integers) result = NhykValue::ofInt(wrap(ux + uy));
+            else if (numbers) result = NhykValue::ofDouble(toDouble(x) + toDouble(y));
+            else if (x.type == NhykType::STRING && y.type == NhykType::STRING) {
+                joined.assign(names.name(x.symbol));
+                joined.append(names.name(y.symbol));
+                result = NhykValue::ofString(names.intern(joined));
+            } else return false;
+            return true;
+        case NhykOp::SUB:
+            if (integers) result = NhykValue::ofInt(wrap(ux - uy));
+            else if (numbers) result = NhykValue::ofDouble(toDouble(x) - toDouble(y));
+            else return false;
+            return true;
+        case NhykOp::MUL:
+            if (integers) result = NhykValue::ofInt(wrap(ux * uy));
+            else if (numbers) result = NhykValue::ofDouble(toDouble(x) * toDouble(y));
+            else return false;
+            return true;
+        case NhykOp::DIV:
+            if (integers) {
+                if (y.integer == 0) return false;
+                result = NhykValue::ofInt(y.integer == -1 ? wrap(0 - ux) : x.integer / y.integer);
+            } else if (numbers) {
+                result = NhykValue::ofDouble(toDouble(x) / toDouble(y));
+            } else {
+                return false;
+            }
+            return true;
+        case NhykOp::EQ:
+        case NhykOp::NE:
+            result = NhykValue::ofBool(nhykScalarEqual(x, y) == (op == NhykOp::EQ));
+            return true;
+        case NhykOp::LT:
+        case NhykOp::LE:
+        case NhykOp::GT:
+        case NhykOp::GE:
+            if (integers) result = NhykValue::ofBool(order(op, x.integer, y.integer));
+            else if (numbers) result = NhykValue::ofBool(order(op, toDouble(x), toDouble(y)));
+            else if (x.type == NhykType::STRING && y.type == NhykType::STRING)
+                result = NhykValue::ofBool(order(op, names.name(x.symbol), names.name(y.symbol)));
+            else return false;
+            return true;
+        default:
+            return false;
+    }
+}
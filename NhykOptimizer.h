@@ -0,0 +1,100 @@
+#ifndef NHYKOPTIMIZER_H_INCLUDED
+#define NHYKOPTIMIZER_H_INCLUDED
+
+/**
+ * @file NhykOptimizer.h
+ * @brief Defines NhykOptimizer, which simplifies an NhykAst before it is compiled.
+ *
+ * The pass rewrites the tree in place, children before parents, so each
+ * simplification can enable the next:
+ *
+ *   - Operators whose operands are all INTEGER, DOUBLE, BOOL or STRING literals are
+ *     folded into a literal, with exactly the results NhykVM would compute (INTEGER
+ *     arithmetic wraps, "a" + "b" is interned as "ab"). An operation that would fail
+ *     at run time, such as an INTEGER division by zero, is left for the VM to report.
+ *     AND with a FALSE left operand is FALSE, and TRUE AND x is x when x is a BOOL.
+ *   - A list of literals after IS IN or IS NOT IN becomes a SET node, which the
+ *     compiler turns into a hash set probed in constant time.
+ *   - IF (with its ELIF and ELSE arms) and MATCH with a constant condition or subject
+ *     are replaced by the one branch that can run, and WHILE FALSE by nothing.
+ *
+ * Removing code must not change which names are variables or which functions exist,
+ * since the compiler derives both from the tree. So a branch is only dropped if it
+ * defines no FUNC and every name it declares or assigns is also declared or assigned
+ * elsewhere in the same function (or, outside functions, in the main program).
+ * Otherwise the branch stays, and the compiler skips it, having seen its names.
+ *
+ * Removed nodes stay in the tree's arrays, unreferenced; ids are never reused.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "NhykAst.h"
+#include "NhykBytecode.h"
+#include "NhykSymbols.h"
+
+struct NhykOptimizerStats {
+    size_t folded = 0;                 // Expressions replaced by a literal.
+    size_t sets = 0;                   // Lists turned into hash sets.
+    size_t branches = 0;               // IF, WHILE and MATCH statements reduced to their live code.
+};
+
+class NhykOptimizer {
+public:
+    // Strings made by folding are interned into 'names', the tree's symbol table.
+    explicit NhykOptimizer(NhykSymbolTable& names);
+    NhykOptimizer(const NhykOptimizer&) = delete;
+    NhykOptimizer& operator=(const NhykOptimizer&) = delete;
+
+    // Simplifies 'ast' in place. The tree should come from a parse without errors.
+    void optimize(NhykAst& ast);
+
+    const NhykOptimizerStats& getStats() const {return stats;}
+
+private:
+    // How often a name is bound (declared, assigned, looped over or read by INPUT) in
+    // one scope, and how many of those are declarations (VAR, FOR, parameters).
+    struct Bindings {
+        uint32_t all = 0;
+        uint32_t declared = 0;
+    };
+    typedef std::unordered_map<uint64_t, Bindings> BindingMap;
+
+    NhykSymbolTable& names;
+    NhykAst* ast;
+    NhykOptimizerStats stats;
+    BindingMap bindings;               // Keyed by (scope << 32 | symbol); a scope is a FUNC id.
+    BindingMap removed;                // Scratch for removable().
+    uint32_t scope;                    // FUNC being optimized, or NO_NODE for the main program.
+    std::string joined;
+
+    static uint64_t keyOf(uint32_t scope, uint32_t symbol) {return static_cast<uint64_t>(scope) << 32 | symbol;}
+    void countBindings(uint32_t id, uint32_t inScope, BindingMap& into, bool& hasFunction) const;
+    bool removable(const uint32_t* ids, size_t count);
+    void remove();
+
+    bool isLiteral(uint32_t id) const;
+    bool isBoolean(uint32_t id) const;
+    NhykValue valueOf(uint32_t id) const;
+    void setLiteral(uint32_t id, const NhykValue& value);
+    void replace(uint32_t id, uint32_t with);
+    void makeEmptyBlock(uint32_t id);
+
+    void statement(uint32_t id);
+    void ifStatement(uint32_t id);
+    void matchStatement(uint32_t id);
+    void expression(uint32_t id);
+    void unary(uint32_t id);
+    void binary(uint32_t id);
+    bool fold(NhykOp op, const NhykValue& x, const NhykValue& y, NhykValue& result);
+};
+
+#endif // NHYKOPTIMIZER_H_INCLUDED
@@ -0,0 +1,179 @@
+#include "NhykParallel.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+/**
+ * @file NhykParallel.cpp
+ * @brief Implementation of the speculative parallel lexer.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+// Tokens lexed speculatively for one chunk, with their start offsets in the buffer.
+// A speculation that ran into a token start of another one stops there: 'join' is the
+// index in 'merge' from which the two agree (merge is nullptr if it never joined).
+struct Speculation {
+    std::vector<Token> tokens;
+    std::vector<unsigned int> starts;
+    const Speculation* merge = nullptr;
+    size_t join = 0;
+
+    // Index of the token starting at 'offset', or tokens.size() if there is none.
+    size_t find(unsigned int offset) const {
+        auto found = std::lower_bound(starts.begin(), starts.end(), offset);
+        if (found == starts.end() || *found != offset) return tokens.size();
+        return static_cast<size_t>(found - starts.begin());
+    }
+};
+
+// Lexes the tokens of 'source' that start in [from, until). With 'other' given, stops
+// as soon as a token starts where one of 'other' does, since both agree from there on.
+void speculate(std::string_view source, unsigned int from, unsigned int until, Speculation& out,
+               const Speculation* other = nullptr) {
+    NhykLexer lexer{std::string()};
+    lexer.setErrorLimit(0);
+    lexer.setSymbolTable(nullptr);     // Interned once, in order, after stitching.
+    lexer.setSourceView(source);
+    lexer.seek(from);
+    while (true) {
+        Token token = lexer.next();
+        if (token.getType() == TokenType::END_OF_INPUT) break;
+        unsigned int start = lexer.offsetOf(token);
+        if (start >= until) break;
+        if (other != nullptr) {
+            size_t join = other->find(start);
+            if (join < other->tokens.size()) {
+                out.merge = other;
+                out.join = join;
+                break;
+            }
+        }
+        out.tokens.push_back(token);
+        out.starts.push_back(start);
+    }
+}
+
+// Appends 'spec' from token 'from' on, following it into the speculation it merged with.
+// Returns the offset just past the last token appended.
+unsigned int append(std::vector<Token>& tokens, const Speculation& spec, size_t from) {
+    tokens.insert(tokens.end(), spec.tokens.begin() + from, spec.tokens.end());
+    if (spec.merge != nullptr) return append(tokens, *spec.merge, spec.join);
+    const Token& last = spec.tokens.back();
+    return spec.starts.back() + static_cast<unsigned int>(last.getLexeme().size());
+}
+
+} // namespace
+
+NhykParallelLexer::NhykParallelLexer(unsigned int threads, size_t minChunkSize)
+    : threadCount(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      minChunk(std::max<size_t>(1, minChunkSize)), relexed(0) {}
+
+/**
+ * @brief Tokenizes 'source' on up to 'threadCount' threads.
+ *
+ * @details Each chunk i covers [bounds[i], bounds[i + 1]). Chunk 0 is lexed from offset 0,
+ * which is exact. Chunks after the first get two speculations: 'code' from the boundary
+ * itself, and 'string' from just after the first '"' at or after the boundary. The
+ * 'string' speculation stops as soon as it reaches a token start of 'code', so it only
+ * costs the stretch where the two starting states disagree. Stitching walks the chunks
+ * in order with a sequential lexer resuming where the previous chunk's last token ended.
+ * As soon as it produces a token whose start matches a token of either speculation, the
+ * remainder of that speculation is appended unchanged. Symbols are interned last.
+ *
+ * @param source The buffer to lex; the returned tokens view it.
+ * @return The same tokens NhykLexer::tokenize() would produce.
+ */
+std::vector<Token> NhykParallelLexer::tokenize(std::string_view source) {
+    relexed = 0;
+    const size_t length = source.size();
+    // Offsets are 32-bit. Checked here: a lexer refusing the buffer inside a worker
+    // thread could only terminate the process.
+    if (length > UINT_MAX)
+        throw std::length_error("NhykParallelLexer: source larger than 4 GiB; use NhykStreamLexer");
+    size_t chunks = std::min<size_t>(threadCount, length / minChunk);
+
+    if (chunks <= 1) {
+        NhykLexer lexer{std::string()};
+        lexer.setErrorLimit(0);
+        lexer.setSymbolTable(&symbols);
+        lexer.setSourceView(source);
+        lexer.tokenize();
+        return lexer.getTokens();
+    }
+
+    std::vector<unsigned int> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i)
+        bounds[i] = static_cast<unsigned int>(length * i / chunks);
+
+    // Speculate every chunk in both starting states, one thread per chunk.
+    std::vector<Speculation> code(chunks), string(chunks);
+    std::vector<std::thread> workers;
+    workers.reserve(chunks);
+    for (size_t i = 0; i < chunks; ++i) {
+        workers.emplace_back([&, i]() {
+            speculate(source, bounds[i], bounds[i + 1], code[i]);
+            if (i == 0) return;
+            const void* quote = std::memchr(source.data() + bounds[i], '"', bounds[i + 1] - bounds[i]);
+            if (quote != nullptr) {
+                unsigned int after = static_cast<unsigned int>(static_cast<const char*>(quote) - source.data()) + 1;
+                speculate(source, after, bounds[i + 1], string[i], &code[i]);
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    size_t expected = 0;
+    for (size_t i = 0; i < chunks; ++i) expected += code[i].tokens.size();
+    std::vector<Token> tokens;
+    tokens.reserve(expected + expected / 16);
+
+    // Stitch: re-lex from the true resume point until a speculation agrees.
+    NhykLexer lexer{std::string()};
+    lexer.setErrorLimit(0);
+    lexer.setSymbolTable(nullptr);
+    lexer.setSourceView(source);
+    unsigned int resume = 0;
+    bool finished = false;
+    for (size_t i = 0; i < chunks && !finished; ++i) {
+        lexer.seek(resume);
+        while (true) {
+            Token token = lexer.next();
+            if (token.getType() == TokenType::END_OF_INPUT) {
+                finished = true;
+                break;
+            }
+            unsigned int start = lexer.offsetOf(token);
+            const Speculation* agree = nullptr;
+            size_t from = code[i].find(start);
+            if (from < code[i].tokens.size()) {
+                agree = &code[i];
+            } else {
+                from = string[i].find(start);
+                if (from < string[i].tokens.size()) agree = &string[i];
+            }
+            if (agree != nullptr) {
+                resume = append(tokens, *agree, from);
+                break;
+            }
+            // No speculation starts here: keep the re-lexed token.
+            ++relexed;
+            tokens.push_back(token);
+            resume = start + static_cast<unsigned int>(token.getLexeme().size());
+            if (start >= bounds[i + 1]) break;
+        }
+    }
+
+    // Speculations run on separate threads, so symbols are assigned here, in token order,
+    // which numbers them exactly as a sequential lexer would.
+    for (Token& token : tokens)
+        token.setSymbol(symbols.internToken(token.getType(), token.getLexeme()));
+    return tokens;
+}
@@ -0,0 +1,53 @@
+#ifndef NHYKPARALLEL_H_INCLUDED
+#define NHYKPARALLEL_H_INCLUDED
+
+/**
+ * @file NhykParallel.h
+ * @brief Defines NhykParallelLexer, which lexes one large buffer on several threads.
+ *
+ * The buffer is cut into one chunk per thread. Every chunk after the first is lexed
+ * speculatively from two plausible starting states: as ordinary code from the chunk
+ * boundary, and as if the boundary fell inside a string literal (resuming after the
+ * next '"'). The chunks are then stitched in order. Lexing is deterministic from any
+ * token start, so once the true token sequence reaches a token start that one of the
+ * speculations also produced, the rest of that speculation is exactly what sequential
+ * lexing would produce. Only the tokens before that point are re-lexed. The result is
+ * identical to NhykLexer::tokenize() on the same buffer.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <string_view>
+#include <vector>
+#include "LexGraph.h"
+#include "NhykSymbols.h"
+
+class NhykParallelLexer {
+public:
+    // 'threads' = 0 uses std::thread::hardware_concurrency(). Buffers shorter than two
+    // chunks of 'minChunkSize' bytes are lexed sequentially.
+    explicit NhykParallelLexer(unsigned int threads = 0, size_t minChunkSize = 1 << 20);
+
+    // Tokenizes 'source', which must outlive the returned tokens. Unknown characters are
+    // skipped as in NhykLexer::tokenize() but are not reported. Throws std::length_error,
+    // before any worker starts, for a buffer of 4 GiB or more.
+    std::vector<Token> tokenize(std::string_view source);
+
+    // Number of tokens the last tokenize() had to re-lex at chunk boundaries.
+    size_t getRelexedTokens() const {return relexed;}
+
+    // Table the returned tokens' symbol ids refer to; kept across calls.
+    NhykSymbolTable& getSymbols() {return symbols;}
+
+private:
+    unsigned int threadCount;
+    size_t minChunk;
+    size_t relexed;
+    NhykSymbolTable symbols;
+};
+
+#endif // NHYKPARALLEL_H_INCLUDED
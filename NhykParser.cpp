@@ -0,0 +1,658 @@
+#include "NhykParser.h"
+/**
+ * @file NhykParser.cpp
+ * @brief Implementation of the recursive-descent and Pratt parser.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+// Binding powers: an operator is taken while its power exceeds the caller's minimum.
+constexpr unsigned AND_POWER = 10;
+constexpr unsigned NOT_POWER = 20;     // Operand of NOT: comparisons and tighter.
+constexpr unsigned COMPARE_POWER = 30;
+constexpr unsigned ADD_POWER = 40;
+constexpr unsigned MUL_POWER = 50;
+constexpr unsigned NEG_POWER = 60;     // Operand of unary minus: a primary only.
+
+} // namespace
+
+// --- NhykParser Implementation ---
+
+NhykParser::NhykParser(NhykSymbolTable& table)
+    : names(table), kinds(nullptr), offsets(nullptr), lengths(nullptr), symbols(nullptr),
+      count(0), pos(0), depth(0), recovering(false) {}
+
+/**
+ * @brief Parses a whole program.
+ *
+ * @details The token columns are read in place. The tree is reserved from the token
+ * count up front, so nodes are appended without reallocating in all but unusual inputs.
+ *
+ * @param tokens Tokens of one source, as produced by NhykLexer::tokenize(TokenBuffer&).
+ * @return The id of the PROGRAM node.
+ */
+uint32_t NhykParser::parse(const TokenBuffer& tokens) {
+    source = tokens.getSource();
+    kinds = tokens.kindData();
+    offsets = tokens.offsetData();
+    lengths = tokens.lengthData();
+    symbols = tokens.symbolData();
+    numbers = tokens.numberData();
+    count = static_cast<uint32_t>(tokens.size());
+    pos = 0;
+    depth = 0;
+    recovering = false;
+    scratch.clear();
+    diagnostics.clear();
+    lines.clear();
+    ast.clear();
+    ast.reserve(tokens.size());
+
+    const uint32_t root = ast.add(NhykNodeKind::PROGRAM, 0);
+    ast.setRoot(root);
+    if (expectKeyword(KeywordKind::KW_PROG)) {
+        uint32_t name = expectName();
+        ast[root].symbol = name;
+        expectChar(':');
+    }
+    // A bad header is reported, but the statements after it are still parsed.
+    recovering = false;
+
+    const size_t mark = scratch.size();
+    statements(Until::END_OF_INPUT);
+    ast.setList(root, scratch.data() + mark, scratch.size() - mark);
+    scratch.resize(mark);
+    return root;
+}
+
+std::vector<ErrorToken> NhykParser::getErrors() const {
+    if (!lines.built()) lines.build(source);
+    std::vector<ErrorToken> errors;
+    errors.reserve(diagnostics.getEntries().size());
+    for (const NhykDiagnostic& diagnostic : diagnostics.getEntries()) {
+        NhykLocation where = lines.locate(diagnostic.offset);
+        errors.push_back(ErrorToken{diagnostic.kind, diagnostic.offset, diagnostic.length,
+                                    where.line, where.column, NhykDiagnostics::message(diagnostic, source)});
+    }
+    return errors;
+}
+
+// --- Tokens ---
+
+bool NhykParser::isDefault() const {
+    return kind() == TokenType::IDENTIFIER && text(pos) == "DEFAULT" && isChar(pos + 1, ':');
+}
+
+bool NhykParser::startsStatement() const {
+    switch (keyword()) {
+        case KeywordKind::KW_VAR: case KeywordKind::KW_FUNC: case KeywordKind::KW_BEGIN:
+        case KeywordKind::KW_END: case KeywordKind::KW_IF: case KeywordKind::KW_WHILE:
+        case KeywordKind::KW_FOR: case KeywordKind::KW_MATCH: case KeywordKind::KW_CASE:
+        case KeywordKind::KW_OUTPUT: case KeywordKind::KW_INPUT: case KeywordKind::KW_RETURN:
+            return true;
+        default:
+            return isChar('{') || isChar('}') || isDefault();
+    }
+}
+
+bool NhykParser::closes(Until until) const {
+    if (atEnd()) return true;
+    switch (until) {
+        case Until::END_OF_INPUT: return false;
+        case Until::BRACE:        return isChar('}');
+        case Until::END:          return keyword() == KeywordKind::KW_END;
+        case Until::ARM:          return isChar('}') || keyword() == KeywordKind::KW_CASE || isDefault();
+    }
+    return false;
+}
+
+// Symbol of an IDENTIFIER or string LITERAL token, interned here if the lexer did not.
+uint32_t NhykParser::symbolOf(uint32_t at) {
+    if (symbols[at] != NhykSymbolTable::NO_SYMBOL) return symbols[at];
+    return names.internToken(static_cast<TokenType>(kinds[at]), text(at));
+}
+
+bool NhykParser::accept(char c) {
+    if (!isChar(c)) return false;
+    ++pos;
+    return true;
+}
+
+bool NhykParser::expectChar(char c) {
+    if (accept(c)) return true;
+    error(NhykDiagnosticKind::EXPECTED_TOKEN, static_cast<uint8_t>(c));
+    return false;
+}
+
+bool NhykParser::expectKeyword(KeywordKind expected) {
+    if (keyword() == expected) {
+        ++pos;
+        return true;
+    }
+    error(NhykDiagnosticKind::EXPECTED_KEYWORD, static_cast<uint8_t>(expected));
+    return false;
+}
+
+uint32_t NhykParser::expectName() {
+    if (kind() == TokenType::IDENTIFIER) return symbolOf(pos++);
+    error(NhykDiagnosticKind::EXPECTED_NAME);
+    return NhykSymbolTable::NO_SYMBOL;
+}
+
+// An optional ": type" after a declared name.
+KeywordKind NhykParser::optionalType() {
+    if (!isChar(':')) return KeywordKind::NONE;
+    ++pos;
+    KeywordKind type = keyword();
+    if (type == KeywordKind::KW_INTEGER || type == KeywordKind::KW_DOUBLE ||
+        type == KeywordKind::KW_STRING || type == KeywordKind::KW_BOOL) {
+        ++pos;
+        return type;
+    }
+    error(NhykDiagnosticKind::EXPECTED_KEYWORD, static_cast<uint8_t>(KeywordKind::KW_INTEGER));
+    return KeywordKind::NONE;
+}
+
+// --- Errors ---
+
+// Reports an error at the current token, unless one was already reported for the
+// statement being parsed.
+void NhykParser::error(NhykDiagnosticKind kind, uint8_t detail) {
+    if (recovering) return;
+    recovering = true;
+    if (atEnd()) diagnostics.report(kind, static_cast<uint32_t>(source.size()), 0, detail);
+    else diagnostics.report(kind, offsets[pos], lengths[pos], detail);
+}
+
+/**
+ * @brief Skips the rest of a statement that had an error.
+ *
+ * @details Stops after a ';' or before a token that starts or closes a statement, and
+ * stops at once if the statement already ended with ';' or '}'. At the end of input
+ * errors stay suppressed: whatever is still open would only report the same problem.
+ */
+void NhykParser::synchronize() {
+    if (pos > 0 && (isChar(pos - 1, ';') || isChar(pos - 1, '}'))) {
+        recovering = false;
+        return;
+    }
+    while (!atEnd()) {
+        if (isChar(';')) {
+            ++pos;
+            break;
+        }
+        if (startsStatement()) break;
+        ++pos;
+    }
+    if (!atEnd()) recovering = false;
+}
+
+// Gives up on input nested past MAX_DEPTH: everything left is skipped.
+uint32_t NhykParser::tooDeep() {
+    error(NhykDiagnosticKind::NESTING_TOO_DEEP);
+    recovering = true;
+    pos = count;
+    return ast.add(NhykNodeKind::ERROR, count);
+}
+
+// --- Statements ---
+
+// Parses statements onto 'scratch' until 'until' closes the list.
+void NhykParser::statements(Until until) {
+    while (!closes(until)) {
+        const uint32_t before = pos;
+        uint32_t id = statement();
+        if (id != NhykAst::NO_NODE) scratch.push_back(id);
+        if (recovering) synchronize();
+        // Every statement consumes a token, even a stray one.
+        if (pos == before) ++pos;
+    }
+}
+
+// A node of 'kind' whose list is the ids pushed on 'scratch' since 'mark'.
+uint32_t NhykParser::list(NhykNodeKind kind, uint32_t token, size_t mark) {
+    uint32_t id = ast.add(kind, token);
+    ast.setList(id, scratch.data() + mark, scratch.size() - mark);
+    scratch.resize(mark);
+    return id;
+}
+
+uint32_t NhykParser::statement() {
+    if (depth >= MAX_DEPTH) return tooDeep();
+    ++depth;
+    uint32_t id = parseStatement();
+    --depth;
+    return id;
+}
+
+/**
+ * @brief Parses one statement.
+ *
+ * @return Its id, or NO_NODE for an empty statement or a token that cannot start one.
+ */
+uint32_t NhykParser::parseStatement() {
+    const uint32_t at = pos;
+    switch (keyword()) {
+        case KeywordKind::KW_VAR:
+            return varStatement();
+        case KeywordKind::KW_FUNC:
+            return funcStatement();
+        case KeywordKind::KW_BEGIN: {
+            ++pos;
+            const size_t mark = scratch.size();
+            statements(Until::END);
+            uint32_t id = list(NhykNodeKind::BLOCK, at, mark);
+            expectKeyword(KeywordKind::KW_END);
+            return id;
+        }
+        case KeywordKind::KW_IF:
+            return ifStatement();
+        case KeywordKind::KW_WHILE: {
+            ++pos;
+            uint32_t condition = expression();
+            uint32_t body = statement();
+            uint32_t id = ast.add(NhykNodeKind::WHILE, at);
+            ast[id].a = condition;
+            ast[id].b = body;
+            return id;
+        }
+        case KeywordKind::KW_FOR:
+            return forStatement();
+        case KeywordKind::KW_MATCH:
+            return matchStatement();
+        case KeywordKind::KW_OUTPUT: {
+            ++pos;
+            const size_t mark = scratch.size();
+            do {
+                scratch.push_back(expression());
+            } while (accept(','));
+            uint32_t id = list(NhykNodeKind::OUTPUT, at, mark);
+            expectChar(';');
+            return id;
+        }
+        case KeywordKind::KW_INPUT: {
+            ++pos;
+            uint32_t target = expectName();
+            uint32_t id = ast.add(NhykNodeKind::INPUT, at);
+            ast[id].symbol = target;
+            expectChar(';');
+            return id;
+        }
+        case KeywordKind::KW_RETURN: {
+            ++pos;
+            uint32_t value = isChar(';') ? NhykAst::NO_NODE : expression();
+            uint32_t id = ast.add(NhykNodeKind::RETURN, at);
+            ast[id].a = value;
+            expectChar(';');
+            return id;
+        }
+        case KeywordKind::NONE:
+        case KeywordKind::KW_NOT:
+        case KeywordKind::KW_TRUE:
+        case KeywordKind::KW_FALSE:
+            break;
+        default:
+            // ELSE without IF, CASE outside MATCH, a type name, ...
+            error(NhykDiagnosticKind::UNEXPECTED_TOKEN);
+            ++pos;
+            return NhykAst::NO_NODE;
+    }
+
+    if (isChar('{')) {
+        ++pos;
+        const size_t mark = scratch.size();
+        statements(Until::BRACE);
+        uint32_t id = list(NhykNodeKind::BLOCK, at, mark);
+        expectChar('}');
+        return id;
+    }
+    if (isChar(';')) {
+        ++pos;
+        return NhykAst::NO_NODE;
+    }
+    if (kind() == TokenType::IDENTIFIER && isChar(pos + 1, '=')) {
+        uint32_t target = symbolOf(pos);
+        pos += 2;
+        uint32_t value = expression();
+        uint32_t id = ast.add(NhykNodeKind::ASSIGN, at);
+        ast[id].symbol = target;
+        ast[id].a = value;
+        expectChar(';');
+        return id;
+    }
+    const TokenType type = kind();
+    if (type == TokenType::PUNCTUATION && !isChar('(') && !isChar('[')) {
+        error(NhykDiagnosticKind::UNEXPECTED_TOKEN);
+        ++pos;
+        return NhykAst::NO_NODE;
+    }
+    uint32_t value = expression();
+    uint32_t id = ast.add(NhykNodeKind::EXPRESSION, at);
+    ast[id].a = value;
+    expectChar(';');
+    return id;
+}
+
+uint32_t NhykParser::varStatement() {
+    const uint32_t at = pos++;
+    const size_t mark = scratch.size();
+    do {
+        const uint32_t declAt = pos;
+        uint32_t name = expectName();
+        KeywordKind type = optionalType();
+        uint32_t value = NhykAst::NO_NODE;
+        if (isChar('=')) {
+            ++pos;
+            value = expression();
+        }
+        uint32_t decl = ast.add(NhykNodeKind::DECL, declAt);
+        ast[decl].symbol = name;
+        ast[decl].type = type;
+        ast[decl].a = value;
+        scratch.push_back(decl);
+    } while (!recovering && accept(','));
+    uint32_t id = list(NhykNodeKind::VAR, at, mark);
+    expectChar(';');
+    return id;
+}
+
+uint32_t NhykParser::funcStatement() {
+    const uint32_t at = pos++;
+    uint32_t name = expectName();
+    const size_t mark = scratch.size();
+    if (expectChar('(') && !isChar(')')) {
+        do {
+            const uint32_t paramAt = pos;
+            uint32_t param = expectName();
+            KeywordKind type = optionalType();
+            uint32_t id = ast.add(NhykNodeKind::PARAM, paramAt);
+            ast[id].symbol = param;
+            ast[id].type = type;
+            scratch.push_back(id);
+        } while (!recovering && accept(','));
+    }
+    expectChar(')');
+    uint32_t id = list(NhykNodeKind::FUNC, at, mark);
+    ast[id].symbol = name;
+    uint32_t body = statement();
+    ast[id].a = body;
+    return id;
+}
+
+// IF with its ELIF arms as a chain of IF nodes, each the ELSE branch of the one before.
+// The chain is built in a loop, so long ELIF ladders do not nest the parser's calls.
+uint32_t NhykParser::ifStatement() {
+    uint32_t first = NhykAst::NO_NODE;
+    uint32_t last = NhykAst::NO_NODE;
+    do {
+        const uint32_t at = pos++;
+        uint32_t condition = expression();
+        expectKeyword(KeywordKind::KW_THEN);
+        uint32_t branch = statement();
+        uint32_t id = ast.add(NhykNodeKind::IF, at);
+        ast[id].a = condition;
+        ast[id].b = branch;
+        if (last == NhykAst::NO_NODE) first = id;
+        else ast[last].c = id;
+        last = id;
+    } while (keyword() == KeywordKind::KW_ELIF);
+    if (keyword() == KeywordKind::KW_ELSE) {
+        ++pos;
+        uint32_t branch = statement();
+        ast[last].c = branch;
+    }
+    return first;
+}
+
+uint32_t NhykParser::forStatement() {
+    const uint32_t at = pos++;
+    uint32_t variable = expectName();
+    expectChar('=');
+    uint32_t from = expression();
+    expectKeyword(KeywordKind::KW_TO);
+    uint32_t to = expression();
+    uint32_t body = statement();
+    uint32_t id = ast.add(NhykNodeKind::FOR, at);
+    ast[id].symbol = variable;
+    ast[id].a = from;
+    ast[id].b = to;
+    ast[id].c = body;
+    return id;
+}
+
+uint32_t NhykParser::matchStatement() {
+    const uint32_t at = pos++;
+    uint32_t subject = expression();
+    const size_t mark = scratch.size();
+    if (expectChar('{')) {
+        while (!atEnd() && !isChar('}')) {
+            const uint32_t armAt = pos;
+            uint32_t value = NhykAst::NO_NODE;
+            if (keyword() == KeywordKind::KW_CASE) {
+                ++pos;
+                value = expression();
+                expectChar(':');
+            } else if (isDefault()) {
+                pos += 2;
+            } else {
+                // Skip to the next arm.
+                error(NhykDiagnosticKind::EXPECTED_KEYWORD, static_cast<uint8_t>(KeywordKind::KW_CASE));
+                while (!closes(Until::ARM)) ++pos;
+                recovering = false;
+                continue;
+            }
+            if (recovering) synchronize();
+            const size_t armMark = scratch.size();
+            statements(Until::ARM);
+            uint32_t arm = list(NhykNodeKind::CASE, armAt, armMark);
+            ast[arm].a = value;
+            scratch.push_back(arm);
+        }
+    }
+    uint32_t id = list(NhykNodeKind::MATCH, at, mark);
+    ast[id].a = subject;
+    expectChar('}');
+    return id;
+}
+
+// --- Expressions ---
+
+/**
+ * @brief Parses an expression whose operators all bind tighter than 'minPower'.
+ *
+ * @details Precedence climbing: a prefix expression, then as long as the next token is
+ * a binary operator stronger than 'minPower', the operator and a right operand made of
+ * operators stronger than it. Equal powers therefore group to the left.
+ */
+uint32_t NhykParser::expression(unsigned minPower) {
+    if (depth >= MAX_DEPTH) return tooDeep();
+    ++depth;
+    uint32_t left = prefix();
+    for (;;) {
+        NhykOp op;
+        uint32_t width;
+        unsigned power = infix(op, width);
+        if (power <= minPower) break;
+        const uint32_t at = pos;
+        pos += width;
+        uint32_t right = expression(power);
+        uint32_t id = ast.add(NhykNodeKind::BINARY, at);
+        ast[id].op = op;
+        ast[id].a = left;
+        ast[id].b = right;
+        left = id;
+    }
+    --depth;
+    return left;
+}
+
+// Literals, names, calls, parenthesized expressions, lists and prefix operators.
+uint32_t NhykParser::prefix() {
+    const uint32_t at = pos;
+    switch (kind()) {
+        case TokenType::INT_LITERAL: {
+            const int64_t value = numbers[symbols[pos++]].integer;
+            uint32_t id = ast.add(NhykNodeKind::INT, at);
+            ast[id].a = ast.addInt(value);
+            return id;
+        }
+        case TokenType::DOUBLE_LITERAL: {
+            const double value = numbers[symbols[pos++]].real;
+            uint32_t id = ast.add(NhykNodeKind::DOUBLE, at);
+            ast[id].a = ast.addDouble(value);
+            return id;
+        }
+        case TokenType::LITERAL: {
+            uint32_t id = ast.add(NhykNodeKind::STRING, at);
+            ast[id].symbol = symbolOf(pos++);
+            return id;
+        }
+        case TokenType::BOOLEAN_LITERAL: {
+            uint32_t id = ast.add(NhykNodeKind::BOOL, at);
+            ast[id].a = text(pos++) == "TRUE";
+            return id;
+        }
+        case TokenType::IDENTIFIER: {
+            uint32_t name = symbolOf(pos++);
+            if (!isChar('(')) {
+                uint32_t id = ast.add(NhykNodeKind::NAME, at);
+                ast[id].symbol = name;
+                return id;
+            }
+            ++pos;
+            const size_t mark = scratch.size();
+            if (!isChar(')')) {
+                do {
+                    scratch.push_back(expression());
+                } while (accept(','));
+            }
+            expectChar(')');
+            uint32_t id = list(NhykNodeKind::CALL, at, mark);
+            ast[id].symbol = name;
+            return id;
+        }
+        case TokenType::KEYWORD: {
+            KeywordKind word = keyword();
+            if (word == KeywordKind::KW_TRUE || word == KeywordKind::KW_FALSE) {
+                ++pos;
+                uint32_t id = ast.add(NhykNodeKind::BOOL, at);
+                ast[id].a = word == KeywordKind::KW_TRUE;
+                return id;
+            }
+            if (word == KeywordKind::KW_NOT) {
+                ++pos;
+                uint32_t operand = expression(NOT_POWER);
+                uint32_t id = ast.add(NhykNodeKind::UNARY, at);
+                ast[id].op = NhykOp::NOT;
+                ast[id].a = operand;
+                return id;
+            }
+            break;
+        }
+        case TokenType::OPERATOR:
+            if (isChar('-')) {
+                ++pos;
+                uint32_t operand = expression(NEG_POWER);
+                uint32_t id = ast.add(NhykNodeKind::UNARY, at);
+                ast[id].op = NhykOp::NEG;
+                ast[id].a = operand;
+                return id;
+            }
+            break;
+        case TokenType::PUNCTUATION:
+            if (isChar('(')) {
+                ++pos;
+                uint32_t inner = expression();
+                expectChar(')');
+                return inner;
+            }
+            if (isChar('[')) {
+                ++pos;
+                const size_t mark = scratch.size();
+                if (!isChar(']')) {
+                    do {
+                        scratch.push_back(expression());
+                    } while (accept(','));
+                }
+                uint32_t id = list(NhykNodeKind::LIST, at, mark);
+                expectChar(']');
+                return id;
+            }
+            break;
+        case TokenType::UNKNOWN:
+            // Already reported by the lexer: skip the statement quietly.
+            ++pos;
+            recovering = true;
+            return ast.add(NhykNodeKind::ERROR, at);
+        default:
+            break;
+    }
+    error(NhykDiagnosticKind::EXPECTED_EXPRESSION);
+    return ast.add(NhykNodeKind::ERROR, at);
+}
+
+/**
+ * @brief Identifies a binary operator at the current token.
+ *
+ * @param op Receives the operator.
+ * @param width Receives the number of tokens it spans (three for IS NOT IN).
+ * @return Its binding power, or 0 if the current token is not a binary operator.
+ */
+unsigned NhykParser::infix(NhykOp& op, uint32_t& width) const {
+    width = 1;
+    const TokenType type = kind();
+    if (type == TokenType::OPERATOR) {
+        std::string_view spelling = text(pos);
+        const char second = spelling.size() > 1 ? spelling[1] : '\0';
+        switch (spelling[0]) {
+            case '+': op = NhykOp::ADD; return ADD_POWER;
+            case '-':
+                if (second == '>') return 0;
+                op = NhykOp::SUB;
+                return ADD_POWER;
+            case '*': op = NhykOp::MUL; return MUL_POWER;
+            case '/': op = NhykOp::DIV; return MUL_POWER;
+            case '<': op = second == '=' ? NhykOp::LE : NhykOp::LT; return COMPARE_POWER;
+            case '>': op = second == '=' ? NhykOp::GE : NhykOp::GT; return COMPARE_POWER;
+            case '!': op = NhykOp::NE; return COMPARE_POWER;
+            case '=':
+                // A lone '=' is assignment, not an operator of expressions.
+                if (second != '=') return 0;
+                op = NhykOp::EQ;
+                return COMPARE_POWER;
+        }
+        return 0;
+    }
+    if (type != TokenType::KEYWORD) return 0;
+    switch (keyword()) {
+        case KeywordKind::KW_AND:
+            op = NhykOp::AND;
+            return AND_POWER;
+        case KeywordKind::KW_IS: {
+            // IS IN or IS NOT IN; IS alone is not an operator.
+            auto wordAt = [this](uint32_t at) {
+                return at < count && kinds[at] == static_cast<uint8_t>(TokenType::KEYWORD)
+                     ? lookupKeyword(text(at)) : KeywordKind::NONE;
+            };
+            if (wordAt(pos + 1) == KeywordKind::KW_IN) {
+                op = NhykOp::IN;
+                width = 2;
+                return COMPARE_POWER;
+            }
+            if (wordAt(pos + 1) == KeywordKind::KW_NOT && wordAt(pos + 2) == KeywordKind::KW_IN) {
+                op = NhykOp::NOT_IN;
+                width = 3;
+                return COMPARE_POWER;
+            }
+            return 0;
+        }
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,147 @@
+#ifndef NHYKPARSER_H_INCLUDED
+#define NHYKPARSER_H_INCLUDED
+
+/**
+ * @file NhykParser.h
+ * @brief Defines NhykParser, which builds an NhykAst from the tokens in a TokenBuffer.
+ *
+ * Statements are parsed by recursive descent and expressions by precedence climbing
+ * (Pratt parsing), reading the TokenBuffer's kind, offset, length and symbol columns
+ * directly. The grammar, loosest expression operators first:
+ *
+ *   program    PROG name ':' statement*
+ *   statement  VAR decl (',' decl)* ';'              decl:  name [':' type] ['=' expr]
+ *              FUNC name '(' [param (',' param)*] ')' statement     param: name [':' type]
+ *              BEGIN statement* END  |  '{' statement* '}'  |  ';'
+ *              IF expr THEN statement (ELIF expr THEN statement)* [ELSE statement]
+ *              WHILE expr statement
+ *              FOR name '=' expr TO expr statement
+ *              MATCH expr '{' (CASE expr ':' statement* | DEFAULT ':' statement*)* '}'
+ *              OUTPUT expr (',' expr)* ';'  |  INPUT name ';'  |  RETURN [expr] ';'
+ *              name '=' expr ';'  |  expr ';'
+ *   type       INTEGER | DOUBLE | STRING | BOOL
+ *   expr       AND  <  NOT (prefix)  <  == != < <= > >= IS IN, IS NOT IN  <  + -  <  * /
+ *              <  - (prefix)  <  literal, TRUE, FALSE, name, name '(' args ')',
+ *              '(' expr ')', '[' [expr (',' expr)*] ']'
+ *
+ * Binary operators associate to the left. DEFAULT is an ordinary identifier that
+ * introduces the default arm when followed by ':' inside MATCH.
+ *
+ * A syntax error is recorded as a diagnostic at the token where it was found, and the
+ * parser carries on: it builds an ERROR node or leaves the piece out, reports nothing
+ * more until it has skipped to the end of the statement (a ';', or a '}', END or
+ * keyword that starts a statement), and resumes there. UNKNOWN tokens were reported by
+ * the lexer, so the parser skips them without a second error. Nesting deeper than
+ * MAX_DEPTH ends the parse with an error instead of exhausting the stack.
+ *
+ * The parser owns its tree and diagnostics and keeps their memory between parses.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "NhykAst.h"
+#include "NhykDiagnostics.h"
+#include "NhykLines.h"
+#include "NhykSymbols.h"
+#include "TokenBuffer.h"
+
+class NhykParser {
+public:
+    static constexpr unsigned MAX_DEPTH = 256;
+
+    // Names and strings are interned into 'names', which must be the table the tokens'
+    // symbol ids (if any) refer to: the lexer's table (NhykLexer::getSymbolTable()).
+    explicit NhykParser(NhykSymbolTable& names);
+    NhykParser(const NhykParser&) = delete;
+    NhykParser& operator=(const NhykParser&) = delete;
+
+    // Parses 'tokens' into a new tree and returns its root, a PROGRAM node (also when
+    // there were errors). The tokens and their source must outlive getErrors() calls.
+    uint32_t parse(const TokenBuffer& tokens);
+
+    const NhykAst& getAst() const {return ast;}
+    NhykAst& getAst() {return ast;}
+    NhykSymbolTable& getNames() const {return names;}
+
+    // Syntax errors of the last parse, with their lines, columns and messages.
+    std::vector<ErrorToken> getErrors() const;
+    const NhykDiagnostics& getDiagnostics() const {return diagnostics;}
+    // Keeps at most 'maxErrors' errors per parse (see NhykDiagnostics::setLimit).
+    void setErrorLimit(size_t maxErrors) {diagnostics.setLimit(maxErrors);}
+
+private:
+    // What closes a list of statements (the closing token is not consumed).
+    enum class Until : uint8_t {
+        END_OF_INPUT,
+        BRACE,                         // '}'
+        END,                           // END
+        ARM                            // CASE, DEFAULT ':' or '}'
+    };
+
+    NhykSymbolTable& names;
+    NhykAst ast;
+    NhykDiagnostics diagnostics;
+    mutable NhykLineIndex lines;       // Built on the first getErrors() after a parse.
+
+    std::string_view source;
+    const uint8_t* kinds;              // The token columns being parsed.
+    const uint32_t* offsets;
+    const uint32_t* lengths;
+    const uint32_t* symbols;
+    const TokenNumber* numbers;        // Values of numeric tokens, indexed by 'symbols'.
+    uint32_t count;
+    uint32_t pos;                      // Index of the current token.
+    unsigned depth;                    // Statements and expressions being parsed.
+    bool recovering;                   // An error was reported in the current statement.
+    std::vector<uint32_t> scratch;     // Ids of the lists being built, innermost last.
+
+    // The current token.
+    bool atEnd() const {return pos >= count;}
+    TokenType kind() const {return pos < count ? static_cast<TokenType>(kinds[pos]) : TokenType::END_OF_INPUT;}
+    std::string_view text(uint32_t at) const {return std::string_view(source.data() + offsets[at], lengths[at]);}
+    KeywordKind keyword() const {return kind() == TokenType::KEYWORD ? lookupKeyword(text(pos)) : KeywordKind::NONE;}
+    // Whether token 'at' is the one-character punctuation or operator 'c'.
+    bool isChar(uint32_t at, char c) const {
+        return at < count && lengths[at] == 1 && source[offsets[at]] == c
+            && (kinds[at] == static_cast<uint8_t>(TokenType::PUNCTUATION) || kinds[at] == static_cast<uint8_t>(TokenType::OPERATOR));
+    }
+    bool isChar(char c) const {return isChar(pos, c);}
+    bool isDefault() const;
+    bool startsStatement() const;
+    bool closes(Until until) const;
+    uint32_t symbolOf(uint32_t at);
+
+    // Consumes the punctuation or operator 'c' if it is the current token.
+    bool accept(char c);
+    // Consume the expected token, or report it missing and consume nothing.
+    bool expectChar(char c);
+    bool expectKeyword(KeywordKind keyword);
+    uint32_t expectName();
+    KeywordKind optionalType();
+
+    void error(NhykDiagnosticKind kind, uint8_t detail = 0);
+    void synchronize();
+    uint32_t tooDeep();
+
+    void statements(Until until);
+    uint32_t list(NhykNodeKind kind, uint32_t token, size_t mark);
+    uint32_t statement();
+    uint32_t parseStatement();
+    uint32_t varStatement();
+    uint32_t funcStatement();
+    uint32_t ifStatement();
+    uint32_t forStatement();
+    uint32_t matchStatement();
+    uint32_t expression(unsigned minPower = 0);
+    uint32_t prefix();
+    unsigned infix(NhykOp& op, uint32_t& width) const;
+};
+
+#endif // NHYKPARSER_H_INCLUDED
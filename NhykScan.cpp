@@ -0,0 +1,241 @@
+#include "NhykScan.h"
+/**
+ * @file NhykScan.cpp
+ * @brief Implementation of the SSE2/AVX2/scalar run scanners.
+ *
+ * Each kernel loads a block of input, builds a mask of the bytes inside the class and
+ * returns at the first byte outside it. Ranges are tested with the unsigned
+ * "min(x - lo, hi - lo) == x - lo" idiom, since SSE2 has no unsigned byte compare.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NHYK_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define NHYK_SCAN_X86 0
+#endif
+
+#if defined(__GNUC__)
+#define NHYK_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NHYK_TARGET_AVX2
+#endif
+
+namespace {
+
+template <NhykScanKind K>
+inline bool inClass(unsigned char c) {
+    return nhykInScanClass(K, c);
+}
+
+template <NhykScanKind K>
+size_t scanScalar(const unsigned char* data, size_t i, size_t length) {
+    while (i < length && inClass<K>(data[i])) ++i;
+    return i;
+}
+
+void linesScalar(const unsigned char* data, size_t i, size_t length, std::vector<uint32_t>& starts) {
+    for (; i < length; ++i)
+        if (data[i] == '\n') starts.push_back(static_cast<uint32_t>(i + 1));
+}
+
+#if NHYK_SCAN_X86
+
+inline unsigned int lowestBit(unsigned int mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+}
+
+// --- SSE2 kernels ---
+
+inline __m128i inRange128(__m128i v, unsigned char lo, unsigned char hi) {
+    __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(lo)));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+template <NhykScanKind K>
+inline __m128i classMask128(__m128i v) {
+    if constexpr (K == NhykScanKind::WHITESPACE) {
+        return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange128(v, '\t', '\r'));
+    } else if constexpr (K == NhykScanKind::IDENT_CONTINUE) {
+        __m128i letter = inRange128(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z');
+        __m128i digit = inRange128(v, '0', '9');
+        __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+        return _mm_or_si128(_mm_or_si128(letter, digit), underscore);
+    } else if constexpr (K == NhykScanKind::DIGITS) {
+        return inRange128(v, '0', '9');
+    } else {
+        __m128i printable = inRange128(v, 32, 126);
+        return _mm_andnot_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), printable);
+    }
+}
+
+template <NhykScanKind K>
+size_t scanSse2(const unsigned char* data, size_t i, size_t length) {
+    while (i + 16 <= length) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned int outside = ~static_cast<unsigned int>(_mm_movemask_epi8(classMask128<K>(block))) & 0xFFFFu;
+        if (outside != 0) return i + lowestBit(outside);
+        i += 16;
+    }
+    return scanScalar<K>(data, i, length);
+}
+
+// Newlines are rare, so each block costs one compare and a usually-zero mask.
+void linesSse2(const unsigned char* data, size_t i, size_t length, std::vector<uint32_t>& starts) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= length; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned int found = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        while (found != 0) {
+            starts.push_back(static_cast<uint32_t>(i + lowestBit(found) + 1));
+            found &= found - 1;
+        }
+    }
+    linesScalar(data, i, length, starts);
+}
+
+// --- AVX2 kernels ---
+
+NHYK_TARGET_AVX2 inline __m256i inRange256(__m256i v, unsigned char lo, unsigned char hi) {
+    __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(static_cast<char>(lo)));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+template <NhykScanKind K>
+NHYK_TARGET_AVX2 inline __m256i classMask256(__m256i v) {
+    if constexpr (K == NhykScanKind::WHITESPACE) {
+        return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), inRange256(v, '\t', '\r'));
+    } else if constexpr (K == NhykScanKind::IDENT_CONTINUE) {
+        __m256i letter = inRange256(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 'z');
+        __m256i digit = inRange256(v, '0', '9');
+        __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+        return _mm256_or_si256(_mm256_or_si256(letter, digit), underscore);
+    } else if constexpr (K == NhykScanKind::DIGITS) {
+        return inRange256(v, '0', '9');
+    } else {
+        __m256i printable = inRange256(v, 32, 126);
+        return _mm256_andnot_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')), printable);
+    }
+}
+
+template <NhykScanKind K>
+NHYK_TARGET_AVX2 size_t scanAvx2(const unsigned char* data, size_t i, size_t length) {
+    while (i + 32 <= length) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned int outside = ~static_cast<unsigned int>(_mm256_movemask_epi8(classMask256<K>(block)));
+        if (outside != 0) return i + lowestBit(outside);
+        i += 32;
+    }
+    return scanSse2<K>(data, i, length);
+}
+
+NHYK_TARGET_AVX2 void linesAvx2(const unsigned char* data, size_t i, size_t length, std::vector<uint32_t>& starts) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    for (; i + 32 <= length; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned int found = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+        while (found != 0) {
+            starts.push_back(static_cast<uint32_t>(i + lowestBit(found) + 1));
+            found &= found - 1;
+        }
+    }
+    linesSse2(data, i, length, starts);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // NHYK_SCAN_X86
+
+typedef size_t (*ScanFunction)(const unsigned char*, size_t, size_t);
+typedef void (*LineFunction)(const unsigned char*, size_t, size_t, std::vector<uint32_t>&);
+
+template <NhykScanKind K> struct PickScalar {static constexpr ScanFunction function = scanScalar<K>;};
+
+struct ScanKernels {
+    ScanFunction scan[5];
+    LineFunction lines;
+    const char* isa;
+};
+
+template <template <NhykScanKind> class Pick>
+ScanKernels makeKernels(LineFunction lines, const char* isa) {
+    ScanKernels kernels = {{
+        scanScalar<NhykScanKind::NONE>,
+        Pick<NhykScanKind::WHITESPACE>::function,
+        Pick<NhykScanKind::IDENT_CONTINUE>::function,
+        Pick<NhykScanKind::DIGITS>::function,
+        Pick<NhykScanKind::STRING_BODY>::function
+    }, lines, isa};
+    return kernels;
+}
+
+#if NHYK_SCAN_X86
+template <NhykScanKind K> struct PickSse2 {static constexpr ScanFunction function = scanSse2<K>;};
+template <NhykScanKind K> struct PickAvx2 {static constexpr ScanFunction function = scanAvx2<K>;};
+#endif
+
+// Resolved once, on first use.
+const ScanKernels& kernels() {
+    static const ScanKernels resolved =
+#if NHYK_SCAN_X86
+        cpuHasAvx2() ? makeKernels<PickAvx2>(linesAvx2, "avx2") : makeKernels<PickSse2>(linesSse2, "sse2");
+#else
+        makeKernels<PickScalar>(linesScalar, "scalar");
+#endif
+    return resolved;
+}
+
+} // namespace
+
+size_t nhykScan(NhykScanKind kind, const char* data, size_t from, size_t length) {
+    return kernels().scan[static_cast<int>(kind)](reinterpret_cast<const unsigned char*>(data), from, length);
+}
+
+void nhykLineStarts(const char* data, size_t length, std::vector<uint32_t>& starts) {
+    kernels().lines(reinterpret_cast<const unsigned char*>(data), 0, length, starts);
+}
+
+void nhykAddEach(uint32_t* data, size_t count, uint32_t amount) {
+    size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i add = _mm_set1_epi32(static_cast<int>(amount));
+    for (; i + 8 <= count; i += 8) {
+        __m128i* block = reinterpret_cast<__m128i*>(data + i);
+        _mm_storeu_si128(block, _mm_add_epi32(_mm_loadu_si128(block), add));
+        _mm_storeu_si128(block + 1, _mm_add_epi32(_mm_loadu_si128(block + 1), add));
+    }
+#endif
+    for (; i < count; ++i) data[i] += amount;
+}
+
+const char* nhykScanIsa() {
+    return kernels().isa;
+}
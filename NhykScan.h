@@ -0,0 +1,66 @@
+#ifndef NHYKSCAN_H_INCLUDED
+#define NHYKSCAN_H_INCLUDED
+
+/**
+ * @file NhykScan.h
+ * @brief Defines the fast-path scanners that skip runs of same-class bytes.
+ *
+ * Most of the input consumed by the lexer is runs of bytes that keep an FSM in the
+ * same state: whitespace between tokens, identifier and digit characters, and the
+ * body of a string literal. nhykScan skips such a run 16 or 32 bytes at a time with
+ * SSE2 or AVX2 kernels, chosen once at startup from CPUID, and falls back to a plain
+ * byte loop on other processors. All character classes are ASCII and independent of
+ * the C locale.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class NhykScanKind : uint8_t {
+    NONE,            // No fast path.
+    WHITESPACE,      // ' ', '\t', '\n', '\v', '\f', '\r'
+    IDENT_CONTINUE,  // [A-Za-z0-9_]
+    DIGITS,          // [0-9]
+    STRING_BODY      // Printable ASCII (32..126) except '"'
+};
+
+// Locale-independent ASCII character classes used by the lexer.
+constexpr bool nhykIsSpace(unsigned char c) {return c == ' ' || (c >= '\t' && c <= '\r');}
+constexpr bool nhykIsDigit(unsigned char c) {return static_cast<unsigned char>(c - '0') <= 9;}
+constexpr bool nhykIsAlpha(unsigned char c) {return static_cast<unsigned char>((c | 0x20) - 'a') <= 25;}
+
+// Whether 'c' belongs to the class skipped by 'kind'. Usable in constant expressions,
+// so generated tables can attach scanners at compile time.
+constexpr bool nhykInScanClass(NhykScanKind kind, unsigned char c) {
+    switch (kind) {
+        case NhykScanKind::WHITESPACE:     return nhykIsSpace(c);
+        case NhykScanKind::IDENT_CONTINUE: return nhykIsAlpha(c) || nhykIsDigit(c) || c == '_';
+        case NhykScanKind::DIGITS:         return nhykIsDigit(c);
+        case NhykScanKind::STRING_BODY:    return c >= 32 && c <= 126 && c != '"';
+        default:                           return false;
+    }
+}
+
+// Offset of the first byte in data[from, length) outside the class of 'kind', or
+// 'length' if the run reaches the end of the buffer.
+size_t nhykScan(NhykScanKind kind, const char* data, size_t from, size_t length);
+
+// Appends to 'starts' the offset just past every '\n' in data[0, length), in order:
+// the start offsets of all lines but the first. Uses the same kernels as nhykScan.
+void nhykLineStarts(const char* data, size_t length, std::vector<uint32_t>& starts);
+
+// Adds 'amount' (modulo 2^32) to each of data[0, count). Moves token offsets after an
+// edit; eight lanes per step with SSE2 where the target has it.
+void nhykAddEach(uint32_t* data, size_t count, uint32_t amount);
+
+// Name of the instruction set the scanners were resolved to ("avx2", "sse2" or "scalar").
+const char* nhykScanIsa();
+
+#endif // NHYKSCAN_H_INCLUDED
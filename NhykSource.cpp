@@ -0,0 +1,244 @@
+#include "NhykSource.h"
+#include <algorithm>
+#include <stdexcept>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+/**
+ * @file NhykSource.cpp
+ * @brief Implementation of the mapped-file and streaming input sources.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+// --- NhykMappedFile Implementation ---
+
+#if defined(_WIN32)
+
+NhykMappedFile::NhykMappedFile(const std::string& path)
+    : data(nullptr), length(0), delivered(false), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Unable to open source file '" + path + "'");
+    fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to read the size of '" + path + "'");
+    }
+    length = static_cast<size_t>(size.QuadPart);
+    if (length == 0) return;  // Empty files cannot be mapped; the view stays empty.
+
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map source file '" + path + "'");
+    }
+    data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        CloseHandle(mappingHandle);
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map source file '" + path + "'");
+    }
+}
+
+NhykMappedFile::~NhykMappedFile() {
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+}
+
+#else
+
+NhykMappedFile::NhykMappedFile(const std::string& path) : data(nullptr), length(0), delivered(false) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Unable to open source file '" + path + "'");
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Unable to read the size of '" + path + "'");
+    }
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Unable to map source file '" + path + "'");
+        }
+        // The lexer reads the file front to back exactly once.
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+NhykMappedFile::~NhykMappedFile() {
+    if (data != nullptr) munmap(const_cast<char*>(data), length);
+}
+
+#endif
+
+std::string_view NhykMappedFile::nextChunk() {
+    if (delivered) return std::string_view();
+    delivered = true;
+    return view();
+}
+
+// --- NhykStreamInput Implementation ---
+
+NhykStreamInput::NhykStreamInput(std::FILE* file, size_t chunkSize) : file(file), buffer(chunkSize) {}
+
+std::string_view NhykStreamInput::nextChunk() {
+    // Fill the whole chunk unless the stream ends: pipes return short reads.
+    size_t filled = 0;
+    while (filled < buffer.size()) {
+        size_t got = std::fread(buffer.data() + filled, 1, buffer.size() - filled, file);
+        if (got == 0) break;
+        filled += got;
+    }
+    return std::string_view(buffer.data(), filled);
+}
+
+// --- NhykStreamLexer Implementation ---
+
+namespace {
+
+// Moves 'where' past 'text'.
+void advance(NhykLocation& where, std::string_view text) {
+    size_t newline = text.rfind('\n');
+    if (newline == std::string_view::npos) {
+        where.column += static_cast<uint32_t>(text.size());
+        return;
+    }
+    where.line += static_cast<uint32_t>(std::count(text.begin(), text.end(), '\n'));
+    where.column = static_cast<uint32_t>(text.size() - newline);
+}
+
+} // namespace
+
+NhykStreamLexer::NhykStreamLexer(NhykInputSource& source) : input(source), lexer(std::string()), consumed(0) {}
+
+void NhykStreamLexer::setErrorLimit(size_t maxErrors) {
+    diagnostics.setLimit(maxErrors);
+    // A chunk never holds more errors than the whole input keeps.
+    lexer.setErrorLimit(maxErrors);
+}
+
+/**
+ * @brief Lexes the whole input source chunk by chunk.
+ *
+ * @details Each chunk is lexed as a partial buffer: the lexer stops before any token
+ * that reaches the end of the chunk (an identifier, number or string literal that may
+ * continue in the next one). Everything from that point on is kept in 'carry', the
+ * next chunk is appended to it, and lexing resumes there: the lexer continues its DFA
+ * walk over the carried token from where the chunk ended, so a token spanning many
+ * chunks is walked once rather than again after every refill. A chunk that ends on a
+ * token boundary is lexed in place without being copied. Once the source is exhausted
+ * the remaining carry is lexed as the final buffer.
+ *
+ * @param sink Receives each batch of tokens, the buffer they view and its absolute offset.
+ */
+void NhykStreamLexer::tokenize(const Sink& sink) {
+    carry.clear();
+    consumed = 0;
+    diagnostics.clear();
+    excerpts.clear();
+    locations.clear();
+    start = NhykLocation();
+    while (true) {
+        std::string_view chunk = input.nextChunk();
+        bool last = chunk.empty();
+        std::string_view buffer = chunk;
+        if (!carry.empty()) {
+            carry.append(chunk.data(), chunk.size());
+            buffer = carry;
+        }
+        if (buffer.empty()) break;
+
+        if (buffer.data() == carry.data()) lexer.resumeSourceView(buffer, last);
+        else lexer.setSourceView(buffer, last);
+        lexer.tokenize();
+        if (!lexer.getTokens().empty()) sink(lexer.getTokens(), buffer, consumed);
+        // Errors are only reported before the stopping point, so none is found twice.
+        size_t stop = last ? buffer.size() : lexer.getPosition();
+        collect(buffer, stop);
+        if (last) {
+            consumed += buffer.size();
+            break;
+        }
+
+        // Keep the unfinished tail for the next round; the chunk itself is about to be reused.
+        if (buffer.data() == carry.data()) carry.erase(0, stop);
+        else carry.assign(chunk.data() + stop, chunk.size() - stop);
+        consumed += stop;
+    }
+    carry.clear();
+    carry.shrink_to_fit();
+}
+
+/**
+ * @brief Collects the errors the lexer found in the current buffer.
+ *
+ * @details The buffer starts at input offset 'consumed', so each entry is shifted by
+ * that much. A run of invalid bytes at the start of the buffer that continues the last
+ * collected run (cut by the previous chunk boundary) extends it, and its quoted text
+ * is completed from this buffer. Lines and columns are counted from 'start' in one
+ * pass over the buffer, which then moves 'start' to byte 'end'.
+ *
+ * @param buffer The buffer the lexer has just lexed.
+ * @param end Bytes of the buffer that will not be lexed again.
+ */
+void NhykStreamLexer::collect(std::string_view buffer, size_t end) {
+    const std::vector<NhykDiagnostic>& entries = diagnostics.getEntries();
+    const size_t before = entries.size();
+    const uint32_t length = before != 0 ? entries[before - 1].length : 0;
+    diagnostics.append(lexer.getDiagnostics(), static_cast<uint32_t>(consumed));
+
+    if (before != 0 && entries[before - 1].length != length) {
+        std::string& text = excerpts[before - 1];
+        if (text.size() < EXCERPT)
+            text.append(buffer.substr(0, std::min<size_t>(EXCERPT - text.size(), entries[before - 1].length - length)));
+    }
+
+    NhykLocation where = start;
+    size_t walked = 0;
+    for (size_t i = before; i < entries.size(); ++i) {
+        const size_t offset = static_cast<uint32_t>(entries[i].offset - static_cast<uint32_t>(consumed));
+        advance(where, buffer.substr(walked, offset - walked));
+        walked = offset;
+        locations.push_back(where);
+        excerpts.emplace_back(buffer.substr(offset, std::min<size_t>(entries[i].length, EXCERPT)));
+    }
+    advance(where, buffer.substr(walked, end - walked));
+    start = where;
+}
+
+std::vector<ErrorToken> NhykStreamLexer::getErrors() const {
+    const std::vector<NhykDiagnostic>& entries = diagnostics.getEntries();
+    std::vector<ErrorToken> errors;
+    errors.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        // The excerpt stands in for the source, with the entry's text at its start.
+        NhykDiagnostic local = entries[i];
+        local.offset = 0;
+        errors.push_back(ErrorToken{entries[i].kind, entries[i].offset, entries[i].length,
+                                    locations[i].line, locations[i].column, NhykDiagnostics::message(local, excerpts[i])});
+    }
+    return errors;
+}
@@ -0,0 +1,132 @@
+#ifndef NHYKSOURCE_H_INCLUDED
+#define NHYKSOURCE_H_INCLUDED
+
+/**
+ * @file NhykSource.h
+ * @brief Defines the input sources the Nhyk lexer can read from.
+ *
+ * NhykInputSource hands the lexer its input as a sequence of chunks. NhykMappedFile
+ * maps a whole file into memory and yields it as a single chunk, so a file is lexed in
+ * place without being read into a heap string first. NhykStreamInput reads a FILE*
+ * (a pipe, stdin) in fixed-size chunks. NhykStreamLexer lexes any source chunk by chunk
+ * with bounded memory, carrying a token that spans two chunks over into the next one.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LexGraph.h"
+
+class NhykInputSource {
+public:
+    virtual ~NhykInputSource() {}
+
+    // Next block of input, valid until the next call. Empty once the input is exhausted.
+    virtual std::string_view nextChunk() = 0;
+};
+
+/*
+*   NhykMappedFile maps a file read-only (mmap on POSIX, MapViewOfFile on Windows).
+*   Throws std::runtime_error if the file cannot be opened or mapped.
+*/
+class NhykMappedFile : public NhykInputSource {
+public:
+    explicit NhykMappedFile(const std::string& path);
+    ~NhykMappedFile() override;
+    NhykMappedFile(const NhykMappedFile&) = delete;
+    NhykMappedFile& operator=(const NhykMappedFile&) = delete;
+
+    // The whole file.
+    std::string_view view() const {return std::string_view(data, length);}
+
+    // Yields the whole file once, then nothing.
+    std::string_view nextChunk() override;
+
+private:
+    const char* data;
+    size_t length;
+    bool delivered;
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+// Reads a FILE* (a pipe, stdin, a regular file) in chunks of 'chunkSize' bytes.
+class NhykStreamInput : public NhykInputSource {
+public:
+    explicit NhykStreamInput(std::FILE* file, size_t chunkSize = 1 << 20);
+
+    std::string_view nextChunk() override;
+
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+};
+
+/*
+*   NhykStreamLexer lexes an NhykInputSource chunk by chunk. Tokens are handed to the
+*   sink in batches together with the buffer they view and its absolute offset in the
+*   input; a batch is only valid during the call. A token cut by a chunk boundary is
+*   carried over, and its walk continues once the next chunk has been appended, so
+*   memory stays bounded by the chunk size plus the longest token and time stays linear.
+*
+*   Each chunk's lexical errors are collected before the chunk goes away, with absolute
+*   offsets, their lines and columns, and the few bytes of text their messages quote.
+*   A run of invalid bytes cut by a chunk boundary is one error, as in a whole buffer.
+*/
+class NhykStreamLexer {
+public:
+    // 'buffer' is the memory the tokens view and 'baseOffset' the position of its first
+    // byte in the whole input, so a token starts at baseOffset + (lexeme.data() - buffer.data()).
+    typedef std::function<void(const std::vector<Token>& tokens, std::string_view buffer,
+                               uint64_t baseOffset)> Sink;
+
+    explicit NhykStreamLexer(NhykInputSource& source);
+
+    // Lexes the whole input, passing every batch of tokens to 'sink'.
+    void tokenize(const Sink& sink);
+
+    // Total number of bytes lexed so far.
+    uint64_t getConsumed() const {return consumed;}
+
+    // Table the tokens' symbol ids refer to. It outlives the chunks, so an id means the
+    // same name in every batch passed to the sink.
+    const NhykSymbolTable& getSymbols() const {return *lexer.getSymbolTable();}
+
+    // Errors found in the input so far, with their lines, columns and messages.
+    std::vector<ErrorToken> getErrors() const;
+    // The raw entries behind getErrors(). Offsets are absolute in the input; like every
+    // diagnostic offset they are 32 bits wide, so they wrap past 4 GiB.
+    const NhykDiagnostics& getDiagnostics() const {return diagnostics;}
+    // Keeps at most 'maxErrors' errors for the whole input (see NhykDiagnostics::setLimit).
+    void setErrorLimit(size_t maxErrors);
+
+private:
+    // Longest text a message quotes, plus one byte to tell that it was cut short.
+    static constexpr size_t EXCERPT = 33;
+
+    // Moves the lexer's errors in 'buffer' into 'diagnostics', and 'start' past the
+    // first 'end' bytes of 'buffer', which are not lexed again.
+    void collect(std::string_view buffer, size_t end);
+
+    NhykInputSource& input;
+    NhykLexer lexer;
+    std::string carry;                 // Unfinished tail of the previous chunk.
+    uint64_t consumed;
+    NhykDiagnostics diagnostics;
+    std::vector<std::string> excerpts; // Start of each entry's text, up to EXCERPT bytes.
+    std::vector<NhykLocation> locations;
+    NhykLocation start;                // Line and column of input byte 'consumed'.
+};
+
+#endif // NHYKSOURCE_H_INCLUDED
@@ -0,0 +1,17 @@
+#include "NhykSpec.h"
+/**
+ * @file NhykSpec.cpp
+ * @brief Compiles the token specification into nhykTokenDfa during the build.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+extern constexpr NhykDfa nhykTokenDfa = nhykCompileDfa(nhykTokenRules);
+
+// The driver relies on the start state accepting nothing: an empty match is no token.
+static_assert(!nhykTokenDfa.isAccepting(NhykDfa::START), "a token rule matches the empty string");
+static_assert(nhykTokenDfa.stateCount > 0 && nhykTokenDfa.stateCount < NhykDfa::NO_STATE, "state numbers fit a byte");
@@ -0,0 +1,66 @@
+#ifndef NHYKSPEC_H_INCLUDED
+#define NHYKSPEC_H_INCLUDED
+
+/**
+ * @file NhykSpec.h
+ * @brief The Nhyk token specification: every token class, declared once.
+ *
+ * Each rule pairs a pattern (syntax in NhykDfa.h) with the token type it produces.
+ * NhykLexer recognizes the longest match of any rule; when two rules match the same
+ * text the one listed first wins. The rules are compiled at build time into the single
+ * minimized DFA nhykTokenDfa, which NhykLexer walks directly.
+ *
+ * Text that starts a rule but completes none of them (an unterminated string) becomes
+ * a one-byte UNKNOWN token; a run of bytes that starts no rule at all is skipped. Both
+ * are recorded in the lexer's diagnostics (see NhykDiagnostics.h).
+ *
+ * Patterns work on bytes. Non-ASCII text is only valid inside string literals, where the
+ * LITERAL rule spells out well-formed UTF-8 byte by byte; the DFA validates it while
+ * nhykScan still skips the ASCII stretches of a string 16 or 32 bytes at a time.
+ * IDENTIFIER matches that are keywords become KEYWORD tokens (see Keywords.h).
+ *
+ * To add a token, add a rule here. Order matters only between rules that can match the
+ * same text.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include "NhykDfa.h"
+#include "Token.h"
+
+struct NhykTokenRule {
+    const char* pattern;
+    TokenType type;
+    bool skip;                         // Matched text produces no token (whitespace).
+};
+
+inline constexpr NhykTokenRule nhykTokenRules[] = {
+    {"[ \\t\\n\\v\\f\\r]+",                  TokenType::UNKNOWN,        true},
+    {"[A-Za-z][A-Za-z0-9_]*",               TokenType::IDENTIFIER,     false},
+    {"[0-9]+",                              TokenType::INT_LITERAL,    false},
+    {"[0-9]+\\.[0-9]*",                     TokenType::DOUBLE_LITERAL, false},
+    // A number running into letters ("7pop") is one malformed token.
+    {"[0-9]+(\\.[0-9]*)?[A-Za-z]+",         TokenType::UNKNOWN,        false},
+    // Operators and punctuation share states after the first byte, so "<" vs "<=" and
+    // "-" vs "->" are settled by longest match rather than by lookahead code.
+    {"[-+*/=<>]|>=|<=|==|!=|->",            TokenType::OPERATOR,       false},
+    {"[:;,.(){}\\[\\]]",                    TokenType::PUNCTUATION,    false},
+    // String bodies are printable ASCII or well-formed UTF-8: no overlong forms, no
+    // surrogates, nothing past U+10FFFF.
+    {"\"([ !#-~]"
+        "|[\\xC2-\\xDF][\\x80-\\xBF]"
+        "|\\xE0[\\xA0-\\xBF][\\x80-\\xBF]|[\\xE1-\\xEC\\xEE\\xEF][\\x80-\\xBF][\\x80-\\xBF]|\\xED[\\x80-\\x9F][\\x80-\\xBF]"
+        "|\\xF0[\\x90-\\xBF][\\x80-\\xBF][\\x80-\\xBF]|[\\xF1-\\xF3][\\x80-\\xBF][\\x80-\\xBF][\\x80-\\xBF]|\\xF4[\\x80-\\x8F][\\x80-\\xBF][\\x80-\\xBF]"
+        ")*\"",                             TokenType::LITERAL,        false},
+    // Any other quoted text on one line is one malformed string rather than a stray quote.
+    {"\"[^\"\\n]*\"",                       TokenType::UNKNOWN,        false},
+};
+
+// The rules above as one DFA; accept[] holds indices into nhykTokenRules.
+extern const NhykDfa nhykTokenDfa;
+
+#endif // NHYKSPEC_H_INCLUDED
@@ -0,0 +1,105 @@
+#include "NhykSymbols.h"
+#include <algorithm>
+/**
+ * @file NhykSymbols.cpp
+ * @brief Implementation of the interning symbol table.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+// Smallest power of two that is at least 'n'.
+size_t roundUp(size_t n) {
+    size_t size = 16;
+    while (size < n) size <<= 1;
+    return size;
+}
+
+} // namespace
+
+NhykSymbolTable::NhykSymbolTable(size_t expectedSymbols) : text(16 * 1024) {
+    rehash(roundUp(expectedSymbols * 2));
+    names.reserve(expectedSymbols);
+}
+
+// FNV-1a: names are short, so a byte loop beats anything with a setup cost.
+uint32_t NhykSymbolTable::hashOf(std::string_view text) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void NhykSymbolTable::rehash(size_t capacity) {
+    std::vector<Slot> old(capacity, Slot{0, NO_SYMBOL});
+    old.swap(slots);
+    const size_t mask = slots.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.id == NO_SYMBOL) continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].id != NO_SYMBOL) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+uint32_t NhykSymbolTable::find(std::string_view key) const {
+    const uint32_t hash = hashOf(key);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; slots[i].id != NO_SYMBOL; i = (i + 1) & mask) {
+        if (slots[i].hash == hash && names[slots[i].id] == key) return slots[i].id;
+    }
+    return NO_SYMBOL;
+}
+
+/**
+ * @brief Returns the id of 'key', interning it on first sight.
+ *
+ * @details New texts are copied into the arena, so the caller's buffer may go away
+ * afterwards. The table doubles before it becomes more than half full, which keeps
+ * probe sequences short.
+ *
+ * @param key The text to intern.
+ * @return Its symbol id, numbered from 0 in order of first appearance.
+ */
+uint32_t NhykSymbolTable::intern(std::string_view key) {
+    const uint32_t hash = hashOf(key);
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    for (; slots[i].id != NO_SYMBOL; i = (i + 1) & mask) {
+        if (slots[i].hash == hash && names[slots[i].id] == key) return slots[i].id;
+    }
+
+    const uint32_t id = static_cast<uint32_t>(names.size());
+    names.push_back(text.copy(key));
+    if ((names.size() + 1) * 2 > slots.size()) {
+        rehash(slots.size() * 2);
+        mask = slots.size() - 1;
+        i = hash & mask;
+        while (slots[i].id != NO_SYMBOL) i = (i + 1) & mask;
+    }
+    slots[i] = Slot{hash, id};
+    return id;
+}
+
+uint32_t NhykSymbolTable::internToken(TokenType type, std::string_view lexeme) {
+    if (type == TokenType::IDENTIFIER) return intern(lexeme);
+    if (type == TokenType::LITERAL && lexeme.size() >= 2) return intern(lexeme.substr(1, lexeme.size() - 2));
+    return NO_SYMBOL;
+}
+
+void NhykSymbolTable::clear() {
+    std::fill(slots.begin(), slots.end(), Slot{0, NO_SYMBOL});
+    names.clear();
+    text.reset();
+}
+
+size_t NhykSymbolTable::memoryUsage() const {
+    return slots.capacity() * sizeof(Slot) + names.capacity() * sizeof(std::string_view) + text.bytesReserved();
+}
@@ -0,0 +1,67 @@
+#ifndef NHYKSYMBOLS_H_INCLUDED
+#define NHYKSYMBOLS_H_INCLUDED
+
+/**
+ * @file NhykSymbols.h
+ * @brief Defines NhykSymbolTable, which interns names and string contents as 32-bit ids.
+ *
+ * Each distinct text is stored once, in an arena, and numbered in order of first
+ * appearance. Lookup is an open-addressing hash table with linear probing over
+ * (hash, id) slots; the full hash is kept in the slot so most mismatches are rejected
+ * without touching the text. The table is kept at most half full.
+ *
+ * Ids stay valid, and name the same text, for the life of the table, independently of
+ * the source buffers the texts were read from.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "NhykArena.h"
+#include "Token.h"
+
+class NhykSymbolTable {
+public:
+    static constexpr uint32_t NO_SYMBOL = Token::NO_SYMBOL;
+
+    explicit NhykSymbolTable(size_t expectedSymbols = 256);
+    NhykSymbolTable(const NhykSymbolTable&) = delete;
+    NhykSymbolTable& operator=(const NhykSymbolTable&) = delete;
+
+    // Id of 'text', adding it to the table if it is new.
+    uint32_t intern(std::string_view text);
+    // Id of 'text', or NO_SYMBOL if it has never been interned.
+    uint32_t find(std::string_view text) const;
+    // Symbol for a token: the name of an IDENTIFIER, the contents of a string LITERAL
+    // (without its quotes), NO_SYMBOL for any other type.
+    uint32_t internToken(TokenType type, std::string_view lexeme);
+    // Text of symbol 'id', owned by the table.
+    std::string_view name(uint32_t id) const {return names[id];}
+
+    size_t size() const {return names.size();}
+    // Forgets every symbol; previously returned ids and names become invalid.
+    void clear();
+    // Bytes held by the slots, the name index and the text arena.
+    size_t memoryUsage() const;
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t id;                   // NO_SYMBOL when the slot is free.
+    };
+
+    std::vector<Slot> slots;           // Power-of-two size.
+    std::vector<std::string_view> names;
+    NhykArena text;
+
+    static uint32_t hashOf(std::string_view text);
+    void rehash(size_t capacity);
+};
+
+#endif // NHYKSYMBOLS_H_INCLUDED
@@ -0,0 +1,291 @@
+#include "NhykTokenFile.h"
+#include "NhykNumbers.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+/**
+ * @file NhykTokenFile.cpp
+ * @brief Implementation of the binary token file.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+const char MAGIC[8] = {'N', 'H', 'Y', 'K', 'T', 'O', 'K', '\0'};
+
+inline bool hasSymbolId(uint8_t kind) {
+    return kind == static_cast<uint8_t>(TokenType::IDENTIFIER) || kind == static_cast<uint8_t>(TokenType::LITERAL);
+}
+
+// Writes 'value' at 'out' (at most five bytes) and returns the end of it.
+inline uint8_t* putVarint(uint8_t* out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+// Reads a varint from [at, end); throws if it runs past 'end' or past 32 bits.
+inline uint32_t getVarint(const uint8_t*& at, const uint8_t* end) {
+    // Gaps and most lengths fit in one byte.
+    if (at != end && *at < 0x80) return *at++;
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (at == end) throw std::runtime_error("NhykTokenFile: truncated section");
+        uint8_t byte = *at++;
+        // The fifth byte holds only bits 28 to 31; anything above would be cut off.
+        if (shift == 28 && (byte & 0x70) != 0) throw std::runtime_error("NhykTokenFile: malformed varint");
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) return value;
+    }
+    throw std::runtime_error("NhykTokenFile: malformed varint");
+}
+
+inline uint64_t rotate(uint64_t value, int bits) {return (value << bits) | (value >> (64 - bits));}
+
+// Fixed-width integers are little-endian in the file whatever the host's byte order;
+// compilers turn these loops into a plain load or store on little-endian targets.
+inline void putLittle(uint8_t* out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline uint64_t getLittle(const uint8_t* in, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    return value;
+}
+
+// The header's fields at their offsets in NhykTokenFile::Header.
+void writeHeader(uint8_t* out, const NhykTokenFile::Header& header) {
+    std::memcpy(out, header.magic, 8);
+    putLittle(out + 8, header.version, 4);
+    putLittle(out + 12, header.flags, 4);
+    putLittle(out + 16, header.tokenCount, 4);
+    putLittle(out + 20, header.symbolCount, 4);
+    putLittle(out + 24, header.sourceSize, 8);
+    putLittle(out + 32, header.sourceHash, 8);
+    putLittle(out + 40, header.positionsSize, 4);
+    putLittle(out + 44, header.symbolsSize, 4);
+    putLittle(out + 48, header.stringsSize, 4);
+    putLittle(out + 52, header.reserved, 4);
+    putLittle(out + 56, header.checksum, 8);
+}
+
+void readHeader(const uint8_t* in, NhykTokenFile::Header& header) {
+    std::memcpy(header.magic, in, 8);
+    header.version = static_cast<uint32_t>(getLittle(in + 8, 4));
+    header.flags = static_cast<uint32_t>(getLittle(in + 12, 4));
+    header.tokenCount = static_cast<uint32_t>(getLittle(in + 16, 4));
+    header.symbolCount = static_cast<uint32_t>(getLittle(in + 20, 4));
+    header.sourceSize = getLittle(in + 24, 8);
+    header.sourceHash = getLittle(in + 32, 8);
+    header.positionsSize = static_cast<uint32_t>(getLittle(in + 40, 4));
+    header.symbolsSize = static_cast<uint32_t>(getLittle(in + 44, 4));
+    header.stringsSize = static_cast<uint32_t>(getLittle(in + 48, 4));
+    header.reserved = static_cast<uint32_t>(getLittle(in + 52, 4));
+    header.checksum = getLittle(in + 56, 8);
+}
+
+} // namespace
+
+// --- NhykTokenFile Implementation ---
+
+/**
+ * @brief A fast 64-bit hash of 'bytes'.
+ *
+ * @details Eight bytes per step with one multiply, then a final avalanche. It detects
+ * corruption and changed sources; it is not meant to resist deliberate collisions.
+ * Words are read little-endian, so a hash is the same on every host.
+ */
+uint64_t NhykTokenFile::hash(std::string_view bytes) {
+    const uint64_t prime1 = 0x9E3779B185EBCA87ull;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+    const uint8_t* at = reinterpret_cast<const uint8_t*>(bytes.data());
+    size_t left = bytes.size();
+    uint64_t h = bytes.size() * prime1;
+    while (left >= 8) {
+        uint64_t word = getLittle(at, 8);
+        h = rotate(h ^ (word * prime2), 31) * prime1;
+        at += 8;
+        left -= 8;
+    }
+    if (left > 0) {
+        uint64_t word = getLittle(at, static_cast<int>(left));
+        h = rotate(h ^ (word * prime2), 31) * prime1;
+    }
+    h ^= h >> 33;
+    h *= prime2;
+    h ^= h >> 29;
+    return h;
+}
+
+/**
+ * @brief Encodes 'tokens' (and optionally the names of 'symbols') as a token file.
+ *
+ * @details The buffer is allocated uninitialized at the worst-case size, so only the
+ * pages actually written are ever touched, and each section is written through a raw
+ * pointer. The header goes in last, once the section sizes and the checksum are known.
+ */
+NhykTokenFile::Encoded NhykTokenFile::encodeInto(const TokenBuffer& tokens, const NhykSymbolTable* symbols) {
+    const size_t count = tokens.size();
+    const uint8_t* kinds = tokens.kindData();
+    const uint32_t* offsets = tokens.offsetData();
+    const uint32_t* lengths = tokens.lengthData();
+    const uint32_t* ids = tokens.symbolData();
+
+    // A kind byte and at most three five-byte varints per token.
+    size_t capacity = sizeof(Header) + count * 16;
+    if (symbols != nullptr)
+        for (uint32_t id = 0; id < symbols->size(); ++id) capacity += 5 + symbols->name(id).size();
+    Encoded encoded;
+    encoded.bytes.reset(new char[capacity]);
+    uint8_t* const base = reinterpret_cast<uint8_t*>(encoded.bytes.get());
+    uint8_t* at = base + sizeof(Header);
+
+    std::memcpy(at, kinds, count);
+    at += count;
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.tokenCount = static_cast<uint32_t>(count);
+    header.sourceSize = tokens.getSource().size();
+    header.sourceHash = hash(tokens.getSource());
+
+    uint8_t* mark = at;
+    uint32_t end = 0;
+    for (size_t i = 0; i < count; ++i) {
+        // Tokens are in source order, so the gap is never negative.
+        at = putVarint(at, offsets[i] - end);
+        at = putVarint(at, lengths[i]);
+        end = offsets[i] + lengths[i];
+    }
+    header.positionsSize = static_cast<uint32_t>(at - mark);
+
+    if (symbols != nullptr) {
+        header.flags |= HAS_SYMBOLS;
+        header.symbolCount = static_cast<uint32_t>(symbols->size());
+        mark = at;
+        for (size_t i = 0; i < count; ++i)
+            if (hasSymbolId(kinds[i])) at = putVarint(at, ids[i] + 1);
+        header.symbolsSize = static_cast<uint32_t>(at - mark);
+
+        mark = at;
+        for (uint32_t id = 0; id < header.symbolCount; ++id) {
+            std::string_view name = symbols->name(id);
+            at = putVarint(at, static_cast<uint32_t>(name.size()));
+            std::memcpy(at, name.data(), name.size());
+            at += name.size();
+        }
+        header.stringsSize = static_cast<uint32_t>(at - mark);
+    }
+
+    encoded.size = static_cast<size_t>(at - base);
+    header.checksum = hash(std::string_view(encoded.bytes.get() + sizeof(Header), encoded.size - sizeof(Header)));
+    writeHeader(base, header);
+    return encoded;
+}
+
+std::string NhykTokenFile::encode(const TokenBuffer& tokens, const NhykSymbolTable* symbols) {
+    Encoded encoded = encodeInto(tokens, symbols);
+    return std::string(encoded.bytes.get(), encoded.size);
+}
+
+void NhykTokenFile::write(const std::string& path, const TokenBuffer& tokens, const NhykSymbolTable* symbols) {
+    Encoded encoded = encodeInto(tokens, symbols);
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) throw std::runtime_error("Unable to create token file '" + path + "'");
+    bool written = std::fwrite(encoded.bytes.get(), 1, encoded.size, file) == encoded.size;
+    if (std::fclose(file) != 0) written = false;
+    if (!written) throw std::runtime_error("Unable to write token file '" + path + "'");
+}
+
+NhykTokenFile::NhykTokenFile(const std::string& path, bool verify) : file(path) {
+    std::string_view bytes = file.view();
+    if (bytes.size() < sizeof(Header)) throw std::runtime_error("NhykTokenFile: '" + path + "' is too short");
+    readHeader(reinterpret_cast<const uint8_t*>(bytes.data()), header);
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw std::runtime_error("NhykTokenFile: '" + path + "' is not a token file");
+    if (header.version != VERSION)
+        throw std::runtime_error("NhykTokenFile: '" + path + "' has an unsupported version");
+    uint64_t expected = sizeof(Header) + static_cast<uint64_t>(header.tokenCount) + header.positionsSize +
+                        header.symbolsSize + header.stringsSize;
+    if (expected != bytes.size()) throw std::runtime_error("NhykTokenFile: '" + path + "' has the wrong size");
+    if (verify && hash(bytes.substr(sizeof(Header))) != header.checksum)
+        throw std::runtime_error("NhykTokenFile: '" + path + "' fails its checksum");
+
+    kindBytes = reinterpret_cast<const uint8_t*>(bytes.data()) + sizeof(Header);
+    positions = kindBytes + header.tokenCount;
+    symbolIds = positions + header.positionsSize;
+    strings = symbolIds + header.symbolsSize;
+}
+
+bool NhykTokenFile::matches(std::string_view source) const {
+    return source.size() == header.sourceSize && hash(source) == header.sourceHash;
+}
+
+void NhykTokenFile::load(TokenBuffer& out, std::string_view source, NhykSymbolTable* symbols) const {
+    const uint32_t count = header.tokenCount;
+    out.reset(source, count);
+
+    // File symbol id -> id in 'symbols'.
+    std::vector<uint32_t> remap;
+    const bool withSymbols = symbols != nullptr && hasSymbols();
+    if (withSymbols) {
+        remap.reserve(header.symbolCount);
+        const uint8_t* at = strings;
+        const uint8_t* end = strings + header.stringsSize;
+        for (uint32_t id = 0; id < header.symbolCount; ++id) {
+            uint32_t length = getVarint(at, end);
+            if (length > static_cast<size_t>(end - at)) throw std::runtime_error("NhykTokenFile: truncated section");
+            remap.push_back(symbols->intern(std::string_view(reinterpret_cast<const char*>(at), length)));
+            at += length;
+        }
+        if (at != end) throw std::runtime_error("NhykTokenFile: unused bytes in the strings section");
+    }
+
+    const uint8_t* at = positions;
+    const uint8_t* atEnd = positions + header.positionsSize;
+    const uint8_t* ids = symbolIds;
+    const uint8_t* idsEnd = symbolIds + header.symbolsSize;
+    uint64_t end = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint8_t kind = kindBytes[i];
+        if (kind > static_cast<uint8_t>(TokenType::END_OF_INPUT)) throw std::runtime_error("NhykTokenFile: bad token kind");
+        uint64_t offset = end + getVarint(at, atEnd);
+        uint32_t length = getVarint(at, atEnd);
+        end = offset + length;
+        if (end > source.size()) throw std::runtime_error("NhykTokenFile: token past the end of the source");
+
+        uint32_t symbol = Token::NO_SYMBOL;
+        if (hasSymbols() && hasSymbolId(kind)) {
+            uint32_t stored = getVarint(ids, idsEnd);
+            if (stored > header.symbolCount) throw std::runtime_error("NhykTokenFile: bad symbol id");
+            if (withSymbols && stored != 0) symbol = remap[stored - 1];
+        }
+        // Numbers are not in the file; they are converted from the source again.
+        std::string_view lexeme = source.substr(static_cast<size_t>(offset), length);
+        if (kind == static_cast<uint8_t>(TokenType::INT_LITERAL)) {
+            int64_t value;
+            nhykParseInt(lexeme, value);
+            out.pushInt(static_cast<uint32_t>(offset), length, value);
+        } else if (kind == static_cast<uint8_t>(TokenType::DOUBLE_LITERAL)) {
+            double value;
+            nhykParseDouble(lexeme, value);
+            out.pushDouble(static_cast<uint32_t>(offset), length, value);
+        } else {
+            out.push(static_cast<TokenType>(kind), static_cast<uint32_t>(offset), length, symbol);
+        }
+    }
+    // Every section must be exactly as long as the tokens need.
+    if (at != atEnd) throw std::runtime_error("NhykTokenFile: unused bytes in the positions section");
+    if (ids != idsEnd) throw std::runtime_error("NhykTokenFile: unused bytes in the symbols section");
+}
@@ -0,0 +1,102 @@
+#ifndef NHYKTOKENFILE_H_INCLUDED
+#define NHYKTOKENFILE_H_INCLUDED
+
+/**
+ * @file NhykTokenFile.h
+ * @brief Defines NhykTokenFile, a compact binary file of a source's tokens.
+ *
+ * A token file lets a build cache skip relexing a source that has not changed: the
+ * file records the size and hash of the source it was lexed from, and matches() tells
+ * whether a source is still that one. Layout (integers little-endian):
+ *
+ *   header    fixed 64 bytes: magic, version, flags, token and symbol counts, source
+ *             size and hash, section sizes, checksum of everything after the header
+ *   kinds     one byte per token, the TokenType
+ *   positions per token, LEB128 varints: gap from the previous token's end, then length
+ *   symbols   (optional) per IDENTIFIER and LITERAL token, varint symbol id + 1 (0: none)
+ *   strings   (optional) per symbol id in order, varint byte length, then the bytes
+ *
+ * Typical tokens take three or four bytes instead of the thirteen of a TokenBuffer row.
+ * A file is written from a TokenBuffer in one pass into one buffer and one fwrite, and
+ * read back through a memory mapping: the header is checked, the sections are located by
+ * pointer and the kinds are used in place, so only the varints are decoded on load().
+ * Numeric values are not stored: load() converts the numbers' lexemes in the source.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "TokenBuffer.h"
+#include "NhykSource.h"
+#include "NhykSymbols.h"
+
+class NhykTokenFile {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t HAS_SYMBOLS = 1;     // Header flag: symbols and strings present.
+
+    // In the file each field is stored little-endian at its offset in this struct.
+    struct Header {
+        char magic[8];                 // "NHYKTOK" and a zero byte.
+        uint32_t version;
+        uint32_t flags;
+        uint32_t tokenCount;
+        uint32_t symbolCount;
+        uint64_t sourceSize;
+        uint64_t sourceHash;
+        uint32_t positionsSize;        // Bytes in each section.
+        uint32_t symbolsSize;
+        uint32_t stringsSize;
+        uint32_t reserved;
+        uint64_t checksum;             // hash() of every byte after the header.
+    };
+    static_assert(sizeof(Header) == 64, "the header layout is part of the file format");
+
+    // The token file of 'tokens' as bytes. With 'symbols' given, the symbol ids and the
+    // table's names are stored as well.
+    static std::string encode(const TokenBuffer& tokens, const NhykSymbolTable* symbols = nullptr);
+    // Writes encode(tokens, symbols) to 'path'; throws std::runtime_error on failure.
+    static void write(const std::string& path, const TokenBuffer& tokens, const NhykSymbolTable* symbols = nullptr);
+    // The 64-bit hash used for source hashes and checksums.
+    static uint64_t hash(std::string_view bytes);
+
+    // Maps 'path' and checks its header; with 'verify' the checksum is checked too.
+    // Throws std::runtime_error if the file is not a valid token file.
+    explicit NhykTokenFile(const std::string& path, bool verify = true);
+
+    // Whether 'source' is the text the tokens were lexed from (same size and hash).
+    bool matches(std::string_view source) const;
+
+    size_t size() const {return header.tokenCount;}
+    bool hasSymbols() const {return (header.flags & HAS_SYMBOLS) != 0;}
+    const Header& getHeader() const {return header;}
+    // The kinds section, in place in the mapping.
+    const uint8_t* kinds() const {return kindBytes;}
+
+    // Decodes the tokens into 'out', reset to 'source' (which should match()). Symbol ids
+    // are interned into 'symbols' when both it and the file have them, else NO_SYMBOL.
+    void load(TokenBuffer& out, std::string_view source, NhykSymbolTable* symbols = nullptr) const;
+
+private:
+    struct Encoded {
+        std::unique_ptr<char[]> bytes;
+        size_t size = 0;
+    };
+    static Encoded encodeInto(const TokenBuffer& tokens, const NhykSymbolTable* symbols);
+
+    NhykMappedFile file;
+    Header header;
+    const uint8_t* kindBytes;
+    const uint8_t* positions;
+    const uint8_t* symbolIds;
+    const uint8_t* strings;
+};
+
+#endif // NHYKTOKENFILE_H_INCLUDED
@@ -0,0 +1,37 @@
+#include "NhykTrace.h"
+/**
+ * @file NhykTrace.cpp
+ * @brief Implementation of the NhykTraceBuffer ring buffer.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+NhykTraceBuffer::NhykTraceBuffer(size_t capacity) : mask(0), recorded(0) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    events.resize(size);
+    mask = size - 1;
+}
+
+std::vector<NhykTraceEvent> NhykTraceBuffer::snapshot() const {
+    std::vector<NhykTraceEvent> ordered;
+    ordered.reserve(size());
+    for (uint64_t i = recorded - size(); i < recorded; ++i)
+        ordered.push_back(events[i & mask]);
+    return ordered;
+}
+
+std::ostream& operator<<(std::ostream& out, const NhykTraceBuffer& trace) {
+    static const char* const kindNames[] = {
+        "TRANSITION", "NO_TRANSITION", "END_OF_INPUT", "CLASSIFY"
+    };
+    for (const NhykTraceEvent& event : trace.snapshot()) {
+        out << kindNames[static_cast<int>(event.kind)] << " state=" << event.state
+            << " offset=" << event.offset << " byte=" << static_cast<unsigned int>(event.byte) << "\n";
+    }
+    return out;
+}
@@ -0,0 +1,85 @@
+#ifndef NHYKTRACE_H_INCLUDED
+#define NHYKTRACE_H_INCLUDED
+
+/**
+ * @file NhykTrace.h
+ * @brief Defines the tracing facility used to debug the lexical graphs.
+ *
+ * Tracing is compiled out unless the build defines NHYK_TRACE to 1: the
+ * NHYK_TRACE_EVENT macro then expands to nothing and the FSM hot loop carries no
+ * tracing code at all. With NHYK_TRACE enabled, a LexGraph that has a
+ * NhykTraceBuffer attached records one compact binary event per step into the
+ * buffer; nothing is formatted until the buffer is dumped.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#ifndef NHYK_TRACE
+#define NHYK_TRACE 0
+#endif
+
+enum class NhykTraceKind : uint8_t {
+    TRANSITION,     // A transition was taken on 'byte' out of 'state'.
+    NO_TRANSITION,  // 'state' has no transition for 'byte'; traversal stops.
+    END_OF_INPUT,   // Traversal stopped at the end of the buffer.
+    CLASSIFY        // 'state' was classified; 'byte' holds the resulting TokenType.
+};
+
+// One recorded step of an FSM. Eight bytes, no strings.
+struct NhykTraceEvent {
+    NhykTraceKind kind;
+    uint8_t byte;
+    uint16_t state;
+    uint32_t offset;
+};
+
+/*
+*   NhykTraceBuffer keeps the most recent 'capacity' events in a ring. Older events
+*   are overwritten, so a trace can stay attached to a long run without growing.
+*/
+class NhykTraceBuffer {
+public:
+    // 'capacity' is rounded up to a power of two.
+    explicit NhykTraceBuffer(size_t capacity = 4096);
+
+    void record(NhykTraceKind kind, uint16_t state, uint32_t offset, uint8_t byte) {
+        events[recorded & mask] = NhykTraceEvent{kind, byte, state, offset};
+        ++recorded;
+    }
+
+    // Number of events currently held (at most the capacity).
+    size_t size() const {return recorded < events.size() ? static_cast<size_t>(recorded) : events.size();}
+
+    // Total number of events recorded, including overwritten ones.
+    uint64_t total() const {return recorded;}
+
+    // Held events, oldest first.
+    std::vector<NhykTraceEvent> snapshot() const;
+
+    void clear() {recorded = 0;}
+
+    // Writes the held events one per line, oldest first.
+    friend std::ostream& operator<<(std::ostream& out, const NhykTraceBuffer& trace);
+
+private:
+    std::vector<NhykTraceEvent> events;
+    size_t mask;
+    uint64_t recorded;
+};
+
+#if NHYK_TRACE
+#define NHYK_TRACE_EVENT(trace, kind, state, offset, byte) \
+    do { if (trace) (trace)->record((kind), (state), (offset), (byte)); } while (0)
+#else
+#define NHYK_TRACE_EVENT(trace, kind, state, offset, byte) ((void)0)
+#endif
+
+#endif // NHYKTRACE_H_INCLUDED
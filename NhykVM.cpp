@@ -0,0 +1,612 @@
+#include "NhykVM.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+/**
+ * @file NhykVM.cpp
+ * @brief Implementation of the bytecode interpreter.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+// Labels as values (computed goto) are a GCC extension, also in Clang; other compilers
+// dispatch through a switch.
+#if defined(__GNUC__)
+#define NHYK_VM_COMPUTED_GOTO 1
+#else
+#define NHYK_VM_COMPUTED_GOTO 0
+#endif
+
+namespace {
+
+const size_t OUTPUT_FLUSH = 64 * 1024;
+
+inline bool isNumber(const NhykValue& value) {
+    return value.type == NhykType::INTEGER || value.type == NhykType::DOUBLE;
+}
+
+inline double toDouble(const NhykValue& value) {
+    return value.type == NhykType::INTEGER ? static_cast<double>(value.integer) : value.real;
+}
+
+// INTEGER arithmetic wraps around instead of overflowing.
+inline int64_t wrap(uint64_t value) {
+    int64_t result;
+    std::memcpy(&result, &value, sizeof(result));
+    return result;
+}
+
+} // namespace
+
+// --- NhykVM Implementation ---
+
+NhykVM::NhykVM(NhykSymbolTable& table)
+    : names(table), out(&std::cout), in(&std::cin), fixedLists(0), fixedItems(0),
+      heapLimit(MIN_HEAP), steps(0) {}
+
+void NhykVM::format(std::string& text, const NhykValue& value) const {
+    if (value.type == NhykType::STRING) {
+        text += getString(value);
+    } else if (value.type == NhykType::LIST) {
+        // As nhykWriteValue does, but with the strings this run made.
+        const NhykListRange& range = lists[value.list];
+        text += '[';
+        for (uint32_t i = 0; i < range.count; ++i) {
+            if (i != 0) text += ", ";
+            const NhykValue& item = listItems[range.first + i];
+            if (item.type == NhykType::STRING) text += '"';
+            format(text, item);
+            if (item.type == NhykType::STRING) text += '"';
+        }
+        text += ']';
+    } else {
+        nhykWriteValue(text, value, names, lists, listItems);
+    }
+}
+
+std::vector<ErrorToken> NhykVM::getErrors() const {
+    if (!lines.built()) lines.build(source);
+    std::vector<ErrorToken> errors;
+    for (const NhykDiagnostic& diagnostic : diagnostics.getEntries()) {
+        NhykLocation where = lines.locate(diagnostic.offset);
+        errors.push_back(ErrorToken{diagnostic.kind, diagnostic.offset, diagnostic.length,
+                                    where.line, where.column, NhykDiagnostics::message(diagnostic, source)});
+    }
+    return errors;
+}
+
+bool NhykVM::equal(const NhykValue& a, const NhykValue& b) const {
+    if (a.type == NhykType::STRING && b.type == NhykType::STRING)
+        return a.symbol == b.symbol || (((a.symbol | b.symbol) & NHYK_HEAP_STRING) != 0
+                                        && getString(a) == getString(b));
+    if (a.type != NhykType::LIST || b.type != NhykType::LIST) return nhykScalarEqual(a, b);
+    const NhykListRange& x = lists[a.list];
+    const NhykListRange& y = lists[b.list];
+    if (x.count != y.count) return false;
+    for (uint32_t i = 0; i < x.count; ++i) {
+        if (!equal(listItems[x.first + i], listItems[y.first + i])) return false;
+    }
+    return true;
+}
+
+// Probes hash set 'set' of 'program' for 'value'.
+bool NhykVM::inSet(const NhykProgram& program, uint32_t set, const NhykValue& value) const {
+    if (value.type == NhykType::NONE || value.type == NhykType::LIST) return false;
+    NhykValue key = value;
+    if (key.type == NhykType::STRING && (key.symbol & NHYK_HEAP_STRING) != 0) {
+        // The set holds constants, so a string that was never interned is not in it.
+        key.symbol = names.find(getString(value));
+        if (key.symbol == NhykSymbolTable::NO_SYMBOL) return false;
+    }
+    const NhykSetRange& range = program.sets[set];
+    const NhykValue* slots = program.setSlots.data() + range.first;
+    uint32_t slot = static_cast<uint32_t>(nhykHashValue(key)) & range.mask;
+    while (slots[slot].type != NhykType::NONE) {
+        if (nhykScalarEqual(slots[slot], key)) return true;
+        slot = (slot + 1) & range.mask;
+    }
+    return false;
+}
+
+bool NhykVM::contains(const NhykValue& list, const NhykValue& value) const {
+    const NhykListRange& range = lists[list.list];
+    const NhykValue* item = listItems.data() + range.first;
+    for (uint32_t i = 0; i < range.count; ++i) {
+        if (equal(item[i], value)) return true;
+    }
+    return false;
+}
+
+// 'values' must be registers below 'top', which collect() renumbers in place.
+NhykValue NhykVM::makeList(const NhykValue* values, uint32_t count, size_t top) {
+    if (heapBytes() + sizeof(NhykListRange) + count * sizeof(NhykValue) > heapLimit) collect(top);
+    lists.push_back(NhykListRange{static_cast<uint32_t>(listItems.size()), count});
+    listItems.insert(listItems.end(), values, values + count);
+    return NhykValue::ofList(static_cast<uint32_t>(lists.size() - 1));
+}
+
+// 'text' must not be in 'chars', which collect() may move.
+NhykValue NhykVM::makeString(std::string_view text, size_t top) {
+    if (heapBytes() + sizeof(Text) + text.size() > heapLimit) collect(top);
+    strings.push_back(Text{chars.size(), text.size()});
+    chars.append(text);
+    return NhykValue::ofString(NHYK_HEAP_STRING | static_cast<uint32_t>(strings.size() - 1));
+}
+
+size_t NhykVM::heapBytes() const {
+    return (lists.size() - fixedLists) * sizeof(NhykListRange)
+         + (listItems.size() - fixedItems) * sizeof(NhykValue)
+         + strings.size() * sizeof(Text) + chars.size();
+}
+
+/**
+ * @brief Frees the lists and strings made at run time that stack[0, top) cannot reach.
+ *
+ * @details Registers at and above 'top' belong to calls that have returned, so they are
+ * cleared rather than scanned. The reachable lists and strings are marked from the
+ * registers and then through the items of the marked lists; the survivors keep their
+ * order and move down over the freed ones, and every value that refers to one is
+ * renumbered.
+ */
+void NhykVM::collect(size_t top) {
+    const uint32_t UNREACHED = UINT32_MAX;
+    std::fill(stack.begin() + static_cast<std::ptrdiff_t>(top), stack.end(), NhykValue::none());
+    newLists.assign(lists.size() - fixedLists, UNREACHED);
+    newStrings.assign(strings.size(), UNREACHED);
+    pending.clear();
+
+    auto mark = [this, UNREACHED](const NhykValue& value) {
+        if (value.type == NhykType::LIST && value.list >= fixedLists) {
+            uint32_t& entry = newLists[value.list - fixedLists];
+            if (entry == UNREACHED) {
+                entry = 0;
+                pending.push_back(value.list);
+            }
+        } else if (value.type == NhykType::STRING && (value.symbol & NHYK_HEAP_STRING) != 0) {
+            newStrings[value.symbol & ~NHYK_HEAP_STRING] = 0;
+        }
+    };
+    for (size_t r = 0; r < top; ++r) mark(stack[r]);
+    while (!pending.empty()) {
+        const NhykListRange range = lists[pending.back()];
+        pending.pop_back();
+        for (uint32_t k = 0; k < range.count; ++k) mark(listItems[range.first + k]);
+    }
+
+    // Move the survivors down, noting their new numbers.
+    uint32_t keptLists = fixedLists;
+    size_t keptItems = fixedItems;
+    for (size_t l = 0; l < newLists.size(); ++l) {
+        if (newLists[l] == UNREACHED) continue;
+        const NhykListRange range = lists[fixedLists + l];
+        std::copy(listItems.begin() + range.first, listItems.begin() + range.first + range.count,
+                  listItems.begin() + static_cast<std::ptrdiff_t>(keptItems));
+        lists[keptLists] = NhykListRange{static_cast<uint32_t>(keptItems), range.count};
+        newLists[l] = keptLists++;
+        keptItems += range.count;
+    }
+    lists.resize(keptLists);
+    listItems.resize(keptItems);
+    uint32_t keptStrings = 0;
+    size_t keptChars = 0;
+    for (size_t t = 0; t < newStrings.size(); ++t) {
+        if (newStrings[t] == UNREACHED) continue;
+        const Text text = strings[t];
+        std::copy(chars.begin() + static_cast<std::ptrdiff_t>(text.first),
+                  chars.begin() + static_cast<std::ptrdiff_t>(text.first + text.length),
+                  chars.begin() + static_cast<std::ptrdiff_t>(keptChars));
+        strings[keptStrings] = Text{keptChars, text.length};
+        newStrings[t] = keptStrings++;
+        keptChars += text.length;
+    }
+    strings.resize(keptStrings);
+    chars.resize(keptChars);
+
+    auto renumber = [this](NhykValue& value) {
+        if (value.type == NhykType::LIST && value.list >= fixedLists)
+            value.list = newLists[value.list - fixedLists];
+        else if (value.type == NhykType::STRING && (value.symbol & NHYK_HEAP_STRING) != 0)
+            value.symbol = NHYK_HEAP_STRING | newStrings[value.symbol & ~NHYK_HEAP_STRING];
+    };
+    for (size_t r = 0; r < top; ++r) renumber(stack[r]);
+    for (size_t k = fixedItems; k < listItems.size(); ++k) renumber(listItems[k]);
+
+    heapLimit = std::max(MIN_HEAP, 2 * heapBytes());
+}
+
+NhykValue NhykVM::read(size_t top) {
+    flush();
+    std::string word;
+    if (!(*in >> word)) return NhykValue::none();
+    const char* first = word.data();
+    const char* last = first + word.size();
+    int64_t integer;
+    std::from_chars_result parsed = std::from_chars(first, last, integer);
+    if (parsed.ec == std::errc() && parsed.ptr == last) return NhykValue::ofInt(integer);
+    double real;
+    parsed = std::from_chars(first, last, real);
+    if (parsed.ec == std::errc() && parsed.ptr == last) return NhykValue::ofDouble(real);
+    if (word == "TRUE" || word == "FALSE") return NhykValue::ofBool(word == "TRUE");
+    return makeString(word, top);
+}
+
+void NhykVM::flush() {
+    if (output.empty()) return;
+    out->write(output.data(), static_cast<std::streamsize>(output.size()));
+    out->flush();
+    output.clear();
+}
+
+/**
+ * @brief Runs a program's main function to its end.
+ *
+ * @details The dispatch loop keeps the instruction pointer, the current frame's
+ * registers (R), the globals (G) and the constants (K) in locals. Handlers are written
+ * once, between NHYK_VM_CASE and NHYK_VM_NEXT, and become either labelled blocks that
+ * jump straight to the next handler or the cases of a switch.
+ */
+bool NhykVM::run(const NhykProgram& program) {
+    diagnostics.clear();
+    lines.clear();
+    source = program.source;
+    frames.clear();
+    output.clear();
+    lists = program.lists;
+    listItems = program.listItems;
+    fixedLists = static_cast<uint32_t>(lists.size());
+    fixedItems = listItems.size();
+    strings.clear();
+    chars.clear();
+    heapLimit = MIN_HEAP;
+    steps = 0;
+
+    const NhykInstruction* const code = program.code.data();
+    const NhykFunction* const functions = program.functions.data();
+    const NhykValue* const K = program.constants.data();
+    const size_t mainRegisters = functions[0].registers;
+    stack.assign(std::max<size_t>(mainRegisters * 2, 1024), NhykValue::none());
+    frames.reserve(64);
+
+    size_t base = 0;
+    size_t top = mainRegisters;        // One past the current frame's last register.
+    NhykValue* G = stack.data();
+    NhykValue* R = G;
+    const NhykInstruction* ip = code + functions[0].entry;
+    const NhykInstruction* i = ip;
+    uint64_t count = 0;
+    NhykDiagnosticKind failure = NhykDiagnosticKind::TYPE_ERROR;
+
+#define NHYK_VM_FAIL(kind) do { failure = NhykDiagnosticKind::kind; goto fail; } while (0)
+
+    // R[a] = R[b] OP y for ADD, SUB and MUL; 'otherwise' handles non-numbers.
+#define NHYK_VM_ARITHMETIC(OP, y, otherwise) {                                              \
+        const NhykValue& x = R[i->b];                                                       \
+        const NhykValue& yv = (y);                                                          \
+        NhykValue& r = R[i->a];                                                             \
+        if (x.type == NhykType::INTEGER && yv.type == NhykType::INTEGER) {                  \
+            int64_t value = wrap(static_cast<uint64_t>(x.integer) OP static_cast<uint64_t>(yv.integer)); \
+            r.type = NhykType::INTEGER;                                                     \
+            r.integer = value;                                                              \
+        } else if (isNumber(x) && isNumber(yv)) {                                           \
+            double value = toDouble(x) OP toDouble(yv);                                     \
+            r.type = NhykType::DOUBLE;                                                      \
+            r.real = value;                                                                 \
+        } else {                                                                            \
+            otherwise;                                                                      \
+        }                                                                                   \
+    }
+
+    // STRING + STRING joins the two into a new string of the VM's own.
+#define NHYK_VM_JOIN(y) {                                                                   \
+        const NhykValue& x = R[i->b];                                                       \
+        const NhykValue& yv = (y);                                                          \
+        if (x.type != NhykType::STRING || yv.type != NhykType::STRING) NHYK_VM_FAIL(TYPE_ERROR); \
+        joined.assign(getString(x));                                                        \
+        joined.append(getString(yv));                                                       \
+        R[i->a] = makeString(joined, top);                                                  \
+    }
+
+#define NHYK_VM_DIVIDE(y) {                                                                 \
+        const NhykValue& x = R[i->b];                                                       \
+        const NhykValue& yv = (y);                                                          \
+        if (x.type == NhykType::INTEGER && yv.type == NhykType::INTEGER) {                  \
+            if (yv.integer == 0) NHYK_VM_FAIL(DIVISION_BY_ZERO);                            \
+            /* Dividing the smallest INTEGER by -1 wraps around like the other operators. */ \
+            int64_t value = yv.integer == -1 ? wrap(0 - static_cast<uint64_t>(x.integer)) : x.integer / yv.integer; \
+            R[i->a] = NhykValue::ofInt(value);                                              \
+        } else if (isNumber(x) && isNumber(yv)) {                                           \
+            R[i->a] = NhykValue::ofDouble(toDouble(x) / toDouble(yv));                      \
+        } else {                                                                            \
+            NHYK_VM_FAIL(TYPE_ERROR);                                                       \
+        }                                                                                   \
+    }
+
+    // R[a] = R[b] OP y for the ordering comparisons: two numbers, or two STRINGs.
+#define NHYK_VM_ORDER(OP, y) {                                                              \
+        const NhykValue& x = R[i->b];                                                       \
+        const NhykValue& yv = (y);                                                          \
+        bool result;                                                                        \
+        if (x.type == NhykType::INTEGER && yv.type == NhykType::INTEGER) {                  \
+            result = x.integer OP yv.integer;                                               \
+        } else if (isNumber(x) && isNumber(yv)) {                                           \
+            result = toDouble(x) OP toDouble(yv);                                           \
+        } else if (x.type == NhykType::STRING && yv.type == NhykType::STRING) {             \
+            result = getString(x) OP getString(yv);                                         \
+        } else {                                                                            \
+            NHYK_VM_FAIL(TYPE_ERROR);                                                       \
+        }                                                                                   \
+        R[i->a] = NhykValue::ofBool(result);                                                \
+    }
+
+#define NHYK_VM_EQUAL(y, expected) {                                                        \
+        const NhykValue& x = R[i->b];                                                       \
+        const NhykValue& yv = (y);                                                          \
+        bool result = x.type == NhykType::INTEGER && yv.type == NhykType::INTEGER           \
+                    ? x.integer == yv.integer : equal(x, yv);                               \
+        R[i->a] = NhykValue::ofBool(result == (expected));                                  \
+    }
+
+#define NHYK_VM_MEMBER(list, expected) {                                                    \
+        const NhykValue& l = (list);                                                        \
+        if (l.type != NhykType::LIST) NHYK_VM_FAIL(TYPE_ERROR);                             \
+        R[i->a] = NhykValue::ofBool(contains(l, R[i->b]) == (expected));                    \
+    }
+
+#if NHYK_VM_COMPUTED_GOTO
+    static const void* const handlers[] = {
+#define NHYK_VM_LABEL(name) &&op_##name,
+        NHYK_OPCODES(NHYK_VM_LABEL)
+#undef NHYK_VM_LABEL
+    };
+#define NHYK_VM_CASE(name) op_##name:
+#define NHYK_VM_NEXT() do { i = ip++; ++count; goto *handlers[static_cast<uint8_t>(i->op)]; } while (0)
+    NHYK_VM_NEXT();
+    {
+#else
+#define NHYK_VM_CASE(name) case NhykOpcode::name:
+#define NHYK_VM_NEXT() continue
+    for (;;) {
+        i = ip++;
+        ++count;
+        switch (i->op) {
+#endif
+        NHYK_VM_CASE(MOVE)
+            R[i->a] = R[i->b];
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(LOADK)
+            R[i->a] = K[i->b];
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(GETG)
+            R[i->a] = G[i->b];
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(SETG)
+            G[i->b] = R[i->a];
+            NHYK_VM_NEXT();
+
+        NHYK_VM_CASE(ADD)
+            NHYK_VM_ARITHMETIC(+, R[i->c], NHYK_VM_JOIN(R[i->c]))
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(SUB)
+            NHYK_VM_ARITHMETIC(-, R[i->c], NHYK_VM_FAIL(TYPE_ERROR))
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(MUL)
+            NHYK_VM_ARITHMETIC(*, R[i->c], NHYK_VM_FAIL(TYPE_ERROR))
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(DIV)
+            NHYK_VM_DIVIDE(R[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(ADDK)
+            NHYK_VM_ARITHMETIC(+, K[i->c], NHYK_VM_JOIN(K[i->c]))
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(SUBK)
+            NHYK_VM_ARITHMETIC(-, K[i->c], NHYK_VM_FAIL(TYPE_ERROR))
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(MULK)
+            NHYK_VM_ARITHMETIC(*, K[i->c], NHYK_VM_FAIL(TYPE_ERROR))
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(DIVK)
+            NHYK_VM_DIVIDE(K[i->c])
+            NHYK_VM_NEXT();
+
+        NHYK_VM_CASE(EQ)
+            NHYK_VM_EQUAL(R[i->c], true)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(NE)
+            NHYK_VM_EQUAL(R[i->c], false)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(LT)
+            NHYK_VM_ORDER(<, R[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(LE)
+            NHYK_VM_ORDER(<=, R[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(GT)
+            NHYK_VM_ORDER(>, R[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(GE)
+            NHYK_VM_ORDER(>=, R[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(EQK)
+            NHYK_VM_EQUAL(K[i->c], true)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(NEK)
+            NHYK_VM_EQUAL(K[i->c], false)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(LTK)
+            NHYK_VM_ORDER(<, K[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(LEK)
+            NHYK_VM_ORDER(<=, K[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(GTK)
+            NHYK_VM_ORDER(>, K[i->c])
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(GEK)
+            NHYK_VM_ORDER(>=, K[i->c])
+            NHYK_VM_NEXT();
+
+        NHYK_VM_CASE(NEG) {
+            const NhykValue& x = R[i->b];
+            if (x.type == NhykType::INTEGER) R[i->a] = NhykValue::ofInt(wrap(0 - static_cast<uint64_t>(x.integer)));
+            else if (x.type == NhykType::DOUBLE) R[i->a] = NhykValue::ofDouble(-x.real);
+            else NHYK_VM_FAIL(TYPE_ERROR);
+            NHYK_VM_NEXT();
+        }
+        NHYK_VM_CASE(NOT) {
+            const NhykValue& x = R[i->b];
+            if (x.type != NhykType::BOOL) NHYK_VM_FAIL(TYPE_ERROR);
+            R[i->a] = NhykValue::ofBool(!x.boolean);
+            NHYK_VM_NEXT();
+        }
+
+        NHYK_VM_CASE(IN)
+            NHYK_VM_MEMBER(R[i->c], true)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(NOTIN)
+            NHYK_VM_MEMBER(R[i->c], false)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(INK)
+            NHYK_VM_MEMBER(K[i->c], true)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(NOTINK)
+            NHYK_VM_MEMBER(K[i->c], false)
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(INSET)
+            R[i->a] = NhykValue::ofBool(inSet(program, i->c, R[i->b]));
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(NOTINSET)
+            R[i->a] = NhykValue::ofBool(!inSet(program, i->c, R[i->b]));
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(MAKELIST)
+            R[i->a] = makeList(R + i->b, i->c, top);
+            NHYK_VM_NEXT();
+
+        NHYK_VM_CASE(JMP)
+            ip = code + i->b;
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(JMPF) {
+            const NhykValue& x = R[i->a];
+            if (x.type != NhykType::BOOL) NHYK_VM_FAIL(TYPE_ERROR);
+            if (!x.boolean) ip = code + i->b;
+            NHYK_VM_NEXT();
+        }
+        NHYK_VM_CASE(JMPT) {
+            const NhykValue& x = R[i->a];
+            if (x.type != NhykType::BOOL) NHYK_VM_FAIL(TYPE_ERROR);
+            if (x.boolean) ip = code + i->b;
+            NHYK_VM_NEXT();
+        }
+        NHYK_VM_CASE(FORPREP) {
+            const NhykValue& x = R[i->a];
+            const NhykValue& limit = R[i->b];
+            if (x.type == NhykType::INTEGER && limit.type == NhykType::INTEGER) {
+                if (x.integer > limit.integer) ip = code + i->c;
+            } else if (isNumber(x) && isNumber(limit)) {
+                if (toDouble(x) > toDouble(limit)) ip = code + i->c;
+            } else {
+                NHYK_VM_FAIL(TYPE_ERROR);
+            }
+            NHYK_VM_NEXT();
+        }
+        NHYK_VM_CASE(FORLOOP) {
+            // The body may have assigned the counter, so its type is checked again.
+            NhykValue& x = R[i->a];
+            const NhykValue& limit = R[i->b];
+            // The INTEGER counter is compared before it steps, so a loop up to the largest
+            // INTEGER ends instead of overflowing; the step itself wraps like ADD.
+            if (x.type == NhykType::INTEGER && limit.type == NhykType::INTEGER) {
+                if (x.integer < limit.integer) ip = code + i->c;
+                x.integer = wrap(static_cast<uint64_t>(x.integer) + 1);
+            } else if (x.type == NhykType::INTEGER) {
+                if (x.integer != INT64_MAX && static_cast<double>(x.integer + 1) <= limit.real) ip = code + i->c;
+                x.integer = wrap(static_cast<uint64_t>(x.integer) + 1);
+            } else if (x.type == NhykType::DOUBLE) {
+                x.real += 1.0;
+                if (x.real <= toDouble(limit)) ip = code + i->c;
+            } else {
+                NHYK_VM_FAIL(TYPE_ERROR);
+            }
+            NHYK_VM_NEXT();
+        }
+
+        NHYK_VM_CASE(CALL) {
+            const NhykFunction& function = functions[i->b];
+            if (frames.size() >= MAX_CALL_DEPTH) NHYK_VM_FAIL(STACK_OVERFLOW);
+            const size_t callee = base + i->a;
+            if (callee + function.registers > stack.size()) {
+                stack.resize(std::max(stack.size() * 2, callee + function.registers), NhykValue::none());
+                G = stack.data();
+            }
+            frames.push_back(Frame{ip, base, top});
+            base = callee;
+            top = callee + function.registers;
+            R = stack.data() + base;
+            // Variables other than the parameters start out as NONE on every call.
+            for (uint32_t r = function.params; r < function.registers; ++r) R[r] = NhykValue::none();
+            ip = code + function.entry;
+            NHYK_VM_NEXT();
+        }
+        NHYK_VM_CASE(RET) {
+            const NhykValue result = R[i->a];
+            R[0] = result;
+            const Frame& frame = frames.back();
+            ip = frame.returnTo;
+            base = frame.base;
+            top = frame.top;
+            frames.pop_back();
+            R = stack.data() + base;
+            NHYK_VM_NEXT();
+        }
+        NHYK_VM_CASE(RET0) {
+            R[0] = NhykValue::none();
+            const Frame& frame = frames.back();
+            ip = frame.returnTo;
+            base = frame.base;
+            top = frame.top;
+            frames.pop_back();
+            R = stack.data() + base;
+            NHYK_VM_NEXT();
+        }
+
+        NHYK_VM_CASE(OUTPUT)
+            for (uint32_t k = 0; k < i->b; ++k) {
+                if (k != 0) output += ' ';
+                format(output, R[i->a + k]);
+            }
+            output += '\n';
+            if (output.size() >= OUTPUT_FLUSH) flush();
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(INPUT)
+            R[i->a] = read(top);
+            NHYK_VM_NEXT();
+        NHYK_VM_CASE(HALT)
+            goto done;
+#if !NHYK_VM_COMPUTED_GOTO
+        }
+#endif
+    }
+
+#undef NHYK_VM_CASE
+#undef NHYK_VM_NEXT
+#undef NHYK_VM_MEMBER
+#undef NHYK_VM_EQUAL
+#undef NHYK_VM_ORDER
+#undef NHYK_VM_DIVIDE
+#undef NHYK_VM_JOIN
+#undef NHYK_VM_ARITHMETIC
+#undef NHYK_VM_FAIL
+
+fail: {
+        const NhykSpan& span = program.spans[static_cast<size_t>(i - code)];
+        diagnostics.report(failure, span.offset, span.length);
+    }
+done:
+    steps = count;
+    flush();
+    return diagnostics.empty();
+}
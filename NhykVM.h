@@ -0,0 +1,138 @@
+#ifndef NHYKVM_H_INCLUDED
+#define NHYKVM_H_INCLUDED
+
+/**
+ * @file NhykVM.h
+ * @brief Defines NhykVM, the interpreter for programs compiled by NhykCompiler.
+ *
+ * The registers of every active call are windows on one value stack: a call's frame
+ * starts at its caller's first argument register, so arguments are passed without
+ * copying and the result is left where the caller expects it. The main program's frame
+ * is at the bottom, and its variables are the globals.
+ *
+ * Dispatch is direct-threaded where the compiler supports it (GCC and Clang's labels as
+ * values): each instruction handler ends in its own indirect jump through a table of
+ * handler addresses, so branch predictors see one jump per opcode pair instead of a
+ * single shared switch jump. Elsewhere the same handlers run from a switch.
+ *
+ * Arithmetic on two INTEGERs stays INTEGER and wraps around on overflow; an INTEGER and
+ * a DOUBLE give a DOUBLE. Equality holds between equal numbers of either type, and
+ * otherwise needs equal types; the ordering comparisons take two numbers or two
+ * STRINGs. Conditions must be BOOL. A runtime error (an operand of the wrong type, an
+ * INTEGER division by zero, calls nested deeper than MAX_CALL_DEPTH) stops the program
+ * and is reported at the token of the failing instruction.
+ *
+ * Lists built by MAKELIST and strings made by + or INPUT live in storage owned by the VM
+ * and reset by every run. When it outgrows twice what was live after the last
+ * collection (and at least MIN_HEAP bytes), the values no register of a running frame
+ * can reach are freed and the rest moved down and renumbered, so a loop that keeps
+ * making lists or strings runs in bounded memory.
+ *
+ * OUTPUT writes its values separated by spaces, with a newline, into a buffer that is
+ * flushed to the output stream when it fills and when the program stops. INPUT reads a
+ * whitespace-separated word and makes it an INTEGER, a DOUBLE, TRUE or FALSE if it
+ * reads as one, and a STRING otherwise; at the end of input it gives NONE.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "NhykBytecode.h"
+#include "NhykDiagnostics.h"
+#include "NhykLines.h"
+#include "NhykSymbols.h"
+
+class NhykVM {
+public:
+    static constexpr size_t MAX_CALL_DEPTH = 10000;
+    static constexpr size_t MIN_HEAP = 1 << 20;
+
+    // String constants are read from 'names', which must be the table the programs
+    // were compiled with.
+    explicit NhykVM(NhykSymbolTable& names);
+    NhykVM(const NhykVM&) = delete;
+    NhykVM& operator=(const NhykVM&) = delete;
+
+    void setOutput(std::ostream& stream) {out = &stream;}
+    void setInput(std::istream& stream) {in = &stream;}
+
+    // Runs 'program' from the start of its main program until it ends or fails.
+    // Returns false on a runtime error, which getErrors() then describes.
+    bool run(const NhykProgram& program);
+
+    // Instructions executed by the last run.
+    uint64_t getSteps() const {return steps;}
+    // The value stack after the last run; its first NhykProgram::globals values are the
+    // main program's variables. Its lists and strings are read with format() and
+    // getString() until the next run.
+    const std::vector<NhykValue>& getStack() const {return stack;}
+    // Appends the text OUTPUT would show for 'value' (lists included) to 'text'.
+    void format(std::string& text, const NhykValue& value) const;
+    // The text of a STRING value, interned or made by the last run.
+    std::string_view getString(const NhykValue& value) const {
+        if ((value.symbol & NHYK_HEAP_STRING) == 0) return names.name(value.symbol);
+        const Text& text = strings[value.symbol & ~NHYK_HEAP_STRING];
+        return std::string_view(chars.data() + text.first, text.length);
+    }
+
+    // The runtime error of the last run, if any, with its line, column and message.
+    std::vector<ErrorToken> getErrors() const;
+    const NhykDiagnostics& getDiagnostics() const {return diagnostics;}
+
+private:
+    struct Frame {
+        const NhykInstruction* returnTo;
+        size_t base;
+        size_t top;                    // One past the caller's last register.
+    };
+
+    // A string made at run time: chars[first, first + length).
+    struct Text {
+        size_t first;
+        size_t length;
+    };
+
+    NhykSymbolTable& names;
+    std::ostream* out;
+    std::istream* in;
+    std::vector<NhykValue> stack;
+    std::vector<Frame> frames;
+    std::vector<NhykListRange> lists;  // The program's constant lists, then those built by MAKELIST.
+    std::vector<NhykValue> listItems;
+    std::vector<Text> strings;         // Strings made at run time, by index.
+    std::string chars;
+    uint32_t fixedLists;               // The program's constant lists and their items, which
+    size_t fixedItems;                 // are never collected.
+    size_t heapLimit;                  // Heap bytes that trigger the next collection.
+    std::vector<uint32_t> newLists;    // Scratch for collect().
+    std::vector<uint32_t> newStrings;
+    std::vector<uint32_t> pending;
+    std::string output;
+    std::string joined;                // Scratch for STRING + STRING.
+    uint64_t steps;
+
+    NhykDiagnostics diagnostics;
+    mutable NhykLineIndex lines;
+    std::string_view source;
+
+    bool equal(const NhykValue& a, const NhykValue& b) const;
+    bool contains(const NhykValue& list, const NhykValue& value) const;
+    bool inSet(const NhykProgram& program, uint32_t set, const NhykValue& value) const;
+    NhykValue makeList(const NhykValue* values, uint32_t count, size_t top);
+    NhykValue makeString(std::string_view text, size_t top);
+    size_t heapBytes() const;
+    void collect(size_t top);
+    NhykValue read(size_t top);
+    void flush();
+};
+
+#endif // NHYKVM_H_INCLUDED
@@ -1,50 +1,90 @@
-#ifndef TOKEN_H
-#define TOKEN_H
-
-#include <string>
-#include <iostream>
-#include <fstream>
-#include <vector>
-
-/**
- * @file Token.h
- * @brief Defines the Token class for lexical analysis in the Nhyk compiler.
- *
- * This file contains the definition of the Token class, which represents
- * individual tokens generated during lexical analysis in the Nhyk compiler.
- *
- * @author MNS Ahimbisibwe
- * @SN 217005435
- * @date [2023/09/03]
- * @model Lexical Analysis Design
- * @version [D01]
- */
-
-enum class TokenType {
-    KEYWORD,
-    IDENTIFIER,
-    LITERAL,
-    PUNCTUATION,
-    OPERATOR,
-    BOOLEAN_LITERAL,
-    INT_LITERAL,
-    DOUBLE_LITERAL,
-    UNKNOWN
-};
-
-class Token {
-private:
-    TokenType type;
-    std::string lexeme;
-
-public:
-    Token();
-    Token(TokenType t, const std::string& lex);
-
-    TokenType getType() const;
-    const std::string& getLexeme() const;
-
-    friend std::ostream& operator<<(std::ostream& os, const std::vector<Token>& tokens);
-};
-
-#endif // TOKEN_H
+#ifndef TOKEN_H
+#define TOKEN_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include "Keywords.h"
+
+/**
+ * @file Token.h
+ * @brief Defines the Token class for lexical analysis in the Nhyk compiler.
+ *
+ * This file contains the definition of the Token class, which represents
+ * individual tokens generated during lexical analysis in the Nhyk compiler.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+enum class TokenType : uint8_t {
+    KEYWORD,
+    IDENTIFIER,
+    LITERAL,
+    PUNCTUATION,
+    OPERATOR,
+    BOOLEAN_LITERAL,
+    INT_LITERAL,
+    DOUBLE_LITERAL,
+    UNKNOWN,
+    END_OF_INPUT       // Returned by the pull interface once the source is exhausted.
+};
+
+/*
+*   A Token does not own its text: 'lexeme' is a view into the source buffer held by
+*   the NhykLexer that produced it, and stays valid for as long as that buffer does.
+*   IDENTIFIER and string LITERAL tokens also carry the id their text was interned
+*   under (see NhykSymbols.h), so later stages can compare names as integers.
+*   INT_LITERAL and DOUBLE_LITERAL tokens carry their value, converted by the lexer.
+*/
+class Token {
+private:
+    TokenType type;
+    KeywordKind keyword;               // Which keyword, for KEYWORD tokens; NONE otherwise.
+    uint32_t symbol;                   // Interned id of the text, or NO_SYMBOL.
+    union {
+        int64_t integer;               // INT_LITERAL tokens.
+        double real;                   // DOUBLE_LITERAL tokens.
+    } value;                           // Zero for every other type.
+    std::string_view lexeme;
+
+public:
+    static constexpr uint32_t NO_SYMBOL = 0xFFFFFFFF;
+
+    Token();
+    Token(TokenType t, std::string_view lex, KeywordKind kw = KeywordKind::NONE, uint32_t sym = NO_SYMBOL);
+
+    TokenType getType() const;
+    KeywordKind getKeyword() const {return keyword;}
+    std::string_view getLexeme() const;
+    // Symbol id of an identifier's name or a string literal's contents (without quotes).
+    uint32_t getSymbol() const {return symbol;}
+    bool hasSymbol() const {return symbol != NO_SYMBOL;}
+    void setSymbol(uint32_t sym) {symbol = sym;}
+    // Value of an INT_LITERAL or DOUBLE_LITERAL token (see NhykNumbers.h).
+    int64_t getInt() const {return value.integer;}
+    double getDouble() const {return value.real;}
+    void setInt(int64_t v) {value.integer = v;}
+    void setDouble(double v) {value.real = v;}
+
+    friend std::ostream& operator<<(std::ostream& os, const std::vector<Token>& tokens);
+};
+
+// Name of each token type as printed in the token table, indexed by TokenType.
+inline constexpr std::string_view tokenTypeNames[] = {
+    "KEYWORD", "IDENTIFIER", "LITERAL", "PUNCTUATION", "OPERATOR",
+    "BOOLEAN_LITERAL", "INT_LITERAL", "DOUBLE_LITERAL", "UNKNOWN", "END_OF_INPUT"
+};
+static_assert(sizeof(tokenTypeNames) / sizeof(tokenTypeNames[0]) == static_cast<size_t>(TokenType::END_OF_INPUT) + 1,
+              "tokenTypeNames must name every TokenType");
+
+// Name of a token type as printed in the token table ("KEYWORD", "IDENTIFIER", ...).
+std::string TokenTypeToString(TokenType type);
+
+#endif // TOKEN_H
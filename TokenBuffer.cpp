@@ -0,0 +1,112 @@
+#include "TokenBuffer.h"
+#include "NhykScan.h"
+#include "NhykDump.h"
+#include <algorithm>
+/**
+ * @file TokenBuffer.cpp
+ * @brief Implementation of the struct-of-arrays token store.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+TokenBuffer::TokenBuffer() : numberRows(0), arena(4096) {}
+
+void TokenBuffer::reset(std::string_view src, size_t expectedTokens) {
+    source = src;
+    kinds.clear();
+    offsets.clear();
+    lengths.clear();
+    symbols.clear();
+    numbers.clear();
+    numberRows = 0;
+    arena.reset();
+    reserve(expectedTokens != 0 ? expectedTokens : estimateTokens(src.size()));
+}
+
+void TokenBuffer::adoptSource() {
+    source = arena.copy(source);
+}
+
+void TokenBuffer::reserve(size_t count) {
+    kinds.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+    symbols.reserve(count);
+}
+
+void TokenBuffer::splice(size_t first, size_t count, const TokenBuffer& rows) {
+    for (size_t i = first; i < first + count; ++i) {
+        if (isNumber(kinds[i])) --numberRows;
+    }
+    nhykSpliceColumn(kinds, first, count, rows.kinds);
+    nhykSpliceColumn(offsets, first, count, rows.offsets);
+    nhykSpliceColumn(lengths, first, count, rows.lengths);
+    nhykSpliceColumn(symbols, first, count, rows.symbols);
+    // The new rows' numbers go after this buffer's own.
+    const uint32_t base = static_cast<uint32_t>(numbers.size());
+    numbers.insert(numbers.end(), rows.numbers.begin(), rows.numbers.end());
+    numberRows += rows.numberRows;
+    for (size_t i = first; i < first + rows.size(); ++i) {
+        if (isNumber(kinds[i])) symbols[i] += base;
+    }
+    if (numbers.size() > 2 * numberRows + 64) compactNumbers();
+}
+
+void TokenBuffer::compactNumbers() {
+    std::vector<TokenNumber> live;
+    live.reserve(numberRows);
+    for (size_t i = 0; i < kinds.size(); ++i) {
+        if (!isNumber(kinds[i])) continue;
+        live.push_back(numbers[symbols[i]]);
+        symbols[i] = static_cast<uint32_t>(live.size() - 1);
+    }
+    numbers.swap(live);
+}
+
+void TokenBuffer::shift(size_t from, int64_t delta) {
+    // Unsigned wrap-around makes a negative delta a subtraction.
+    if (from < offsets.size()) nhykAddEach(offsets.data() + from, offsets.size() - from, static_cast<uint32_t>(delta));
+}
+
+Token TokenBuffer::at(size_t i) const {
+    TokenType type = kind(i);
+    std::string_view text = lexeme(i);
+    if (type == TokenType::INT_LITERAL || type == TokenType::DOUBLE_LITERAL) {
+        Token token(type, text);
+        if (type == TokenType::INT_LITERAL) token.setInt(intValue(i));
+        else token.setDouble(doubleValue(i));
+        return token;
+    }
+    return Token(type, text, type == TokenType::KEYWORD ? lookupKeyword(text) : KeywordKind::NONE, symbols[i]);
+}
+
+size_t TokenBuffer::count(TokenType kind) const {
+    // A plain counting loop over the byte column; compilers vectorize it.
+    const uint8_t wanted = static_cast<uint8_t>(kind);
+    return static_cast<size_t>(std::count(kinds.begin(), kinds.end(), wanted));
+}
+
+size_t TokenBuffer::memoryUsage() const {
+    return kinds.capacity() * sizeof(uint8_t) + offsets.capacity() * sizeof(uint32_t)
+         + lengths.capacity() * sizeof(uint32_t) + symbols.capacity() * sizeof(uint32_t)
+         + numbers.capacity() * sizeof(TokenNumber)
+         + arena.bytesReserved();
+}
+
+std::vector<Token> TokenBuffer::toVector() const {
+    std::vector<Token> tokens;
+    tokens.reserve(size());
+    for (size_t i = 0; i < size(); ++i) tokens.push_back(at(i));
+    return tokens;
+}
+
+// Prints the same table as operator<< on a std::vector<Token>, without building one.
+std::ostream& operator<<(std::ostream& os, const TokenBuffer& tokens) {
+    NhykTokenWriter writer(os);
+    writer.write(tokens);
+    return os;
+}
@@ -0,0 +1,161 @@
+#ifndef TOKENBUFFER_H
+#define TOKENBUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+#include "NhykArena.h"
+#include "Token.h"
+
+/**
+ * @file TokenBuffer.h
+ * @brief Defines TokenBuffer, a compact struct-of-arrays store for a source's tokens.
+ *
+ * A std::vector<Token> spends 32 bytes on every token. TokenBuffer keeps the same
+ * information in parallel arrays: a one-byte kind, the 32-bit offset and length of
+ * the lexeme in the source, and the 32-bit symbol id, 13 bytes per token. Numbers have
+ * no symbol, so an INT_LITERAL or DOUBLE_LITERAL token's symbol column holds the index
+ * of its value in a side array instead: the lexer converts each number once and the
+ * parser reads the value from there. Keyword kinds are not stored; they are recovered
+ * from the lexeme when a Token is rebuilt.
+ * Passes that only look at token kinds read one dense byte array, which the compiler
+ * can vectorize.
+ *
+ * Lexemes are views into the buffer's source. When that source is transient (a stream
+ * chunk, a mapping about to be closed), adoptSource() copies it into the buffer's arena,
+ * which also holds any other text the buffer has to own.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+// Replaces column[first, first + count) with 'rows', overwriting in place where the two
+// overlap so that the tail moves at most once (and not at all when the sizes match).
+template <typename T>
+void nhykSpliceColumn(std::vector<T>& column, size_t first, size_t count, const std::vector<T>& rows) {
+    const size_t common = count < rows.size() ? count : rows.size();
+    std::copy(rows.begin(), rows.begin() + common, column.begin() + first);
+    if (count > rows.size())
+        column.erase(column.begin() + first + common, column.begin() + first + count);
+    else
+        column.insert(column.begin() + first + common, rows.begin() + common, rows.end());
+}
+
+// Value of a numeric token: 'integer' for INT_LITERAL, 'real' for DOUBLE_LITERAL.
+union TokenNumber {
+    int64_t integer;
+    double real;
+};
+
+class TokenBuffer {
+private:
+    std::string_view source;
+    std::vector<uint8_t> kinds;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+    std::vector<uint32_t> symbols;
+    std::vector<TokenNumber> numbers;  // Indexed by the symbol column of numeric tokens.
+    size_t numberRows;                 // Rows that use an entry of 'numbers'.
+    NhykArena arena;
+
+    static bool isNumber(uint8_t kind) {
+        return kind == static_cast<uint8_t>(TokenType::INT_LITERAL) || kind == static_cast<uint8_t>(TokenType::DOUBLE_LITERAL);
+    }
+    void pushNumber(TokenType kind, uint32_t offset, uint32_t length, TokenNumber value) {
+        numbers.push_back(value);
+        ++numberRows;
+        push(kind, offset, length, static_cast<uint32_t>(numbers.size() - 1));
+    }
+    // Drops the values of removed rows once they outnumber the live ones.
+    void compactNumbers();
+
+public:
+    TokenBuffer();
+
+    // Number of tokens to reserve for 'bytes' bytes of source: real programs average
+    // about four bytes per token, so this rarely needs to grow and never grows twice.
+    static size_t estimateTokens(size_t bytes) {return bytes / 4 + 16;}
+
+    // Drops all tokens and owned text and starts over on 'src', reserving room for
+    // 'expectedTokens' tokens (estimated from the size of 'src' when 0).
+    void reset(std::string_view src, size_t expectedTokens = 0);
+    // Copies the current source into the arena so the tokens no longer depend on it.
+    void adoptSource();
+    // Points the existing rows at 'src' (the same text, moved or edited in place).
+    void rebase(std::string_view src) {source = src;}
+    // Copies 'text' into the arena; the view lives as long as the buffer's tokens.
+    std::string_view storeText(std::string_view text) {return arena.copy(text);}
+
+    void reserve(size_t count);
+    // Replaces rows [first, first + count) with all the rows of 'rows', whose offsets
+    // must already be in this buffer's coordinates. Their numbers come along.
+    void splice(size_t first, size_t count, const TokenBuffer& rows);
+    // Adds 'delta' to the offsets of rows [from, size()).
+    void shift(size_t from, int64_t delta);
+    // Adds a token that is not a number.
+    void push(TokenType kind, uint32_t offset, uint32_t length, uint32_t symbol = Token::NO_SYMBOL) {
+        kinds.push_back(static_cast<uint8_t>(kind));
+        offsets.push_back(offset);
+        lengths.push_back(length);
+        symbols.push_back(symbol);
+    }
+    void pushInt(uint32_t offset, uint32_t length, int64_t value) {
+        TokenNumber number;
+        number.integer = value;
+        pushNumber(TokenType::INT_LITERAL, offset, length, number);
+    }
+    void pushDouble(uint32_t offset, uint32_t length, double value) {
+        TokenNumber number;
+        number.real = value;
+        pushNumber(TokenType::DOUBLE_LITERAL, offset, length, number);
+    }
+    // Adds 'token', whose lexeme starts at 'offset', with its symbol or numeric value.
+    void push(const Token& token, uint32_t offset) {
+        const uint32_t length = static_cast<uint32_t>(token.getLexeme().size());
+        if (token.getType() == TokenType::INT_LITERAL) pushInt(offset, length, token.getInt());
+        else if (token.getType() == TokenType::DOUBLE_LITERAL) pushDouble(offset, length, token.getDouble());
+        else push(token.getType(), offset, length, token.getSymbol());
+    }
+
+    size_t size() const {return kinds.size();}
+    bool empty() const {return kinds.empty();}
+    std::string_view getSource() const {return source;}
+
+    TokenType kind(size_t i) const {return static_cast<TokenType>(kinds[i]);}
+    uint32_t offset(size_t i) const {return offsets[i];}
+    uint32_t length(size_t i) const {return lengths[i];}
+    // Symbol id of an IDENTIFIER or LITERAL token; see intValue() for numbers.
+    uint32_t symbol(size_t i) const {return symbols[i];}
+    // Value of an INT_LITERAL or a DOUBLE_LITERAL token, as the lexer converted it.
+    int64_t intValue(size_t i) const {return numbers[symbols[i]].integer;}
+    double doubleValue(size_t i) const {return numbers[symbols[i]].real;}
+    std::string_view lexeme(size_t i) const {return source.substr(offsets[i], lengths[i]);}
+    // Rebuilds the i-th token, keyword kind and numeric value included.
+    Token at(size_t i) const;
+    Token operator[](size_t i) const {return at(i);}
+
+    // The raw columns, for passes that scan them directly.
+    const uint8_t* kindData() const {return kinds.data();}
+    const uint32_t* offsetData() const {return offsets.data();}
+    const uint32_t* lengthData() const {return lengths.data();}
+    const uint32_t* symbolData() const {return symbols.data();}
+    // Values of the numeric tokens, indexed by their symbol column.
+    const TokenNumber* numberData() const {return numbers.data();}
+
+    // Number of tokens of the given kind.
+    size_t count(TokenType kind) const;
+    // Bytes held by the arrays and the arena.
+    size_t memoryUsage() const;
+
+    std::vector<Token> toVector() const;
+    friend std::ostream& operator<<(std::ostream& os, const TokenBuffer& tokens);
+};
+
+static_assert(static_cast<int>(TokenType::END_OF_INPUT) <= UINT8_MAX, "TokenBuffer stores token kinds in one byte");
+
+#endif // TOKENBUFFER_H
@@ -0,0 +1,251 @@
+#include "NhykCorpus.h"
+/**
+ * @file NhykCorpus.cpp
+ * @brief Implementation of the synthetic corpus generator.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+const NhykCorpusMix nhykCorpusMixes[] = {
+    // name           ids nums strs  len  err%
+    {"mixed",          4,  2,   1,    8,   0},
+    {"identifiers",   12,  1,   0,    8,   0},
+    {"literals",       1,  8,   4,    8,   0},
+    {"strings",        1,  1,   6,  200,   0},
+    {"errors",         4,  2,   1,    8,  30},
+};
+const size_t nhykCorpusMixCount = sizeof(nhykCorpusMixes) / sizeof(nhykCorpusMixes[0]);
+
+const NhykCorpusMix* nhykFindCorpusMix(std::string_view name) {
+    for (size_t i = 0; i < nhykCorpusMixCount; ++i)
+        if (name == nhykCorpusMixes[i].name) return &nhykCorpusMixes[i];
+    return nullptr;
+}
+
+namespace {
+
+// Writes statements into 'out'. Every choice goes through 'below' so the output does
+// not depend on the standard library's distributions.
+class Generator {
+public:
+    Generator(const NhykCorpusMix& m, uint64_t seed, std::string& text) : mix(m), state(seed), out(text) {}
+
+    void program(size_t bytes) {
+        out += "PROG corpus:\nBEGIN\n";
+        while (out.size() < bytes) {
+            statement(1);
+            if (below(100) < mix.errorPercent) error();
+            out += '\n';
+        }
+        out += "END\n";
+    }
+
+private:
+    const NhykCorpusMix& mix;
+    uint64_t state;
+    std::string& out;
+
+    // splitmix64.
+    uint64_t random() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    unsigned below(unsigned bound) {return static_cast<unsigned>(random() % bound);}
+
+    void indent(int depth) {out.append(static_cast<size_t>(depth) * 4, ' ');}
+
+    void identifier() {
+        static const char* const stems[] = {"count", "rate", "name", "total", "x", "y", "i", "userNumbers", "num", "result"};
+        out += stems[below(sizeof(stems) / sizeof(stems[0]))];
+        // Most names are reused; some carry a suffix so the symbol table keeps growing.
+        if (below(4) == 0) {
+            out += '_';
+            out += std::to_string(below(1000));
+        }
+    }
+
+    void number() {
+        out += std::to_string(below(100000));
+        if (below(3) == 0) {
+            out += '.';
+            out += std::to_string(below(100));
+        }
+    }
+
+    void string() {
+        static const char* const words[] = {"Nhyk", "John", "Doe", "Low", "Medium", "High", "lotto", "value", "of", "the", "program"};
+        size_t end = out.size() + 1 + mix.stringLength / 2 + below(mix.stringLength + 1);
+        out += '"';
+        while (out.size() < end) {
+            out += words[below(sizeof(words) / sizeof(words[0]))];
+            out += ' ';
+        }
+        out += '"';
+    }
+
+    void operand() {
+        unsigned total = mix.identifiers + mix.numbers + mix.strings;
+        unsigned pick = below(total != 0 ? total : 1);
+        if (pick < mix.identifiers) identifier();
+        else if (pick < mix.identifiers + mix.numbers) number();
+        else string();
+    }
+
+    void expression() {
+        static const char* const operators[] = {" + ", " - ", " * ", " / "};
+        operand();
+        for (unsigned terms = below(3); terms > 0; --terms) {
+            out += operators[below(4)];
+            operand();
+        }
+    }
+
+    void condition() {
+        static const char* const comparisons[] = {" > ", " >= ", " < ", " <= ", " == ", " != "};
+        if (below(4) == 0) {
+            identifier();
+            out += " IS NOT IN [";
+            for (unsigned items = 1 + below(4); items > 0; --items) {
+                operand();
+                if (items > 1) out += ", ";
+            }
+            out += ']';
+        } else {
+            expression();
+            out += comparisons[below(6)];
+            expression();
+        }
+        if (below(3) == 0) {
+            out += " AND ";
+            condition();
+        }
+    }
+
+    void block(int depth) {
+        out += " {\n";
+        for (unsigned count = 1 + below(3); count > 0; --count) statement(depth + 1);
+        indent(depth);
+        out += '}';
+    }
+
+    void statement(int depth) {
+        indent(depth);
+        // Nesting is limited so statements stay a few lines long.
+        switch (depth < 3 ? below(8) : below(3)) {
+            case 0:
+                identifier();
+                out += " = ";
+                expression();
+                out += ";\n";
+                return;
+            case 1:
+                out += "OUTPUT ";
+                expression();
+                out += ";\n";
+                return;
+            case 2:
+                out += "VAR ";
+                for (unsigned names = 1 + below(3); names > 0; --names) {
+                    identifier();
+                    out += " = ";
+                    operand();
+                    out += names > 1 ? ", " : ";\n";
+                }
+                return;
+            case 3:
+                out += "FUNC ";
+                identifier();
+                out += "(x, y) {\n";
+                indent(depth + 1);
+                out += "RETURN ";
+                expression();
+                out += ";\n";
+                indent(depth);
+                out += "}\n";
+                return;
+            case 4:
+                out += "FOR i = 1 TO ";
+                number();
+                block(depth);
+                out += '\n';
+                return;
+            case 5:
+                out += "WHILE ";
+                condition();
+                block(depth);
+                out += '\n';
+                return;
+            case 6:
+                out += "IF ";
+                condition();
+                out += " THEN";
+                block(depth);
+                if (below(2) == 0) {
+                    out += " ELIF ";
+                    condition();
+                    out += " THEN";
+                    block(depth);
+                }
+                out += " ELSE";
+                block(depth);
+                out += '\n';
+                return;
+            default:
+                out += "MATCH ";
+                identifier();
+                out += " {\n";
+                for (unsigned cases = 1 + below(3); cases > 0; --cases) {
+                    indent(depth + 1);
+                    out += "CASE ";
+                    out += std::to_string(cases);
+                    out += ": OUTPUT ";
+                    string();
+                    out += ";\n";
+                }
+                indent(depth + 1);
+                out += "DEFAULT: OUTPUT ";
+                string();
+                out += ";\n";
+                indent(depth);
+                out += "}\n";
+                return;
+        }
+    }
+
+    // Input for the error paths: malformed numbers, stray characters, bytes that are
+    // not UTF-8, unterminated strings.
+    void error() {
+        switch (below(4)) {
+            case 0:
+                number();
+                out += "pop ";
+                return;
+            case 1:
+                out += "@#$ ";
+                return;
+            case 2:
+                for (unsigned count = 1 + below(16); count > 0; --count)
+                    out += static_cast<char>(0x80 + below(0x80));
+                out += ' ';
+                return;
+            default:
+                out += "\"unterminated";
+                return;
+        }
+    }
+};
+
+} // namespace
+
+std::string nhykGenerateCorpus(const NhykCorpusMix& mix, size_t bytes, uint64_t seed) {
+    std::string text;
+    text.reserve(bytes + 4096);
+    Generator(mix, seed, text).program(bytes);
+    return text;
+}
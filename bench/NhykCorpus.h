@@ -0,0 +1,50 @@
+#ifndef NHYKCORPUS_H_INCLUDED
+#define NHYKCORPUS_H_INCLUDED
+
+/**
+ * @file NhykCorpus.h
+ * @brief Generates synthetic Nhyk source of any size for benchmarks.
+ *
+ * The generator writes whole statements in the style of the sample programs in
+ * main.cpp (VAR declarations, FUNC definitions, FOR/WHILE loops, IF/ELIF/ELSE,
+ * MATCH/CASE, IS NOT IN lists) into one PROG ... BEGIN ... END program until the
+ * requested size is reached. Without errors mixed in, the program parses cleanly. A mix sets how
+ * expression operands are drawn (identifiers, numbers, strings), how long strings are,
+ * and how often a statement is followed by bad input for the error paths.
+ *
+ * Output depends only on the mix, the size and the seed, so runs are comparable across
+ * machines and commits.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date [2023/09/03]
+ * @model Lexical Analysis Design
+ * @version [D01]
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+struct NhykCorpusMix {
+    const char* name;
+    unsigned identifiers;              // Relative weight of identifier operands.
+    unsigned numbers;                  // Relative weight of integer and double operands.
+    unsigned strings;                  // Relative weight of string literal operands.
+    unsigned stringLength;             // Average characters in a string literal.
+    unsigned errorPercent;             // Statements followed by malformed or invalid input.
+};
+
+// The built-in mixes: "mixed", "identifiers", "literals", "strings" and "errors".
+extern const NhykCorpusMix nhykCorpusMixes[];
+extern const size_t nhykCorpusMixCount;
+
+// The built-in mix called 'name', or nullptr.
+const NhykCorpusMix* nhykFindCorpusMix(std::string_view name);
+
+// About 'bytes' bytes of Nhyk source drawn from 'mix' (it ends after the statement that
+// crosses the size).
+std::string nhykGenerateCorpus(const NhykCorpusMix& mix, size_t bytes, uint64_t seed = 1);
+
+#endif // NHYKCORPUS_H_INCLUDED
@@ -0,0 +1,265 @@
+#include "NhykCorpus.h"
+#include "../LexGraph.h"
+#include "../NhykParser.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/**
+ * @file nhykbench.cpp
+ * @brief Lexer and parser benchmark suite over synthetic corpora.
+ *
+ * Usage: nhykbench [-s MiB] [-m mix]... [-b filter] [-t seconds]
+ *
+ *   -s N   corpus size in MiB (default: 16)
+ *   -m X   corpus mix to run (default: all of them); see NhykCorpus.cpp
+ *   -b X   only run benchmarks whose name contains X
+ *   -t S   minimum measuring time per benchmark in seconds (default: 0.5)
+ *
+ * Each benchmark lexes the whole corpus from scratch per iteration: NhykLexer::tokenize
+ * into a token vector and into a TokenBuffer, and every LexGraph FSM on its own, driven
+ * over the corpus from each byte it can start a token on. NhykParser::parse measures the
+ * whole front end: tokenize into a TokenBuffer, then parse it. For each one the suite
+ * prints the time per iteration, MB/s, millions of tokens per second, heap allocations
+ * per iteration (counted by the replaced global operator new below) and the peak
+ * resident set size while it ran. Iterations repeat until the minimum time is reached.
+ *
+ * Built by the 'nhykbench' target of CMakeLists.txt.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+// --- Allocation counting ---
+
+namespace {
+std::atomic<uint64_t> allocations{0};
+}
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size != 0 ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {return operator new(size);}
+void operator delete(void* memory) noexcept {std::free(memory);}
+void operator delete[](void* memory) noexcept {std::free(memory);}
+void operator delete(void* memory, size_t) noexcept {std::free(memory);}
+void operator delete[](void* memory, size_t) noexcept {std::free(memory);}
+
+namespace {
+
+// --- Peak resident set size ---
+
+// Restarts the peak measurement where the platform allows it (Linux); elsewhere the
+// peak is the process's since it started.
+void resetPeakRss() {
+#if defined(__linux__)
+    if (FILE* file = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", file);
+        std::fclose(file);
+    }
+#endif
+}
+
+// Peak resident set size in bytes.
+uint64_t peakRss() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.PeakWorkingSetSize;
+    return 0;
+#else
+#if defined(__linux__)
+    // VmHWM follows clear_refs; ru_maxrss does not.
+    if (FILE* file = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        unsigned long long kib = 0;
+        while (std::fgets(line, sizeof(line), file))
+            if (std::sscanf(line, "VmHWM: %llu kB", &kib) == 1) break;
+        std::fclose(file);
+        if (kib != 0) return kib * 1024;
+    }
+#endif
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+// --- Benchmarks ---
+
+// Lexes 'corpus' once and returns the number of tokens produced.
+typedef std::function<size_t(const std::string& corpus)> Body;
+
+struct Benchmark {
+    const char* name;
+    Body body;
+};
+
+size_t lexVector(const std::string& corpus) {
+    NhykLexer lexer{std::string()};
+    lexer.setSourceView(corpus);
+    lexer.tokenize();
+    return lexer.getTokens().size();
+}
+
+size_t lexBuffer(const std::string& corpus) {
+    NhykLexer lexer{std::string()};
+    lexer.setSourceView(corpus);
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+    return tokens.size();
+}
+
+// Lexes into a TokenBuffer and parses it, as a compiler front end would.
+size_t lexAndParse(const std::string& corpus) {
+    NhykLexer lexer{std::string()};
+    lexer.setSourceView(corpus);
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+    NhykParser parser(*lexer.getSymbolTable());
+    parser.parse(tokens);
+    return tokens.size();
+}
+
+// Runs one FSM over the whole corpus: a traversal from every byte its start state has
+// a transition on, skipping the bytes it cannot start a token with.
+template <typename Fsm>
+size_t lexFsm(const std::string& corpus) {
+    Fsm fsm;
+    NhykSymbolTable symbols;
+    fsm.setSymbolTable(&symbols);
+    fsm.compile();
+    const NhykTransitionTable& table = fsm.getTable();
+    const unsigned int length = static_cast<unsigned int>(corpus.size());
+    size_t count = 0;
+    unsigned int position = 0;
+    while (position < length) {
+        if (table.next(0, static_cast<unsigned char>(corpus[position])) == NhykTransitionTable::NO_STATE) {
+            ++position;
+            continue;
+        }
+        fsm.setSource(corpus, position);
+        fsm.publicTraverse(fsm.getStartNode());
+        position = fsm.getPosition() > position ? fsm.getPosition() : position + 1;
+        // Counted and dropped, so the FSM's vector stays at its first size.
+        count += fsm.getTokens().size();
+        fsm.clearTokens();
+    }
+    return count;
+}
+
+struct Result {
+    double seconds = 0;                // Per iteration.
+    uint64_t iterations = 0;
+    size_t tokens = 0;                 // Per iteration.
+    double allocations = 0;            // Per iteration.
+    uint64_t peak = 0;
+};
+
+Result measure(const Body& body, const std::string& corpus, double minSeconds) {
+    Result result;
+    body(corpus);                      // Warm-up: page in the corpus and code.
+    resetPeakRss();
+    uint64_t allocated = allocations.load();
+    auto began = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        result.tokens = body(corpus);
+        ++result.iterations;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+    } while (elapsed < minSeconds);
+    result.seconds = elapsed / static_cast<double>(result.iterations);
+    result.allocations = static_cast<double>(allocations.load() - allocated) / static_cast<double>(result.iterations);
+    result.peak = peakRss();
+    return result;
+}
+
+void usage() {
+    std::fprintf(stderr, "Usage: nhykbench [-s MiB] [-m mix]... [-b filter] [-t seconds]\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double megabytes = 16;
+    double minSeconds = 0.5;
+    std::string filter;
+    std::vector<const NhykCorpusMix*> mixes;
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        if (std::strcmp(argv[i], "-s") == 0) {
+            megabytes = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "-t") == 0) {
+            minSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "-b") == 0) {
+            filter = argv[++i];
+        } else if (std::strcmp(argv[i], "-m") == 0) {
+            const NhykCorpusMix* mix = nhykFindCorpusMix(argv[++i]);
+            if (mix == nullptr) {
+                std::fprintf(stderr, "Unknown mix: %s\n", argv[i]);
+                return 2;
+            }
+            mixes.push_back(mix);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (mixes.empty())
+        for (size_t i = 0; i < nhykCorpusMixCount; ++i) mixes.push_back(&nhykCorpusMixes[i]);
+
+    const Benchmark benchmarks[] = {
+        {"NhykLexer::tokenize",              lexVector},
+        {"NhykLexer::tokenize(TokenBuffer)", lexBuffer},
+        {"NhykParser::parse",                lexAndParse},
+        {"LexGraphID",                       lexFsm<LexGraphID>},
+        {"LexGraphLiteral",                  lexFsm<LexGraphLiteral>},
+        {"LexGraphStringLiteral",            lexFsm<LexGraphStringLiteral>},
+        {"LexGraphOperator",                 lexFsm<LexGraphOperator>},
+        {"LexGraphPunctuation",              lexFsm<LexGraphPunctuation>},
+    };
+
+    std::printf("Scanner: %s\n", nhykScanIsa());
+    std::printf("%-46s %10s %8s %9s %8s %12s %12s\n",
+                "Benchmark", "Time(ms)", "Iters", "MB/s", "Mtok/s", "Allocs/iter", "PeakRSS(MiB)");
+    for (const NhykCorpusMix* mix : mixes) {
+        std::string corpus = nhykGenerateCorpus(*mix, static_cast<size_t>(megabytes * 1024 * 1024));
+        for (const Benchmark& benchmark : benchmarks) {
+            std::string name = std::string(benchmark.name) + "/" + mix->name;
+            if (!filter.empty() && name.find(filter) == std::string::npos) continue;
+            Result result = measure(benchmark.body, corpus, minSeconds);
+            std::printf("%-46s %10.2f %8llu %9.1f %8.2f %12.1f %12.1f\n", name.c_str(),
+                        result.seconds * 1e3,
+                        static_cast<unsigned long long>(result.iterations),
+                        static_cast<double>(corpus.size()) / result.seconds / 1e6,
+                        static_cast<double>(result.tokens) / result.seconds / 1e6,
+                        result.allocations,
+                        static_cast<double>(result.peak) / (1024.0 * 1024.0));
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "../LexGraph.h"
+#include "../NhykCompiler.h"
+#include "../NhykOptimizer.h"
+#include "../NhykParser.h"
+#include "../NhykSource.h"
+#include "../NhykVM.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/**
+ * @file nhykvmbench.cpp
+ * @brief Bytecode VM benchmark over a set of Nhyk programs.
+ *
+ * Usage: nhykvmbench [-t seconds] [-o] [-n] [program.nhyk]...
+ *
+ *   -t S   minimum measuring time per program in seconds (default: 0.5)
+ *   -o     show each program's output (from its first run)
+ *   -n     compile without running NhykOptimizer first
+ *
+ * Without programs it runs the set in bench/programs, from the repository root:
+ * loops.nhyk (nested FOR loops and a WHILE loop over INTEGER and DOUBLE arithmetic),
+ * calls.nhyk (recursive and nested function calls) and membership.nhyk (IS IN and IS
+ * NOT IN over constant and variable lists, and MATCH on a computed value).
+ *
+ * Each program is lexed, parsed and compiled once, then run repeatedly until the
+ * minimum time is reached, with its output discarded. For each one the suite prints
+ * the instructions executed per run, the time per run, and millions of instructions
+ * (VM operations) per second.
+ *
+ * Built by the 'nhykvmbench' target of CMakeLists.txt.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+// Discards everything written to it.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {return c == traits_type::eof() ? 0 : c;}
+    std::streamsize xsputn(const char*, std::streamsize count) override {return count;}
+};
+
+const char* const defaultPrograms[] = {
+    "bench/programs/loops.nhyk",
+    "bench/programs/calls.nhyk",
+    "bench/programs/membership.nhyk",
+};
+
+void printErrors(const char* path, const char* stage, const std::vector<ErrorToken>& errors) {
+    for (const ErrorToken& error : errors) {
+        std::fprintf(stderr, "%s:%u:%u: %s error: %s\n", path, error.line, error.col, stage, error.message.c_str());
+    }
+}
+
+void usage() {
+    std::fprintf(stderr, "Usage: nhykvmbench [-t seconds] [-o] [-n] [program.nhyk]...\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double minSeconds = 0.5;
+    bool showOutput = false;
+    bool optimize = true;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-t") == 0) {
+            if (i + 1 >= argc) {
+                usage();
+                return 2;
+            }
+            minSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "-o") == 0) {
+            showOutput = true;
+        } else if (std::strcmp(argv[i], "-n") == 0) {
+            optimize = false;
+        } else if (argv[i][0] == '-') {
+            usage();
+            return 2;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) paths.assign(std::begin(defaultPrograms), std::end(defaultPrograms));
+
+    NullBuffer nullBuffer;
+    std::ostream discard(&nullBuffer);
+    int status = 0;
+    std::printf("%-36s %14s %10s %8s %10s\n", "Program", "Instructions", "Time(ms)", "Iters", "Mops/s");
+    for (const char* path : paths) {
+        std::unique_ptr<NhykMappedFile> file;
+        try {
+            file.reset(new NhykMappedFile(path));
+        } catch (const std::runtime_error& error) {
+            std::fprintf(stderr, "%s: %s\n", path, error.what());
+            status = 1;
+            continue;
+        }
+
+        NhykLexer lexer{std::string()};
+        lexer.setSourceView(file->view());
+        TokenBuffer tokens;
+        lexer.tokenize(tokens);
+        NhykParser parser(*lexer.getSymbolTable());
+        parser.parse(tokens);
+        if (optimize && lexer.getErrors().empty() && parser.getDiagnostics().empty()) {
+            NhykOptimizer optimizer(parser.getNames());
+            optimizer.optimize(parser.getAst());
+        }
+        NhykCompiler compiler(parser.getNames());
+        NhykProgram program;
+        bool compiled = compiler.compile(parser.getAst(), tokens, program);
+        if (!lexer.getErrors().empty() || !parser.getDiagnostics().empty() || !compiled) {
+            printErrors(path, "lexical", lexer.getErrors());
+            printErrors(path, "syntax", parser.getErrors());
+            printErrors(path, "compile", compiler.getErrors());
+            status = 1;
+            continue;
+        }
+
+        NhykVM vm(parser.getNames());
+        vm.setOutput(showOutput ? std::cout : discard);
+        if (!vm.run(program)) {
+            printErrors(path, "runtime", vm.getErrors());
+            status = 1;
+            continue;
+        }
+        vm.setOutput(discard);
+
+        const uint64_t steps = vm.getSteps();
+        uint64_t iterations = 0;
+        double elapsed = 0;
+        auto began = std::chrono::steady_clock::now();
+        do {
+            vm.run(program);
+            ++iterations;
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - began).count();
+        } while (elapsed < minSeconds);
+        const double seconds = elapsed / static_cast<double>(iterations);
+        std::printf("%-36s %14llu %10.2f %8llu %10.1f\n", path,
+                    static_cast<unsigned long long>(steps), seconds * 1e3,
+                    static_cast<unsigned long long>(iterations),
+                    static_cast<double>(steps) / seconds / 1e6);
+        std::fflush(stdout);
+    }
+    return status;
+}
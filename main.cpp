@@ -1,58 +1,121 @@
-#include "LexGraph.h"
-
-/**
- * @file main.cpp
- * @brief Nhyk compiler's main function for lexical analysis.
- *
- * This source file contains the main function for performing lexical analysis
- * in the Nhyk compiler. It tokenizes the input source code and displays the resulting tokens.
- *
- * @author MNS Ahimbisibwe
- * @SN 217005435
- * @date 2023/09/03
- * @model Lexical Analysis Design
- * @version D01
- */
-
-int main() {
-    // 1. Create a sample source code string
-    std::string sourceCode  = "PROG myProgram: VAR x = 10.5; FUNC add(a, b) { RETURN a + b; } 7pop, \"Mike\" ";
-    std::string sourceCode2 = "PROG lotto: IF num >= 1 AND num <= 6 AND num IS NOT IN userNumbers THEN";
-    std::string sourceCode3 =
-                            "PROG exampleProgram: VAR count = 10, rate = 2.5, name = \"Nhyk\"; "
-                            "FUNC multiply(x, y) { RETURN x * y; } BEGIN FOR i = 1 TO 5 { OUTPUT i; } "
-                            "WHILE count > 0 AND name IS NOT IN [\"John\", \"Doe\"] { count = count - 1; } "
-                            "IF rate > 2 THEN { rate = rate - 0.5; } ELIF rate <= 1 THEN { rate = 1; } ELSE"
-                            "{ rate = rate + 0.5; } END MATCH rate { CASE 1: OUTPUT \"Low\"; CASE 2: OUTPUT"
-                            "\"Medium\"; DEFAULT: OUTPUT \"High\"; } 7pop";
-
-    // 2. Instantiate the lexer with the source code
-    NhykLexer lexer(sourceCode);
-
-    // 3. Tokenize the source code
-    lexer.tokenize();
-    std::string TokenTypeToString(TokenType type);
-
-
-    // 4. Retrieve the tokens and display them
-    const std::vector<Token>& tokens = lexer.getTokens();
-
-    std::cout << tokens;
-    std::ofstream outFile("doc\\Lexar.txt");
-
-    if(outFile.is_open()){
-        outFile << tokens;
-        std::cout << "Output has been saved to 'doc/Lexar.txt'" << std::endl;
-    }else
-        std::cerr << "Error: Unable to open output file 'doc/Lexar.txt'" << std::endl;
-
-    // Optionally, if implemented error handling, display any errors
-    // (assuming getErrors or similar method in lexer)
-    // const std::vector<ErrorToken>& errors = lexer.getErrors();
-    // for (const ErrorToken& error : errors) {
-    //     std::cout << "Error at Line: " << error.line << ", Column: " << error.col << " - " << error.message << std::endl;
-    // }
-
-    return 0;
-}
-
+#include "LexGraph.h"
+#include "NhykSource.h"
+#include "NhykDump.h"
+#include "NhykParser.h"
+#include "NhykOptimizer.h"
+#include "NhykCompiler.h"
+#include "NhykVM.h"
+#include <memory>
+
+/**
+ * @file main.cpp
+ * @brief Nhyk compiler's main function for lexical analysis.
+ *
+ * This source file contains the main function for performing lexical analysis
+ * in the Nhyk compiler. It tokenizes the input source code and displays the resulting tokens.
+ * The first sample ends in "7pop" to show how lexical errors are reported. The
+ * complete program in sourceCode3 is then parsed, optimized, compiled to bytecode and
+ * run. When a file path is given on the command line, that file is used for both.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+int main(int argc, char* argv[]) {
+    // 1. Create a sample source code string
+    std::string sourceCode  = "PROG myProgram: VAR x = 10.5; FUNC add(a, b) { RETURN a + b; } 7pop, \"Mike\" ";
+    std::string sourceCode2 = "PROG lotto: IF num >= 1 AND num <= 6 AND num IS NOT IN userNumbers THEN";
+    std::string sourceCode3 =
+                            "PROG exampleProgram: VAR count = 10, rate = 2.5, name = \"Nhyk\"; "
+                            "FUNC multiply(x, y) { RETURN x * y; } BEGIN FOR i = 1 TO 5 { OUTPUT i; } "
+                            "WHILE count > 0 AND name IS NOT IN [\"John\", \"Doe\"] { count = count - 1; } "
+                            "IF rate > 2 THEN { rate = rate - 0.5; } ELIF rate <= 1 THEN { rate = 1; } ELSE"
+                            "{ rate = rate + 0.5; } MATCH rate { CASE 1: OUTPUT \"Low\"; CASE 2: OUTPUT"
+                            "\"Medium\"; DEFAULT: OUTPUT \"High\"; } OUTPUT count, multiply(rate, 2); END";
+
+    // 2. Instantiate the lexer with the source code, or with the file named on the
+    //    command line, which is mapped into memory and lexed in place
+    std::unique_ptr<NhykMappedFile> sourceFile;
+    if (argc > 1) {
+        try {
+            sourceFile.reset(new NhykMappedFile(argv[1]));
+        } catch (const std::runtime_error& error) {
+            std::cerr << "Error: " << error.what() << std::endl;
+            return 1;
+        }
+    }
+    NhykLexer lexer(sourceCode);
+    if (sourceFile) lexer.setSourceView(sourceFile->view());
+
+    // 3. Tokenize the source code into a struct-of-arrays buffer the parser reads directly
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+    std::string TokenTypeToString(TokenType type);
+
+
+    // 4. Display the tokens; each table is formatted into one buffer and written with one fwrite per flush
+    {
+        NhykTokenWriter writer(stdout);
+        writer.write(tokens);
+    }
+    std::FILE* outFile = std::fopen("doc\\Lexar.txt", "w");
+
+    if(outFile != nullptr){
+        {
+            NhykTokenWriter writer(outFile);
+            writer.write(tokens);
+        }
+        std::fclose(outFile);
+        std::cout << "Output has been saved to 'doc/Lexar.txt'" << std::endl;
+    }else
+        std::cerr << "Error: Unable to open output file 'doc/Lexar.txt'" << std::endl;
+
+    // 5. Display any errors the lexer recorded
+    const std::vector<ErrorToken>& errors = lexer.getErrors();
+    for (const ErrorToken& error : errors) {
+        std::cout << "Error at Line: " << error.line << ", Column: " << error.col << " - " << error.message << std::endl;
+    }
+
+    // 6. Parse a complete program (the file named on the command line, or else
+    //    sourceCode3), display the syntax tree and any syntax errors
+    NhykLexer programLexer(sourceCode3);
+    TokenBuffer programTokens;
+    if (!sourceFile) {
+        programLexer.tokenize(programTokens);
+        for (const ErrorToken& error : programLexer.getErrors()) {
+            std::cout << "Error at Line: " << error.line << ", Column: " << error.col << " - " << error.message << std::endl;
+        }
+    }
+    NhykLexer& source = sourceFile ? lexer : programLexer;
+    const TokenBuffer& program = sourceFile ? tokens : programTokens;
+    NhykParser parser(*source.getSymbolTable());
+    parser.parse(program);
+    parser.getAst().print(std::cout, parser.getNames());
+    for (const ErrorToken& error : parser.getErrors()) {
+        std::cout << "Syntax error at Line: " << error.line << ", Column: " << error.col << " - " << error.message << std::endl;
+    }
+
+    // 7. Optimize and compile a program with no errors to bytecode, and run it
+    if (source.getDiagnostics().empty() && parser.getDiagnostics().empty()) {
+        NhykOptimizer optimizer(parser.getNames());
+        optimizer.optimize(parser.getAst());
+        NhykCompiler compiler(parser.getNames());
+        NhykProgram bytecode;
+        if (compiler.compile(parser.getAst(), program, bytecode)) {
+            NhykVM vm(parser.getNames());
+            vm.run(bytecode);
+            for (const ErrorToken& error : vm.getErrors()) {
+                std::cout << "Runtime error at Line: " << error.line << ", Column: " << error.col << " - " << error.message << std::endl;
+            }
+        }
+        for (const ErrorToken& error : compiler.getErrors()) {
+            std::cout << "Compile error at Line: " << error.line << ", Column: " << error.col << " - " << error.message << std::endl;
+        }
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,142 @@
+#include "../LexGraph.h"
+#include "../NhykIncremental.h"
+#include "../bench/NhykCorpus.h"
+#include <cstring>
+#include <random>
+
+/**
+ * @file nhykincrementaltest.cpp
+ * @brief Checks NhykIncrementalLexer::applyEdit against lexing the edited text afresh.
+ *
+ * Usage: nhykincrementaltest
+ *
+ * Each document gets a sequence of random edits: insertions, deletions and
+ * replacements of a few bytes, drawn from fragments of Nhyk tokens so that edits open
+ * and close strings, split and join identifiers and numbers, and turn operators into
+ * longer ones. After every edit the incremental tokens must match NhykLexer::tokenize
+ * on the new text one for one: kind, offset, text, numeric value and symbol name.
+ * Every edit must also report replaced rows that lie inside the buffer. Halfway through
+ * each document resetSymbols() is called, after which the same must still hold and the
+ * table must hold no more names than a fresh lexer's.
+ *
+ * The documents are generated programs (bench/NhykCorpus.h) and random strings of the
+ * same fragments, from fixed seeds so a failure is reproducible.
+ *
+ * Built by the 'nhykincrementaltest' target of CMakeLists.txt and run by CTest.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+const int EDITS = 40;
+
+const char* const pieces[] = {
+    "PROG", "VAR", "FUNC", "IF", "count", "rate_2", "x", "_", "0", "7", "42", "3.25", "1.5e3",
+    "7pop", "\"", "\"text\"", "\\", " ", "\n", "=", "==", "<", "<=", "!", "!=", "+", "-", ";",
+    "(", ")", "[", "]", "@", "#", "\x01"
+};
+const size_t pieceCount = sizeof pieces / sizeof pieces[0];
+
+std::string randomPieces(std::mt19937_64& random, size_t count) {
+    std::string text;
+    for (size_t i = 0; i < count; ++i) text += pieces[random() % pieceCount];
+    return text;
+}
+
+// Compares the incremental tokens with a fresh lex of the same text; describes the
+// first difference in 'why'.
+bool same(const NhykIncrementalLexer& incremental, std::string& why) {
+    NhykLexer lexer{std::string(incremental.getText())};
+    lexer.tokenize();
+    const std::vector<Token>& expected = lexer.getTokens();
+    const TokenBuffer& tokens = incremental.getTokens();
+    if (tokens.size() != expected.size()) {
+        why = std::to_string(tokens.size()) + " tokens instead of " + std::to_string(expected.size());
+        return false;
+    }
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const Token token = tokens.at(i);
+        const Token& want = expected[i];
+        bool alike = token.getType() == want.getType() && tokens.offset(i) == lexer.offsetOf(want)
+                  && token.getLexeme() == want.getLexeme();
+        if (alike && want.getType() == TokenType::INT_LITERAL) alike = token.getInt() == want.getInt();
+        else if (alike && want.getType() == TokenType::DOUBLE_LITERAL) {
+            const double a = token.getDouble(), b = want.getDouble();
+            alike = std::memcmp(&a, &b, sizeof a) == 0;
+        } else if (alike && want.hasSymbol()) {
+            alike = token.hasSymbol() && incremental.getSymbols().name(token.getSymbol())
+                                             == lexer.getSymbolTable()->name(want.getSymbol());
+        }
+        if (!alike) {
+            why = "token " + std::to_string(i) + " is \"" + std::string(token.getLexeme()) + "\" at "
+                + std::to_string(tokens.offset(i)) + ", expected \"" + std::string(want.getLexeme()) + "\" at "
+                + std::to_string(lexer.offsetOf(want));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool check(std::string document, std::mt19937_64& random, const std::string& name) {
+    NhykIncrementalLexer incremental(document);
+    std::string why;
+    for (int e = 0; e < EDITS; ++e) {
+        const std::string before(incremental.getText());
+        const size_t offset = random() % (before.size() + 1);
+        const size_t removed = std::min<size_t>(random() % 4, before.size() - offset);
+        const std::string inserted = randomPieces(random, random() % 3);
+        const size_t rowsBefore = incremental.getTokens().size();
+
+        const NhykTokenEdit edit = incremental.applyEdit(offset, removed, inserted);
+        bool passed = same(incremental, why);
+        if (passed && (edit.first + edit.removed > rowsBefore || edit.first + edit.inserted > incremental.getTokens().size())) {
+            why = "the edit reports rows outside the buffer";
+            passed = false;
+        }
+        if (passed && e == EDITS / 2) {
+            incremental.resetSymbols();
+            NhykLexer fresh{std::string(incremental.getText())};
+            fresh.tokenize();
+            passed = same(incremental, why);
+            if (passed && incremental.getSymbols().size() > fresh.getSymbolTable()->size()) {
+                why = "resetSymbols() kept " + std::to_string(incremental.getSymbols().size()) + " names, a fresh lexer has "
+                    + std::to_string(fresh.getSymbolTable()->size());
+                passed = false;
+            }
+        }
+        if (!passed) {
+            std::cerr << name << ", edit " << e << " (" << removed << " bytes at " << offset << " replaced by "
+                      << inserted.size() << "): " << why << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    int failed = 0;
+    int documents = 0;
+    std::mt19937_64 random(2023);
+    for (size_t i = 0; i < nhykCorpusMixCount; ++i) {
+        const NhykCorpusMix& mix = nhykCorpusMixes[i];
+        for (uint64_t seed = 1; seed <= 3; ++seed) {
+            ++documents;
+            const std::string name = std::string(mix.name) + " corpus, seed " + std::to_string(seed);
+            if (!check(nhykGenerateCorpus(mix, 1024, seed), random, name)) ++failed;
+        }
+    }
+    for (int i = 0; i < 1000; ++i) {
+        ++documents;
+        if (!check(randomPieces(random, random() % 30), random, "random text " + std::to_string(i))) ++failed;
+    }
+    std::cout << (failed == 0 ? "PASS " : "FAIL ") << documents - failed << " of " << documents
+              << " documents lexed alike after each of " << EDITS << " edits" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
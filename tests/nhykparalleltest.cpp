@@ -0,0 +1,125 @@
+#include "../LexGraph.h"
+#include "../NhykParallel.h"
+#include "../bench/NhykCorpus.h"
+#include <cstring>
+#include <random>
+
+/**
+ * @file nhykparalleltest.cpp
+ * @brief Checks that NhykParallelLexer produces exactly the tokens of NhykLexer.
+ *
+ * Usage: nhykparalleltest
+ *
+ * Each input is lexed by NhykLexer::tokenize and by NhykParallelLexer with 2 to 8
+ * threads and chunks of a few bytes, so that chunk boundaries fall inside identifiers,
+ * numbers, operators and string literals, and speculation in both starting states
+ * (code and string) is stitched many times per input. The tokens must match one for
+ * one: kind, offset, text, numeric value and symbol name.
+ *
+ * The inputs are generated programs with errors mixed in (bench/NhykCorpus.h) and
+ * random strings drawn from fragments of Nhyk tokens, quote-heavy so that a boundary
+ * often falls inside a string, from fixed seeds so a failure is reproducible.
+ *
+ * Built by the 'nhykparalleltest' target of CMakeLists.txt and run by CTest.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+// A token reduced to what must not depend on how the buffer was split.
+struct Lexed {
+    TokenType type;
+    uint64_t offset;
+    std::string text;
+    std::string symbol;
+    int64_t integer;
+    double real;
+
+    bool operator==(const Lexed& other) const {
+        return type == other.type && offset == other.offset && text == other.text && symbol == other.symbol
+            && integer == other.integer && std::memcmp(&real, &other.real, sizeof real) == 0;
+    }
+};
+
+Lexed reduce(const Token& token, std::string_view source, const NhykSymbolTable& symbols) {
+    Lexed lexed{token.getType(), static_cast<uint64_t>(token.getLexeme().data() - source.data()),
+                std::string(token.getLexeme()), std::string(), 0, 0.0};
+    if (token.getType() == TokenType::INT_LITERAL) lexed.integer = token.getInt();
+    else if (token.getType() == TokenType::DOUBLE_LITERAL) lexed.real = token.getDouble();
+    else if (token.hasSymbol()) lexed.symbol = std::string(symbols.name(token.getSymbol()));
+    return lexed;
+}
+
+// Random text built from pieces of tokens, with quotes common enough that chunks often
+// start inside a string literal, and now and then an unterminated one.
+std::string randomText(std::mt19937_64& random) {
+    static const char* const pieces[] = {
+        "PROG", "VAR", "FUNC", "IF", "count", "rate_2", "x", "0", "42", "3.25", "1.5e3",
+        "7pop", "\"", "\"text\"", "\"two words\"", "\"a;b\"", "\"say \\\"hi\\\"\"", "\\",
+        " ", "\n", "=", "==", "<=", "!=", "+", "-", ";", ",", "(", ")", "[", "]", "{", "}",
+        "@", "#", "\x01", "\xff"
+    };
+    const size_t count = sizeof pieces / sizeof pieces[0];
+    std::string text;
+    const size_t length = 20 + random() % 200;
+    for (size_t i = 0; i < length; ++i) text += pieces[random() % count];
+    return text;
+}
+
+std::vector<Lexed> lexSequential(std::string_view source) {
+    NhykLexer lexer{std::string(source)};
+    lexer.tokenize();
+    std::vector<Lexed> tokens;
+    std::string_view copy = lexer.getSource();
+    for (const Token& token : lexer.getTokens()) tokens.push_back(reduce(token, copy, *lexer.getSymbolTable()));
+    return tokens;
+}
+
+bool check(const std::string& source, const std::string& name) {
+    const std::vector<Lexed> expected = lexSequential(source);
+    for (unsigned int threads = 2; threads <= 8; ++threads) {
+        const size_t chunk = std::max<size_t>(1, source.size() / threads / 2);
+        NhykParallelLexer parallel(threads, chunk);
+        std::vector<Lexed> tokens;
+        for (const Token& token : parallel.tokenize(source)) tokens.push_back(reduce(token, source, parallel.getSymbols()));
+        if (tokens == expected) continue;
+        size_t i = 0;
+        while (i < tokens.size() && i < expected.size() && tokens[i] == expected[i]) ++i;
+        std::cerr << name << ", " << threads << " threads: token " << i << " is ";
+        if (i < tokens.size()) std::cerr << '"' << tokens[i].text << "\" at " << tokens[i].offset;
+        else std::cerr << "missing";
+        std::cerr << ", expected ";
+        if (i < expected.size()) std::cerr << '"' << expected[i].text << "\" at " << expected[i].offset;
+        else std::cerr << "nothing";
+        std::cerr << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    int failed = 0;
+    int inputs = 0;
+    for (size_t i = 0; i < nhykCorpusMixCount; ++i) {
+        const NhykCorpusMix& mix = nhykCorpusMixes[i];
+        for (uint64_t seed = 1; seed <= 5; ++seed) {
+            ++inputs;
+            if (!check(nhykGenerateCorpus(mix, 4096, seed), std::string(mix.name) + " corpus, seed " + std::to_string(seed))) ++failed;
+        }
+    }
+    std::mt19937_64 random(2023);
+    for (int i = 0; i < 300; ++i) {
+        ++inputs;
+        if (!check(randomText(random), "random text " + std::to_string(i))) ++failed;
+    }
+    std::cout << (failed == 0 ? "PASS " : "FAIL ") << inputs - failed << " of " << inputs
+              << " inputs lexed alike by NhykParallelLexer and NhykLexer" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
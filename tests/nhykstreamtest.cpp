@@ -0,0 +1,178 @@
+#include "../LexGraph.h"
+#include "../NhykSource.h"
+#include "../bench/NhykCorpus.h"
+#include <cstring>
+#include <random>
+
+/**
+ * @file nhykstreamtest.cpp
+ * @brief Checks that NhykStreamLexer, fed in small chunks, lexes like NhykLexer.
+ *
+ * Usage: nhykstreamtest
+ *
+ * Each input is lexed once as a whole buffer by NhykLexer::tokenize and then by
+ * NhykStreamLexer with every chunk size from 1 to 17 bytes, so identifiers, numbers,
+ * strings and operators are cut at every possible point, many of them across several
+ * chunks. The streamed tokens must match the whole-buffer tokens one for one: kind,
+ * absolute offset, text, numeric value and symbol name. So must the lexical errors:
+ * kind, offset, length, line, column and message, a run of invalid bytes that spans
+ * several chunks being one error.
+ *
+ * The inputs are generated programs with errors mixed in (bench/NhykCorpus.h) and
+ * random strings drawn from fragments of Nhyk tokens and invalid bytes, from fixed
+ * seeds so a failure is reproducible.
+ *
+ * Built by the 'nhykstreamtest' target of CMakeLists.txt and run by CTest.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+const size_t MAX_CHUNK = 17;
+
+// Hands out a string in chunks of a fixed size.
+class ChunkedInput : public NhykInputSource {
+public:
+    ChunkedInput(std::string_view text, size_t chunkSize) : text(text), chunkSize(chunkSize), position(0) {}
+
+    std::string_view nextChunk() override {
+        std::string_view chunk = text.substr(position, chunkSize);
+        position += chunk.size();
+        return chunk;
+    }
+
+private:
+    std::string_view text;
+    size_t chunkSize;
+    size_t position;
+};
+
+// A token reduced to what must not depend on how the input was split.
+struct Lexed {
+    TokenType type;
+    uint64_t offset;
+    std::string text;
+    std::string symbol;
+    int64_t integer;
+    double real;
+
+    bool operator==(const Lexed& other) const {
+        return type == other.type && offset == other.offset && text == other.text && symbol == other.symbol
+            && integer == other.integer && std::memcmp(&real, &other.real, sizeof real) == 0;
+    }
+};
+
+Lexed reduce(const Token& token, uint64_t offset, const NhykSymbolTable& symbols) {
+    Lexed lexed{token.getType(), offset, std::string(token.getLexeme()), std::string(), 0, 0.0};
+    if (token.getType() == TokenType::INT_LITERAL) lexed.integer = token.getInt();
+    else if (token.getType() == TokenType::DOUBLE_LITERAL) lexed.real = token.getDouble();
+    else if (token.hasSymbol()) lexed.symbol = std::string(symbols.name(token.getSymbol()));
+    return lexed;
+}
+
+// Random text built from pieces of tokens, so that long tokens, unterminated strings,
+// malformed numbers and runs of invalid bytes all occur.
+std::string randomText(std::mt19937_64& random) {
+    static const char* const pieces[] = {
+        "PROG", "VAR", "FUNC", "WHILE", "count", "rate_2", "x", "_", "0", "7", "42", "3.25",
+        "1.5e3", "99999999999999999999", "7pop", "\"", "\"text\"", "\"two words", "\\",
+        " ", "  ", "\n", "\t", "=", "==", "<", "<=", ">=", "!=", "+", "-", "*", "/", ";", ",",
+        "(", ")", "[", "]", "{", "}", "@", "#", "$$", "\x01", "\xff", "\x80\x81"
+    };
+    const size_t count = sizeof pieces / sizeof pieces[0];
+    std::string text;
+    const size_t length = random() % 80;
+    for (size_t i = 0; i < length; ++i) text += pieces[random() % count];
+    // Now and then one token long enough to cross many chunks.
+    if (random() % 4 == 0) {
+        const size_t at = random() % (text.size() + 1);
+        text.insert(at, random() % 2 == 0 ? " " + std::string(40, 'q') + " " : " \"" + std::string(40, 's') + "\" ");
+    }
+    return text;
+}
+
+// An error as main.cpp prints it, with its offset and length.
+std::string describe(const ErrorToken& error) {
+    return NhykDiagnosticKindToString(error.kind) + " at " + std::to_string(error.offset) + "+" + std::to_string(error.length)
+         + ", Line: " + std::to_string(error.line) + ", Column: " + std::to_string(error.col) + " - " + error.message;
+}
+
+std::vector<Lexed> lexWhole(const std::string& text, std::vector<std::string>& errors) {
+    NhykLexer lexer(text);
+    lexer.tokenize();
+    std::vector<Lexed> tokens;
+    for (const Token& token : lexer.getTokens()) {
+        tokens.push_back(reduce(token, lexer.offsetOf(token), *lexer.getSymbolTable()));
+    }
+    for (const ErrorToken& error : lexer.getErrors()) errors.push_back(describe(error));
+    return tokens;
+}
+
+std::vector<Lexed> lexChunked(const std::string& text, size_t chunkSize, std::vector<std::string>& errors) {
+    ChunkedInput input(text, chunkSize);
+    NhykStreamLexer lexer(input);
+    std::vector<Lexed> tokens;
+    lexer.tokenize([&](const std::vector<Token>& batch, std::string_view buffer, uint64_t baseOffset) {
+        for (const Token& token : batch) {
+            tokens.push_back(reduce(token, baseOffset + (token.getLexeme().data() - buffer.data()), lexer.getSymbols()));
+        }
+    });
+    for (const ErrorToken& error : lexer.getErrors()) errors.push_back(describe(error));
+    return tokens;
+}
+
+bool check(const std::string& text, const std::string& name) {
+    std::vector<std::string> expectedErrors;
+    const std::vector<Lexed> expected = lexWhole(text, expectedErrors);
+    for (size_t chunkSize = 1; chunkSize <= MAX_CHUNK; ++chunkSize) {
+        std::vector<std::string> errors;
+        const std::vector<Lexed> streamed = lexChunked(text, chunkSize, errors);
+        if (errors != expectedErrors) {
+            size_t i = 0;
+            while (i < errors.size() && i < expectedErrors.size() && errors[i] == expectedErrors[i]) ++i;
+            std::cerr << name << ", chunks of " << chunkSize << " bytes: error " << i << " is "
+                      << (i < errors.size() ? errors[i] : "missing") << ", expected "
+                      << (i < expectedErrors.size() ? expectedErrors[i] : "nothing") << std::endl;
+            return false;
+        }
+        if (streamed == expected) continue;
+        size_t i = 0;
+        while (i < streamed.size() && i < expected.size() && streamed[i] == expected[i]) ++i;
+        std::cerr << name << ", chunks of " << chunkSize << " bytes: token " << i << " is ";
+        if (i < streamed.size()) std::cerr << '"' << streamed[i].text << "\" at " << streamed[i].offset;
+        else std::cerr << "missing";
+        std::cerr << ", expected ";
+        if (i < expected.size()) std::cerr << '"' << expected[i].text << "\" at " << expected[i].offset;
+        else std::cerr << "nothing";
+        std::cerr << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    int failed = 0;
+    int inputs = 0;
+    for (size_t i = 0; i < nhykCorpusMixCount; ++i) {
+        const NhykCorpusMix& mix = nhykCorpusMixes[i];
+        for (uint64_t seed = 1; seed <= 3; ++seed) {
+            ++inputs;
+            if (!check(nhykGenerateCorpus(mix, 2048, seed), std::string(mix.name) + " corpus, seed " + std::to_string(seed))) ++failed;
+        }
+    }
+    std::mt19937_64 random(2023);
+    for (int i = 0; i < 500; ++i) {
+        ++inputs;
+        if (!check(randomText(random), "random text " + std::to_string(i))) ++failed;
+    }
+    std::cout << (failed == 0 ? "PASS " : "FAIL ") << inputs - failed << " of " << inputs
+              << " inputs lexed alike in chunks of 1 to " << MAX_CHUNK << " bytes" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+#include "../LexGraph.h"
+#include "../NhykCompiler.h"
+#include "../NhykOptimizer.h"
+#include "../NhykParser.h"
+#include "../NhykVM.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @file nhyktest.cpp
+ * @brief Runs Nhyk test programs and compares what they print with the expected output.
+ *
+ * Usage: nhyktest program.nhyk...
+ *
+ * Each program is lexed, parsed, compiled and run twice: once as written and once after
+ * NhykOptimizer. Both runs must print exactly the contents of the program's .out file
+ * (the same path with ".out" in place of ".nhyk"); when a .in file sits beside it, it is
+ * the program's input. Errors are printed after the output in the form main.cpp uses,
+ * so a .out file also fixes the lexical, syntax, compile and runtime errors a program
+ * must report and where. The optimized run must not execute more instructions than
+ * the plain one.
+ *
+ * Built by the 'nhyktest' target of CMakeLists.txt, which registers every program in
+ * tests/ with CTest.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+bool readFile(const std::string& path, std::string& text) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    text = contents.str();
+    return true;
+}
+
+void printErrors(std::ostream& out, const char* what, const std::vector<ErrorToken>& errors) {
+    for (const ErrorToken& error : errors) {
+        out << what << " at Line: " << error.line << ", Column: " << error.col << " - " << error.message << '\n';
+    }
+}
+
+// Everything one run printed, and the instructions it executed.
+struct Run {
+    std::string output;
+    uint64_t steps = 0;
+};
+
+Run runProgram(const std::string& sourceCode, const std::string& input, bool optimize) {
+    std::ostringstream out;
+    std::istringstream in(input);
+    Run run;
+
+    NhykLexer lexer(sourceCode);
+    TokenBuffer tokens;
+    lexer.tokenize(tokens);
+    printErrors(out, "Error", lexer.getErrors());
+    NhykParser parser(*lexer.getSymbolTable());
+    parser.parse(tokens);
+    printErrors(out, "Syntax error", parser.getErrors());
+    if (lexer.getDiagnostics().empty() && parser.getDiagnostics().empty()) {
+        if (optimize) {
+            NhykOptimizer optimizer(parser.getNames());
+            optimizer.optimize(parser.getAst());
+        }
+        NhykCompiler compiler(parser.getNames());
+        NhykProgram program;
+        if (compiler.compile(parser.getAst(), tokens, program)) {
+            NhykVM vm(parser.getNames());
+            vm.setOutput(out);
+            vm.setInput(in);
+            vm.run(program);
+            run.steps = vm.getSteps();
+            printErrors(out, "Runtime error", vm.getErrors());
+        }
+        printErrors(out, "Compile error", compiler.getErrors());
+    }
+    run.output = out.str();
+    return run;
+}
+
+// Drops the carriage returns a checkout may have added to an expected output file.
+std::string withoutCarriageReturns(std::string text) {
+    text.erase(std::remove(text.begin(), text.end(), '\r'), text.end());
+    return text;
+}
+
+bool check(const std::string& path) {
+    std::string base = path;
+    if (base.size() > 5 && base.compare(base.size() - 5, 5, ".nhyk") == 0) base.resize(base.size() - 5);
+    std::string sourceCode, expected, input;
+    if (!readFile(path, sourceCode)) {
+        std::cerr << path << ": cannot read the program" << std::endl;
+        return false;
+    }
+    if (!readFile(base + ".out", expected)) {
+        std::cerr << path << ": cannot read " << base << ".out" << std::endl;
+        return false;
+    }
+    expected = withoutCarriageReturns(expected);
+    readFile(base + ".in", input);
+
+    bool passed = true;
+    Run plain = runProgram(sourceCode, input, false);
+    Run optimized = runProgram(sourceCode, input, true);
+    const Run* runs[] = {&plain, &optimized};
+    for (const Run* run : runs) {
+        if (run->output == expected) continue;
+        std::cerr << path << ": the " << (run == &plain ? "unoptimized" : "optimized")
+                  << " run printed\n" << run->output << "-- instead of --\n" << expected << "--" << std::endl;
+        passed = false;
+    }
+    if (optimized.steps > plain.steps) {
+        std::cerr << path << ": the optimized run took " << optimized.steps << " steps, the unoptimized "
+                  << plain.steps << std::endl;
+        passed = false;
+    }
+    std::cout << (passed ? "PASS " : "FAIL ") << path << std::endl;
+    return passed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: nhyktest program.nhyk..." << std::endl;
+        return 2;
+    }
+    int failed = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!check(argv[i])) ++failed;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "../NhykBatch.h"
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+
+/**
+ * @file nhykbatch.cpp
+ * @brief Command-line driver for batch lexing many Nhyk files at once.
+ *
+ * Usage: nhykbatch [-j threads] [-e extension] [-t] [-v] (file | directory | @listfile)...
+ *
+ *   -j N   number of worker threads (default: one per core)
+ *   -e X   extension of the files picked up from directories (default: .nhyk; "" for all)
+ *   -t     print each file's token table to standard output
+ *   -v     print one summary line per file
+ *
+ * A directory is searched recursively; @listfile names a file holding one path per line.
+ * Aggregate statistics are printed to standard error when the batch is done.
+ *
+ * Built by the 'nhykbatch' target of CMakeLists.txt.
+ *
+ * @author MNS Ahimbisibwe
+ * @SN 217005435
+ * @date 2023/09/03
+ * @model Lexical Analysis Design
+ * @version D01
+ */
+
+namespace {
+
+void usage() {
+    std::cerr << "Usage: nhykbatch [-j threads] [-e extension] [-t] [-v] (file | directory | @listfile)..." << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    unsigned int threads = 0;
+    std::string extension = ".nhyk";
+    bool printTokens = false;
+    bool verbose = false;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            extension = argv[++i];
+        } else if (std::strcmp(argv[i], "-t") == 0) {
+            printTokens = true;
+        } else if (std::strcmp(argv[i], "-v") == 0) {
+            verbose = true;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage();
+            return 2;
+        } else {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
+        usage();
+        return 2;
+    }
+
+    NhykBatchLexer batch(threads);
+    for (const std::string& input : inputs) {
+        try {
+            if (input[0] == '@') {
+                std::ifstream list(input.substr(1));
+                if (!list.is_open()) {
+                    std::cerr << "Error: Unable to open file list '" << input.substr(1) << "'" << std::endl;
+                    return 1;
+                }
+                std::string line;
+                while (std::getline(list, line))
+                    if (!line.empty()) batch.addFile(line);
+            } else if (std::filesystem::is_directory(input)) {
+                batch.addDirectory(input, extension);
+            } else {
+                batch.addFile(input);
+            }
+        } catch (const std::exception& error) {
+            std::cerr << "Error: " << error.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Sinks run on worker threads; keep each file's output in one piece.
+    std::mutex outputLock;
+    NhykBatchStats stats = batch.run([&](const NhykFileResult& result, const std::vector<Token>& tokens) {
+        if (!result.ok) {
+            std::lock_guard<std::mutex> guard(outputLock);
+            std::cerr << "Error: " << result.error << std::endl;
+            return;
+        }
+        if (!verbose && !printTokens) return;
+        std::lock_guard<std::mutex> guard(outputLock);
+        if (verbose)
+            std::cout << result.path << ": " << result.tokens << " tokens, " << result.bytes << " bytes, "
+                      << result.errors << " errors\n";
+        if (printTokens)
+            std::cout << "== " << result.path << tokens << "\n";
+    });
+
+    double megabytes = static_cast<double>(stats.bytes) / (1024.0 * 1024.0);
+    std::cerr << "Files: " << stats.files << " (" << stats.failedFiles << " failed)\n"
+              << "Bytes: " << stats.bytes << "\n"
+              << "Tokens: " << stats.tokens << "\n"
+              << "Errors: " << stats.errors << "\n";
+    for (int t = 0; t < static_cast<int>(TokenType::END_OF_INPUT); ++t)
+        if (stats.tokensByType[t] != 0)
+            std::cerr << "  " << std::left << std::setw(16) << TokenTypeToString(static_cast<TokenType>(t))
+                      << stats.tokensByType[t] << "\n";
+    std::cerr << std::fixed << std::setprecision(3)
+              << "Time: " << stats.seconds << " s, "
+              << (stats.seconds > 0 ? megabytes / stats.seconds : 0.0) << " MiB/s on "
+              << batch.getFiles().size() << " files" << std::endl;
+    return stats.failedFiles == 0 ? 0 : 1;
+}